@@ -0,0 +1,16 @@
+@echo off
+setlocal EnableDelayedExpansion
+echo Benchmark discovery started...
+dir C:\projects\native-algorithms\src\%PLATFORM%\%CONFIGURATION%\*Benchmarks.exe /b /s | findstr /v obj > __tmp_benchmark.txt
+
+echo Benchmarking (Google Benchmark)...
+
+set failures=0
+
+FOR /F %%i IN (__tmp_benchmark.txt) DO (
+	echo %%i
+	%%i --benchmark_out="%%i.json" --benchmark_out_format=json %* || set /A failures=failures+1
+)
+del __tmp_benchmark.txt
+
+EXIT /B %failures%
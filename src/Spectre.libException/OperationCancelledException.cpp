@@ -0,0 +1,26 @@
+/*
+* OperationCancelledException.cpp
+* Thrown when an operation was cancelled before it completed.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "OperationCancelledException.h"
+
+namespace spectre::core::exception
+{
+OperationCancelledException::OperationCancelledException(const std::string &description):
+    ExceptionBase(description) { }
+}
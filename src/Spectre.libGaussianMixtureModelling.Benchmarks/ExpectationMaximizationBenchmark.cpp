@@ -0,0 +1,308 @@
+/*
+* ExpectationMaximizationBenchmark.cpp
+* Compares throughput of reference and optimized runners of
+* Gaussian Mixture Modelling Expectation Maximization algorithm.
+* Throughput is reported as points times components per second,
+* along with peak heap usage. Run with --benchmark_out=<file>
+* --benchmark_out_format=json to compare results across commits.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <benchmark/benchmark.h>
+#include "ExpectationMaximization.h"
+#include "ExpectationRunnerLog.h"
+#include "ExpectationRunnerOpt.h"
+#include "ExpectationRunnerRef.h"
+#include "FeatureProjection.h"
+#include "FusedExpectationMaximization.h"
+#include "KMeansPlusPlusInitialization.h"
+#include "LogLikelihoodCalculator.h"
+#include "LogLikelihoodCalculatorLog.h"
+#include "LogLikelihoodCalculatorOpt.h"
+#include "MaximizationRunnerOpt.h"
+#include "MaximizationRunnerRef.h"
+#include "MemoryTracking.h"
+#include "RandomInitializationRef.h"
+#include "SparseIterationRunner.h"
+#include "SpecializedIterationRunner.h"
+#include "StreamingIterationRunner.h"
+#include "SyntheticSpectrum.h"
+
+namespace
+{
+using namespace spectre::unsupervised::gmm;
+
+// Spectrum of evenly spaced peaks of equal width, spanning m/z range [0, 1000).
+// Benchmark arguments are number of points and number of components, optionally
+// followed by width of the peaks and deviation of the noise, both in percents.
+SyntheticSpectrum Spectrum(const benchmark::State &state, bool shaped = false)
+{
+    SyntheticSpectrumShape shape;
+    shape.size = (unsigned)state.range(0);
+    shape.numberOfComponents = (unsigned)state.range(1);
+    if (shaped)
+    {
+        shape.peakWidth = state.range(2) / 100.0;
+        shape.noise = state.range(3) / 100.0;
+    }
+    return SyntheticSpectrum(shape);
+}
+
+// Reports peak heap usage and throughput in points times components per second.
+void Report(benchmark::State &state, const PeakMemory &memory, size_t passesOverData)
+{
+    state.SetItemsProcessed(passesOverData * state.range(0) * state.range(1));
+    state.counters["peak_bytes"] = (double)memory.Bytes();
+}
+
+template <typename InitializationRunner>
+void BM_Initialization(benchmark::State &state)
+{
+    SyntheticSpectrum spectrum = Spectrum(state);
+    const unsigned size = (unsigned)spectrum.mzs.size();
+    PeakMemory memory;
+    RandomNumberGenerator rngEngine(0);
+    InitializationRunner runner(spectrum.mzs.data(), spectrum.intensities.data(), size, spectrum.components, rngEngine);
+    while (state.KeepRunning())
+    {
+        runner.AssignRandomMeans();
+        runner.AssignVariances();
+        runner.AssignWeights();
+        benchmark::DoNotOptimize(spectrum.components.data());
+    }
+    Report(state, memory, state.iterations());
+}
+
+template <typename ExpectationRunner, MatrixLayout Layout = ExpectationRunner::AFFILATION_LAYOUT>
+void BM_Expectation(benchmark::State &state)
+{
+    SyntheticSpectrum spectrum = Spectrum(state);
+    const unsigned size = (unsigned)spectrum.mzs.size();
+    PeakMemory memory;
+    Matrix affilationMatrix((unsigned)spectrum.components.size(), size, Layout);
+    ExpectationRunner runner(spectrum.mzs.data(), size, affilationMatrix, spectrum.components);
+    while (state.KeepRunning())
+    {
+        runner.Expectation();
+        benchmark::DoNotOptimize(affilationMatrix(0, 0));
+    }
+    Report(state, memory, state.iterations());
+}
+
+template <typename MaximizationRunner, MatrixLayout Layout = MaximizationRunner::AFFILATION_LAYOUT>
+void BM_Maximization(benchmark::State &state)
+{
+    SyntheticSpectrum spectrum = Spectrum(state);
+    const unsigned size = (unsigned)spectrum.mzs.size();
+    const unsigned numberOfComponents = (unsigned)spectrum.components.size();
+    Matrix affilationMatrix(numberOfComponents, size, Layout);
+    ExpectationRunnerOpt(spectrum.mzs.data(), size, affilationMatrix, spectrum.components).Expectation();
+    const std::vector<GaussianComponent> initial = spectrum.components;
+    PeakMemory memory;
+    MaximizationRunner runner(spectrum.mzs.data(), spectrum.intensities.data(), size,
+                              affilationMatrix, spectrum.components);
+    while (state.KeepRunning())
+    {
+        spectrum.components = initial;
+        runner.UpdateWeights();
+        runner.UpdateMeans();
+        runner.UpdateStdDeviations();
+        benchmark::DoNotOptimize(spectrum.components.data());
+    }
+    Report(state, memory, state.iterations());
+}
+
+template <typename LogLikelihoodCalculatorType>
+void BM_LogLikelihood(benchmark::State &state)
+{
+    SyntheticSpectrum spectrum = Spectrum(state);
+    const unsigned size = (unsigned)spectrum.mzs.size();
+    PeakMemory memory;
+    LogLikelihoodCalculatorType calculator(spectrum.mzs.data(), spectrum.intensities.data(), size, spectrum.components);
+    while (state.KeepRunning())
+    {
+        benchmark::DoNotOptimize(calculator.CalculateLikelihood());
+    }
+    Report(state, memory, state.iterations());
+}
+
+template <typename IterationRunner, bool Shaped = false>
+void BM_Iteration(benchmark::State &state)
+{
+    SyntheticSpectrum spectrum = Spectrum(state, Shaped);
+    const unsigned size = (unsigned)spectrum.mzs.size();
+    const std::vector<GaussianComponent> initial = spectrum.components;
+    PeakMemory memory;
+    IterationRunner runner(spectrum.mzs.data(), spectrum.intensities.data(), size, spectrum.components);
+    while (state.KeepRunning())
+    {
+        spectrum.components = initial;
+        benchmark::DoNotOptimize(runner.Iterate());
+    }
+    Report(state, memory, state.iterations());
+}
+
+// Runs the whole algorithm, reporting throughput of its iterations. Number of iterations
+// is limited, as overlapping peaks make the algorithm converge in tens of thousands of them.
+template <typename Algorithm>
+void EstimateGmm(benchmark::State &state)
+{
+    SyntheticSpectrum spectrum = Spectrum(state, true);
+    const unsigned size = (unsigned)spectrum.mzs.size();
+    ConvergenceCriteria criteria;
+    criteria.maxIterations = 1000;
+    size_t iterations = 0;
+    PeakMemory memory;
+    while (state.KeepRunning())
+    {
+        RandomNumberGenerator rngEngine(0);
+        Algorithm em(spectrum.mzs.data(), spectrum.intensities.data(), size, rngEngine, (unsigned)state.range(1));
+        em.SetConvergenceCriteria(criteria);
+        benchmark::DoNotOptimize(em.EstimateGmm());
+        iterations += em.GetConvergenceReport().iterations;
+    }
+    Report(state, memory, iterations);
+    state.counters["iterations"] = (double)iterations / state.iterations();
+}
+
+template <typename ExpectationRunner, typename MaximizationRunner, typename LogLikelihoodCalculatorType>
+void BM_EstimateGmm(benchmark::State &state)
+{
+    EstimateGmm<ExpectationMaximization<RandomInitializationRef, ExpectationRunner, MaximizationRunner,
+                                        LogLikelihoodCalculatorType>>(state);
+}
+
+template <typename IterationRunner>
+void BM_EstimateGmmFused(benchmark::State &state)
+{
+    EstimateGmm<FusedExpectationMaximization<RandomInitializationRef, IterationRunner>>(state);
+}
+
+// Log likelihood calculator counting its calls, i.e. iterations of the algorithm.
+class CountingLogLikelihoodCalculator : public LogLikelihoodCalculatorOpt
+{
+public:
+    using LogLikelihoodCalculatorOpt::LogLikelihoodCalculatorOpt;
+
+    DataType CalculateLikelihood()
+    {
+        calls++;
+        return LogLikelihoodCalculatorOpt::CalculateLikelihood();
+    }
+
+    static unsigned calls;
+};
+
+unsigned CountingLogLikelihoodCalculator::calls = 0;
+
+template <typename InitializationRunner>
+void BM_EstimateGmmInitialized(benchmark::State &state)
+{
+    SyntheticSpectrum spectrum = Spectrum(state);
+    const unsigned size = (unsigned)spectrum.mzs.size();
+    CountingLogLikelihoodCalculator::calls = 0;
+    unsigned runs = 0;
+    while (state.KeepRunning())
+    {
+        // different initializations across runs, but the same across initialization runners
+        RandomNumberGenerator rngEngine(runs++);
+        ExpectationMaximization<InitializationRunner, ExpectationRunnerOpt, MaximizationRunnerOpt, CountingLogLikelihoodCalculator>
+            em(spectrum.mzs.data(), spectrum.intensities.data(), size, rngEngine, (unsigned)state.range(1));
+        benchmark::DoNotOptimize(em.EstimateGmm());
+    }
+    state.counters["iterations"] = (double)CountingLogLikelihoodCalculator::calls / runs;
+}
+
+void BM_Projection(benchmark::State &state)
+{
+    SyntheticSpectrum spectrum = Spectrum(state);
+    const unsigned size = (unsigned)spectrum.mzs.size();
+    const unsigned numberOfSpectra = 256;
+    std::vector<DataType> spectra((size_t)numberOfSpectra * size);
+    for (unsigned s = 0; s < numberOfSpectra; s++)
+    {
+        std::copy(spectrum.intensities.begin(), spectrum.intensities.end(), spectra.begin() + (size_t)s * size);
+    }
+    FeatureProjection projection(spectrum.mzs.data(), size, spectrum.components);
+    std::vector<DataType> features((size_t)numberOfSpectra * spectrum.components.size());
+    while (state.KeepRunning())
+    {
+        projection.Project(spectra.data(), numberOfSpectra, features.data());
+        benchmark::DoNotOptimize(features[0]);
+    }
+    state.SetItemsProcessed(state.iterations() * numberOfSpectra);
+}
+
+void PhaseSizes(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->Args({ 1 << 14, 8 })->Args({ 1 << 14, 64 })->Args({ 1 << 17, 8 })->Args({ 1 << 17, 64 });
+}
+
+// Narrow and wide peaks, without and with noise of 10% of mean intensity.
+void SpectrumShapes(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->Args({ 1 << 12, 8, 17, 0 })->Args({ 1 << 12, 8, 40, 0 })->Args({ 1 << 12, 8, 17, 10 });
+}
+
+// Peaks narrow enough to leave most of the points out of support of all the components.
+void GappedShapes(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->Args({ 1 << 17, 200, 1, 0 });
+}
+
+// Number of components of the specializations has to match the one fixed at compile time.
+template <unsigned NumberOfComponents>
+void SpecializedSizes(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->Args({ 1 << 14, NumberOfComponents })->Args({ 1 << 17, NumberOfComponents });
+}
+}
+
+BENCHMARK_TEMPLATE(BM_Initialization, RandomInitializationRef)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_Initialization, KMeansPlusPlusInitialization)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_Expectation, ExpectationRunnerRef)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_Expectation, ExpectationRunnerOpt)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_Expectation, ExpectationRunnerLog)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_Expectation, ExpectationRunnerOpt, MatrixLayout::ColumnMajor)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_Maximization, MaximizationRunnerRef)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_Maximization, MaximizationRunnerOpt)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_Maximization, MaximizationRunnerOpt, MatrixLayout::ColumnMajor)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_LogLikelihood, LogLikelihoodCalculator)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_LogLikelihood, LogLikelihoodCalculatorOpt)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_LogLikelihood, LogLikelihoodCalculatorLog)->Apply(PhaseSizes);
+BENCHMARK_TEMPLATE(BM_Iteration, FusedIterationRunner)->Apply(PhaseSizes)->Args({ 1 << 17, 512 });
+BENCHMARK_TEMPLATE(BM_Iteration, StreamingIterationRunner)->Apply(PhaseSizes)->Args({ 1 << 17, 512 });
+BENCHMARK_TEMPLATE(BM_Iteration, SparseIterationRunner)->Apply(PhaseSizes)->Args({ 1 << 17, 512 });
+BENCHMARK_TEMPLATE(BM_Iteration, FusedIterationRunner, true)->Apply(GappedShapes);
+BENCHMARK_TEMPLATE(BM_Iteration, SparseIterationRunner, true)->Apply(GappedShapes);
+BENCHMARK_TEMPLATE(BM_Iteration, FusedIterationRunner)->Apply(SpecializedSizes<4>)->Apply(SpecializedSizes<16>);
+BENCHMARK_TEMPLATE(BM_Iteration, SpecializedIterationRunner<double>)->Apply(SpecializedSizes<4>)->Apply(SpecializedSizes<16>);
+BENCHMARK_TEMPLATE(BM_Iteration, SpecializedIterationRunner<float>)->Apply(SpecializedSizes<4>)->Apply(SpecializedSizes<16>);
+BENCHMARK_TEMPLATE(BM_Iteration, SpecializedIterationRunner<double, 4>)->Apply(SpecializedSizes<4>);
+BENCHMARK_TEMPLATE(BM_Iteration, SpecializedIterationRunner<float, 4>)->Apply(SpecializedSizes<4>);
+BENCHMARK_TEMPLATE(BM_Iteration, SpecializedIterationRunner<double, 16>)->Apply(SpecializedSizes<16>);
+BENCHMARK_TEMPLATE(BM_Iteration, SpecializedIterationRunner<float, 16>)->Apply(SpecializedSizes<16>);
+BENCHMARK_TEMPLATE(BM_EstimateGmm, ExpectationRunnerRef, MaximizationRunnerRef, LogLikelihoodCalculator)
+    ->Apply(SpectrumShapes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EstimateGmm, ExpectationRunnerOpt, MaximizationRunnerOpt, LogLikelihoodCalculatorOpt)
+    ->Apply(SpectrumShapes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EstimateGmmInitialized, RandomInitializationRef)
+    ->Args({ 1 << 12, 8 })->Args({ 1 << 12, 32 })->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EstimateGmmInitialized, KMeansPlusPlusInitialization)
+    ->Args({ 1 << 12, 8 })->Args({ 1 << 12, 32 })->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EstimateGmmFused, FusedIterationRunner)->Apply(SpectrumShapes)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EstimateGmmFused, StreamingIterationRunner)->Apply(SpectrumShapes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Projection)->Args({ 1 << 14, 64 })->Args({ 1 << 17, 512 })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,76 @@
+/*
+* MemoryTracking.cpp
+* Provides measurement of peak heap usage of the benchmarked code.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "MemoryTracking.h"
+
+namespace
+{
+// Each block is prefixed with its size, as unsized delete does not provide it.
+std::atomic<size_t> currentBytes(0);
+std::atomic<size_t> peakBytes(0);
+constexpr size_t HEADER_SIZE = alignof(std::max_align_t) > sizeof(size_t) ? alignof(std::max_align_t) : sizeof(size_t);
+
+void* TrackedAllocate(size_t size)
+{
+    char *block = static_cast<char*>(std::malloc(size + HEADER_SIZE));
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    const size_t current = currentBytes += size;
+    size_t peak = peakBytes.load();
+    while (current > peak && !peakBytes.compare_exchange_weak(peak, current)) { }
+    return block + HEADER_SIZE;
+}
+
+void TrackedDeallocate(void *pointer)
+{
+    if (pointer == nullptr)
+    {
+        return;
+    }
+    char *block = static_cast<char*>(pointer) - HEADER_SIZE;
+    currentBytes -= *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+}
+
+void* operator new(size_t size) { return TrackedAllocate(size); }
+void* operator new[](size_t size) { return TrackedAllocate(size); }
+void operator delete(void *pointer) noexcept { TrackedDeallocate(pointer); }
+void operator delete[](void *pointer) noexcept { TrackedDeallocate(pointer); }
+void operator delete(void *pointer, size_t) noexcept { TrackedDeallocate(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { TrackedDeallocate(pointer); }
+
+namespace spectre::unsupervised::gmm
+{
+PeakMemory::PeakMemory() : m_Baseline(currentBytes.load())
+{
+    peakBytes = m_Baseline;
+}
+
+size_t PeakMemory::Bytes() const
+{
+    return peakBytes.load() - m_Baseline;
+}
+}
@@ -0,0 +1,48 @@
+/*
+* MemoryTracking.h
+* Provides measurement of peak heap usage of the benchmarked code.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <cstddef>
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Measures peak number of bytes allocated with global operator new, on top
+/// of the ones already allocated when the measurement started. Global
+/// allocation functions of the whole benchmark executable are replaced
+/// to make it possible, so only one measurement may be in progress.
+/// </summary>
+class PeakMemory
+{
+public:
+    /// <summary>
+    /// Starts the measurement.
+    /// </summary>
+    PeakMemory();
+
+    /// <summary>
+    /// Gets peak number of bytes allocated since the measurement started.
+    /// </summary>
+    /// <returns>Peak number of bytes.</returns>
+    size_t Bytes() const;
+
+private:
+    size_t m_Baseline;
+};
+}
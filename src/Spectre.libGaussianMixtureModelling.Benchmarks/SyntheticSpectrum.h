@@ -0,0 +1,124 @@
+/*
+* SyntheticSpectrum.h
+* Provides generator of spectra drawn from known Gaussian mixtures,
+* used as input of the benchmarks.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <math.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "DataType.h"
+#include "GaussianDistribution.h"
+#include "GaussianMixtureModel.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Default deviation of the synthetic peaks, relative to distance between them.
+/// </summary>
+constexpr double DEFAULT_SYNTHETIC_PEAK_WIDTH = 1.0 / 6.0;
+
+/// <summary>
+/// Parameters of a synthetic spectrum.
+/// </summary>
+struct SyntheticSpectrumShape
+{
+    /// <summary>
+    /// Number of m/z values, evenly spread over [0, 1000).
+    /// </summary>
+    unsigned size;
+
+    /// <summary>
+    /// Number of evenly spaced peaks of equal weight.
+    /// </summary>
+    unsigned numberOfComponents;
+
+    /// <summary>
+    /// Deviation of the peaks, relative to distance between them.
+    /// </summary>
+    double peakWidth = DEFAULT_SYNTHETIC_PEAK_WIDTH;
+
+    /// <summary>
+    /// Deviation of additive noise, relative to the mean intensity.
+    /// Intensities are clipped to the baseline of the spectrum, so that none is zero.
+    /// </summary>
+    double noise = 0.0;
+
+    /// <summary>
+    /// Seed of the noise.
+    /// </summary>
+    uint64_t seed = 0;
+};
+
+/// <summary>
+/// Spectrum drawn from a known Gaussian mixture. The same shape always
+/// yields the same spectrum, so results are comparable across commits.
+/// </summary>
+struct SyntheticSpectrum
+{
+    /// <summary>
+    /// Constructor generating the spectrum.
+    /// </summary>
+    /// <param name="shape">Parameters of the spectrum.</param>
+    explicit SyntheticSpectrum(const SyntheticSpectrumShape &shape)
+        : mzs(shape.size), intensities(shape.size), components(shape.numberOfComponents)
+    {
+        const double spacing = 1000.0 / shape.numberOfComponents;
+        for (unsigned k = 0; k < shape.numberOfComponents; k++)
+        {
+            components[k] = { /*mean =*/ spacing * (k + 0.5), /*deviation =*/ spacing * shape.peakWidth,
+                              /*weight =*/ 1.0 / shape.numberOfComponents };
+        }
+
+        const double baseline = 1e-6;
+        // mixture density integrates to 1 over the range, so its mean is 1 / 1000
+        const double noiseDeviation = shape.noise > 0.0 ? shape.noise / 1000.0 : 1.0;
+        std::mt19937_64 rngEngine(shape.seed);
+        std::normal_distribution<double> noise(0.0, noiseDeviation);
+        for (unsigned i = 0; i < shape.size; i++)
+        {
+            mzs[i] = 1000.0 * i / shape.size;
+            intensities[i] = baseline;
+            for (const auto &component : components)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+            if (shape.noise > 0.0)
+            {
+                intensities[i] = fmax(intensities[i] + noise(rngEngine), baseline);
+            }
+        }
+    }
+
+    /// <summary>
+    /// M/z values, in ascending order.
+    /// </summary>
+    std::vector<DataType> mzs;
+
+    /// <summary>
+    /// Intensities at the m/z values.
+    /// </summary>
+    std::vector<DataType> intensities;
+
+    /// <summary>
+    /// Components of the mixture the spectrum was drawn from.
+    /// </summary>
+    std::vector<GaussianComponent> components;
+};
+}
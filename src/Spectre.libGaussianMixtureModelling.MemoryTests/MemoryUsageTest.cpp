@@ -0,0 +1,295 @@
+/*
+* MemoryUsageTest.cpp
+* Provides implementation of tests checking peak heap usage
+* of Expectation Maximization algorithm runners.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <gtest/gtest.h>
+#include "ExpectationMaximization.h"
+#include "ExpectationRunnerLog.h"
+#include "ExpectationRunnerRef.h"
+#include "LogLikelihoodCalculator.h"
+#include "LogLikelihoodCalculatorLog.h"
+#include "MaximizationRunnerRef.h"
+#include "OnlineExpectationMaximization.h"
+#include "RandomInitializationRef.h"
+#include "StreamingIterationRunner.h"
+#include "WeightedLogLikelihoodCalculator.h"
+
+namespace
+{
+// Global allocation functions are replaced for the whole test executable,
+// so that heap usage of the code under test can be observed. That is why
+// these tests are built separately from the rest of the library tests.
+// Each block is prefixed with its size, as unsized delete does not provide it.
+std::atomic<size_t> currentBytes(0);
+std::atomic<size_t> peakBytes(0);
+constexpr size_t HEADER_SIZE = alignof(std::max_align_t) > sizeof(size_t) ? alignof(std::max_align_t) : sizeof(size_t);
+
+void* TryTrackedAllocate(size_t size) noexcept
+{
+    char *block = static_cast<char*>(std::malloc(size + HEADER_SIZE));
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    const size_t current = currentBytes += size;
+    size_t peak = peakBytes.load();
+    while (current > peak && !peakBytes.compare_exchange_weak(peak, current)) { }
+    return block + HEADER_SIZE;
+}
+
+void* TrackedAllocate(size_t size)
+{
+    void *pointer = TryTrackedAllocate(size);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void TrackedDeallocate(void *pointer)
+{
+    if (pointer == nullptr)
+    {
+        return;
+    }
+    char *block = static_cast<char*>(pointer) - HEADER_SIZE;
+    currentBytes -= *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+
+#ifdef __cpp_aligned_new
+// Over-aligned blocks are preceded by their size and address of the underlying block.
+void* TryTrackedAllocateAligned(size_t size, std::align_val_t alignment) noexcept
+{
+    const size_t align = std::max(static_cast<size_t>(alignment), alignof(std::max_align_t));
+    char *block = static_cast<char*>(std::malloc(size + align + 2 * sizeof(size_t)));
+    if (block == nullptr)
+    {
+        return nullptr;
+    }
+    const uintptr_t first = reinterpret_cast<uintptr_t>(block) + 2 * sizeof(size_t);
+    char *aligned = reinterpret_cast<char*>((first + align - 1) / align * align);
+    reinterpret_cast<size_t*>(aligned)[-1] = size;
+    reinterpret_cast<char**>(aligned)[-2] = block;
+    const size_t current = currentBytes += size;
+    size_t peak = peakBytes.load();
+    while (current > peak && !peakBytes.compare_exchange_weak(peak, current)) { }
+    return aligned;
+}
+
+void* TrackedAllocateAligned(size_t size, std::align_val_t alignment)
+{
+    void *pointer = TryTrackedAllocateAligned(size, alignment);
+    if (pointer == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void TrackedDeallocateAligned(void *pointer)
+{
+    if (pointer == nullptr)
+    {
+        return;
+    }
+    currentBytes -= reinterpret_cast<size_t*>(pointer)[-1];
+    std::free(reinterpret_cast<char**>(pointer)[-2]);
+}
+#endif
+
+// Returns peak number of bytes allocated on top of those already allocated, while action runs.
+template <typename Action>
+size_t MeasurePeakUsage(Action action)
+{
+    const size_t baseline = currentBytes.load();
+    peakBytes = baseline;
+    action();
+    return peakBytes.load() - baseline;
+}
+}
+
+void* operator new(size_t size) { return TrackedAllocate(size); }
+void* operator new[](size_t size) { return TrackedAllocate(size); }
+void operator delete(void *pointer) noexcept { TrackedDeallocate(pointer); }
+void operator delete[](void *pointer) noexcept { TrackedDeallocate(pointer); }
+void operator delete(void *pointer, size_t) noexcept { TrackedDeallocate(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { TrackedDeallocate(pointer); }
+void* operator new(size_t size, const std::nothrow_t &) noexcept { return TryTrackedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t &) noexcept { return TryTrackedAllocate(size); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { TrackedDeallocate(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { TrackedDeallocate(pointer); }
+#ifdef __cpp_aligned_new
+void* operator new(size_t size, std::align_val_t alignment) { return TrackedAllocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return TrackedAllocateAligned(size, alignment); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return TryTrackedAllocateAligned(size, alignment);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return TryTrackedAllocateAligned(size, alignment);
+}
+void operator delete(void *pointer, std::align_val_t) noexcept { TrackedDeallocateAligned(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { TrackedDeallocateAligned(pointer); }
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept { TrackedDeallocateAligned(pointer); }
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept { TrackedDeallocateAligned(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    TrackedDeallocateAligned(pointer);
+}
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    TrackedDeallocateAligned(pointer);
+}
+#endif
+
+namespace spectre::unsupervised::gmm
+{
+class MemoryUsageTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    void PrepareData(unsigned size, unsigned numberOfComponents)
+    {
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = 100.0 * i / size;
+            intensities[i] = 1.0 + (i % 7);
+        }
+        gaussianComponents.resize(numberOfComponents);
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            gaussianComponents[k] = { /*mean =*/ 100.0 * (k + 0.5) / numberOfComponents,
+                                      /*deviation =*/ 5.0, /*weight =*/ 1.0 / numberOfComponents };
+        }
+    }
+
+    size_t StreamingIterationsPeakUsage(unsigned size, unsigned numberOfComponents)
+    {
+        PrepareData(size, numberOfComponents);
+        return MeasurePeakUsage([this]()
+        {
+            StreamingIterationRunner runner(&mzs[0], &intensities[0], (unsigned)mzs.size(), gaussianComponents, 4);
+            for (int iteration = 0; iteration < 3; iteration++)
+            {
+                runner.Iterate();
+            }
+        });
+    }
+};
+
+TEST_F(MemoryUsageTest, reference_em_allocates_whole_affilation_matrix)
+{
+    const unsigned size = 1 << 14;
+    const unsigned numberOfComponents = 64;
+    PrepareData(size, numberOfComponents);
+    RandomNumberGenerator rngEngine(0);
+
+    const size_t usage = MeasurePeakUsage([&]()
+    {
+        ExpectationMaximization<
+            RandomInitializationRef,
+            ExpectationRunnerRef,
+            MaximizationRunnerRef,
+            LogLikelihoodCalculator
+        > em(&mzs[0], &intensities[0], size, rngEngine, numberOfComponents);
+    });
+
+    EXPECT_GE(usage, size * numberOfComponents * sizeof(DataType));
+}
+
+TEST_F(MemoryUsageTest, streaming_iterations_usage_does_not_depend_on_data_size)
+{
+    const unsigned numberOfComponents = 64;
+    StreamingIterationsPeakUsage(1 << 12, numberOfComponents); // warm up OpenMP runtime
+    const size_t smallDataUsage = StreamingIterationsPeakUsage(1 << 12, numberOfComponents);
+    const size_t largeDataUsage = StreamingIterationsPeakUsage(1 << 16, numberOfComponents);
+
+    EXPECT_EQ(largeDataUsage, smallDataUsage);
+    EXPECT_LT(largeDataUsage, (1 << 16) * numberOfComponents * sizeof(DataType) / 16);
+}
+
+TEST_F(MemoryUsageTest, streaming_iterations_usage_grows_linearly_with_components)
+{
+    const unsigned size = 1 << 16;
+    const size_t fewComponentsUsage = StreamingIterationsPeakUsage(size, 8);
+    const size_t manyComponentsUsage = StreamingIterationsPeakUsage(size, 64);
+
+    EXPECT_LT(manyComponentsUsage, 16 * fewComponentsUsage);
+    EXPECT_LT(manyComponentsUsage, size * 64 * sizeof(DataType) / 16);
+}
+
+TEST_F(MemoryUsageTest, log_domain_runners_reuse_scratch_buffers)
+{
+    const unsigned size = 1 << 14;
+    const unsigned numberOfComponents = 64;
+    PrepareData(size, numberOfComponents);
+    Matrix affilationMatrix(numberOfComponents, size, ExpectationRunnerLog::AFFILATION_LAYOUT);
+    ExpectationRunnerLog expectation(&mzs[0], size, affilationMatrix, gaussianComponents);
+    LogLikelihoodCalculatorLog likelihood(&mzs[0], &intensities[0], size, gaussianComponents);
+    WeightedLogLikelihoodCalculator weightedLikelihood(&mzs[0], &intensities[0], size, gaussianComponents);
+    expectation.Expectation();
+    likelihood.CalculateLikelihood();
+    weightedLikelihood.CalculateLikelihood();
+
+    const size_t usage = MeasurePeakUsage([&]()
+    {
+        expectation.Expectation();
+        likelihood.CalculateLikelihood();
+        weightedLikelihood.CalculateLikelihood();
+    });
+
+    // affilations of a single block to all the components would take more
+    EXPECT_LT(usage, numberOfComponents * KERNEL_BLOCK_SIZE * sizeof(DataType));
+}
+
+TEST_F(MemoryUsageTest, online_em_reuses_densities_buffer)
+{
+    const unsigned size = 1 << 14;
+    const unsigned numberOfComponents = 64;
+    PrepareData(size, numberOfComponents);
+    RandomNumberGenerator rngEngine(0);
+    OnlineExpectationMaximization<> em(&mzs[0], &intensities[0], size, rngEngine, numberOfComponents);
+    em.Update(&mzs[0], &intensities[0], size);
+
+    const size_t usage = MeasurePeakUsage([&]()
+    {
+        em.Update(&mzs[0], &intensities[0], size);
+    });
+
+    // densities of a single block of all the components would take more
+    EXPECT_LT(usage, numberOfComponents * KERNEL_BLOCK_SIZE * sizeof(DataType));
+}
+}
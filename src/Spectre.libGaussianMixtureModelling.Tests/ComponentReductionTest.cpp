@@ -0,0 +1,156 @@
+/*
+* ComponentReductionTest.cpp
+* Provides implementation of tests checking merging and pruning
+* of Gaussian Mixture Model components.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <limits>
+#include <gtest/gtest.h>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "ComponentReduction.h"
+#include "GaussianDistribution.h"
+
+namespace spectre::unsupervised::gmm
+{
+class ComponentReductionTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ -5.0, /*deviation =*/ 1.5, /*weight =*/ 0.4 },
+            { /*mean =*/ 5.0, /*deviation =*/ 2.0, /*weight =*/ 0.6 }
+        };
+
+        const unsigned size = 1000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = -20.0 + step * i;
+            intensities[i] = 0.0;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+    }
+};
+
+TEST_F(ComponentReductionTest, merging_preserves_moments_of_the_mixture)
+{
+    const std::vector<GaussianComponent> components = {
+        { /*mean =*/ 1.0, /*deviation =*/ 0.5, /*weight =*/ 0.2 },
+        { /*mean =*/ 1.6, /*deviation =*/ 1.0, /*weight =*/ 0.3 }
+    };
+
+    const std::vector<GaussianComponent> merged = MergeComponents(components, 1.0);
+
+    const double mean = (0.2 * 1.0 + 0.3 * 1.6) / 0.5;
+    const double secondMoment = (0.2 * (0.25 + 1.0) + 0.3 * (1.0 + 1.6 * 1.6)) / 0.5;
+    ASSERT_EQ(merged.size(), 1u);
+    EXPECT_NEAR(merged[0].weight, 0.5, 1e-12);
+    EXPECT_NEAR(merged[0].mean, mean, 1e-12);
+    EXPECT_NEAR(merged[0].deviation * merged[0].deviation, secondMoment - mean * mean, 1e-12);
+}
+
+TEST_F(ComponentReductionTest, merging_keeps_distant_components_and_sorts_them)
+{
+    const std::vector<GaussianComponent> components = {
+        { /*mean =*/ 3.0, /*deviation =*/ 0.5, /*weight =*/ 0.2 },
+        { /*mean =*/ 1.0, /*deviation =*/ 0.5, /*weight =*/ 0.3 },
+        { /*mean =*/ 1.2, /*deviation =*/ 0.5, /*weight =*/ 0.1 },
+        { /*mean =*/ 1.4, /*deviation =*/ 0.5, /*weight =*/ 0.4 }
+    };
+
+    const std::vector<GaussianComponent> merged = MergeComponents(components, 0.5);
+
+    ASSERT_EQ(merged.size(), 2u);
+    EXPECT_NEAR(merged[0].weight, 0.8, 1e-12);
+    EXPECT_NEAR(merged[0].mean, (0.3 * 1.0 + 0.1 * 1.2 + 0.4 * 1.4) / 0.8, 1e-12);
+    EXPECT_EQ(merged[1].mean, 3.0);
+    EXPECT_EQ(merged[1].weight, 0.2);
+    EXPECT_EQ(MergeComponents(components, 0.0).size(), components.size());
+}
+
+TEST_F(ComponentReductionTest, pruning_removes_degenerate_components_and_normalizes_weights)
+{
+    const std::vector<GaussianComponent> components = {
+        { /*mean =*/ 1.0, /*deviation =*/ 0.5, /*weight =*/ 0.3 },
+        { /*mean =*/ 2.0, /*deviation =*/ 0.5, /*weight =*/ 1e-9 },
+        { /*mean =*/ 3.0, /*deviation =*/ 0.0, /*weight =*/ 0.2 },
+        { /*mean =*/ std::numeric_limits<double>::quiet_NaN(), /*deviation =*/ 0.5, /*weight =*/ 0.1 },
+        { /*mean =*/ 4.0, /*deviation =*/ 0.05, /*weight =*/ 0.1 },
+        { /*mean =*/ 5.0, /*deviation =*/ 1.0, /*weight =*/ 0.3 }
+    };
+
+    const std::vector<GaussianComponent> pruned = PruneComponents(components, DEFAULT_MIN_COMPONENT_WEIGHT, 0.1);
+
+    ASSERT_EQ(pruned.size(), 2u);
+    EXPECT_EQ(pruned[0].mean, 1.0);
+    EXPECT_EQ(pruned[1].mean, 5.0);
+    EXPECT_NEAR(pruned[0].weight, 0.5, 1e-12);
+    EXPECT_NEAR(pruned[1].weight, 0.5, 1e-12);
+}
+
+TEST_F(ComponentReductionTest, reduction_recovers_components_of_the_data)
+{
+    // each peak split into two, followed by negligible and collapsed components
+    const std::vector<GaussianComponent> components = {
+        { /*mean =*/ -5.4, /*deviation =*/ 1.4, /*weight =*/ 0.2 },
+        { /*mean =*/ -4.6, /*deviation =*/ 1.4, /*weight =*/ 0.2 },
+        { /*mean =*/ 4.5, /*deviation =*/ 1.9, /*weight =*/ 0.3 },
+        { /*mean =*/ 5.5, /*deviation =*/ 1.9, /*weight =*/ 0.3 },
+        { /*mean =*/ 15.0, /*deviation =*/ 1.0, /*weight =*/ 1e-7 },
+        { /*mean =*/ 0.0, /*deviation =*/ 1e-6, /*weight =*/ 0.01 }
+    };
+    ComponentReduction<> reduction(&mzs[0], &intensities[0], (unsigned)mzs.size(), 2.0);
+
+    const GaussianMixtureModel model = reduction.Reduce(components, 100);
+
+    ASSERT_EQ(model.components.size(), gaussianComponents.size());
+    for (unsigned k = 0; k < gaussianComponents.size(); k++)
+    {
+        EXPECT_NEAR(model.components[k].weight, gaussianComponents[k].weight, 1e-2);
+        EXPECT_NEAR(model.components[k].mean, gaussianComponents[k].mean, 1e-2);
+        EXPECT_NEAR(model.components[k].deviation, gaussianComponents[k].deviation, 1e-2);
+    }
+    EXPECT_TRUE(model.isMerged);
+    EXPECT_TRUE(model.isNoiseReduced);
+    EXPECT_EQ(model.mzMergingThreshold, 2.0);
+}
+
+TEST_F(ComponentReductionTest, throws_on_invalid_arguments)
+{
+    const unsigned size = (unsigned)mzs.size();
+
+    EXPECT_THROW(ComponentReduction<>(nullptr, &intensities[0], size, 1.0),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(ComponentReduction<>(&mzs[0], nullptr, size, 1.0),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(ComponentReduction<>(&mzs[0], &intensities[0], size, -1.0),
+                 spectre::core::exception::ArgumentOutOfRangeException<DataType>);
+}
+}
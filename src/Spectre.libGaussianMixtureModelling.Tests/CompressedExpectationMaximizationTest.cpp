@@ -0,0 +1,165 @@
+/*
+* CompressedExpectationMaximizationTest.cpp
+* Provides implementation of tests checking compression of spectra
+* and Expectation Maximization algorithm run on them.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <gtest/gtest.h>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "CompressedExpectationMaximization.h"
+#include "GaussianDistribution.h"
+
+namespace spectre::unsupervised::gmm
+{
+class CompressedExpectationMaximizationTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<double> nonZeroMzs;
+    std::vector<double> nonZeroIntensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ -5.0, /*deviation =*/ 1.5, /*weight =*/ 0.4 },
+            { /*mean =*/ 5.0, /*deviation =*/ 2.0, /*weight =*/ 0.6 }
+        };
+
+        // baseline far from the peaks is cut to zero
+        const unsigned size = 2000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = -20.0 + step * i;
+            intensities[i] = 0.0;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+            if (intensities[i] < 1e-6)
+            {
+                intensities[i] = 0.0;
+            }
+            else
+            {
+                nonZeroMzs.push_back(mzs[i]);
+                nonZeroIntensities.push_back(intensities[i]);
+            }
+        }
+    }
+};
+
+TEST_F(CompressedExpectationMaximizationTest, compression_drops_zeros_and_coalesces_bins_within_tolerance)
+{
+    const double tolerance = 0.1;
+
+    const CompressedSpectrum compressed = CompressSpectrum(&mzs[0], &intensities[0], (unsigned)mzs.size(),
+                                                           tolerance);
+
+    ASSERT_EQ(compressed.mzs.size(), compressed.intensities.size());
+    EXPECT_LT(compressed.mzs.size(), nonZeroMzs.size() / 2);
+    double total = 0.0;
+    double moment = 0.0;
+    for (unsigned i = 0; i < nonZeroMzs.size(); i++)
+    {
+        total += nonZeroIntensities[i];
+        moment += nonZeroIntensities[i] * nonZeroMzs[i];
+    }
+    double compressedTotal = 0.0;
+    double compressedMoment = 0.0;
+    for (unsigned i = 0; i < compressed.mzs.size(); i++)
+    {
+        EXPECT_GT(compressed.intensities[i], 0.0);
+        if (i > 0)
+        {
+            EXPECT_GT(compressed.mzs[i], compressed.mzs[i - 1]);
+        }
+        compressedTotal += compressed.intensities[i];
+        compressedMoment += compressed.intensities[i] * compressed.mzs[i];
+    }
+    EXPECT_NEAR(compressedTotal, total, 1e-12 * total);
+    EXPECT_NEAR(compressedMoment, moment, 1e-9 * fabs(moment));
+}
+
+TEST_F(CompressedExpectationMaximizationTest, dropping_zeros_does_not_change_the_estimate)
+{
+    RandomNumberGenerator rngEngine(0);
+    CompressedExpectationMaximization<> em(&mzs[0], &intensities[0], (unsigned)mzs.size(), rngEngine, 2);
+    RandomNumberGenerator referenceEngine(0);
+    FusedExpectationMaximization<RandomInitializationRef> reference(
+        &nonZeroMzs[0], &nonZeroIntensities[0], (unsigned)nonZeroMzs.size(), referenceEngine, 2);
+
+    const GaussianMixtureModel model = em.EstimateGmm();
+    const GaussianMixtureModel expected = reference.EstimateGmm();
+
+    EXPECT_EQ(em.CompressedSize(), (unsigned)nonZeroMzs.size());
+    ASSERT_EQ(model.components.size(), expected.components.size());
+    for (unsigned k = 0; k < expected.components.size(); k++)
+    {
+        EXPECT_NEAR(model.components[k].weight, expected.components[k].weight, 1e-9);
+        EXPECT_NEAR(model.components[k].mean, expected.components[k].mean, 1e-9);
+        EXPECT_NEAR(model.components[k].deviation, expected.components[k].deviation, 1e-9);
+    }
+    EXPECT_EQ(model.originalMzArray, mzs);
+    EXPECT_EQ(model.originalMeanSpectrum, intensities);
+}
+
+TEST_F(CompressedExpectationMaximizationTest, coalesced_estimate_stays_within_error_bound)
+{
+    const double tolerance = 0.2;
+    RandomNumberGenerator rngEngine(0);
+    CompressedExpectationMaximization<> em(&mzs[0], &intensities[0], (unsigned)mzs.size(), rngEngine, 2,
+                                           tolerance);
+    RandomNumberGenerator referenceEngine(0);
+    CompressedExpectationMaximization<> reference(&mzs[0], &intensities[0], (unsigned)mzs.size(),
+                                                  referenceEngine, 2);
+
+    GaussianMixtureModel model = em.EstimateGmm();
+    GaussianMixtureModel expected = reference.EstimateGmm();
+
+    EXPECT_LT(em.CompressedSize(), reference.CompressedSize() / 4);
+    ASSERT_EQ(model.components.size(), expected.components.size());
+    for (unsigned k = 0; k < expected.components.size(); k++)
+    {
+        const double variance = model.components[k].deviation * model.components[k].deviation;
+        const double expectedVariance = expected.components[k].deviation * expected.components[k].deviation;
+        EXPECT_NEAR(model.components[k].weight, expected.components[k].weight, 1e-2);
+        EXPECT_NEAR(model.components[k].mean, expected.components[k].mean, 1e-2);
+        EXPECT_NEAR(variance, expectedVariance, tolerance * tolerance / 4);
+    }
+}
+
+TEST_F(CompressedExpectationMaximizationTest, throws_on_invalid_arguments)
+{
+    const unsigned size = (unsigned)mzs.size();
+    RandomNumberGenerator rngEngine(0);
+
+    EXPECT_THROW(CompressedExpectationMaximization<>(nullptr, &intensities[0], size, rngEngine),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(CompressedExpectationMaximization<>(&mzs[0], nullptr, size, rngEngine),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(CompressedExpectationMaximization<>(&mzs[0], &intensities[0], size, rngEngine, 2, -1.0),
+                 spectre::core::exception::ArgumentOutOfRangeException<DataType>);
+}
+}
@@ -0,0 +1,215 @@
+/*
+* ConvergenceMonitorTest.cpp
+* Provides implementation of tests checking convergence criteria
+* and telemetry of Expectation Maximization algorithm.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <gtest/gtest.h>
+#include "ConvergenceMonitor.h"
+#include "ExpectationMaximization.h"
+#include "ExpectationRunnerOpt.h"
+#include "FusedExpectationMaximization.h"
+#include "GaussianDistribution.h"
+#include "LogLikelihoodCalculatorOpt.h"
+#include "MaximizationRunnerOpt.h"
+#include "RandomInitializationRef.h"
+
+namespace spectre::unsupervised::gmm
+{
+typedef ExpectationMaximization<
+    RandomInitializationRef,
+    ExpectationRunnerOpt,
+    MaximizationRunnerOpt,
+    LogLikelihoodCalculatorOpt
+> OptimizedExpectationMaximization;
+
+class ConvergenceMonitorTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ 10.0, /*deviation =*/ 1.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 20.0, /*deviation =*/ 2.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 35.0, /*deviation =*/ 1.5, /*weight =*/ 0.4 }
+        };
+
+        const unsigned size = 1000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = step * i;
+            intensities[i] = 1e-6;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+    }
+
+    template <typename Algorithm>
+    ConvergenceReport Run(const ConvergenceCriteria &criteria, std::vector<IterationRecord> *records = nullptr)
+    {
+        ConvergenceCriteria recordingCriteria(criteria);
+        if (records != nullptr)
+        {
+            recordingCriteria.onIteration = [records](const IterationRecord &record) { records->push_back(record); };
+        }
+        RandomNumberGenerator rngEngine(0);
+        Algorithm em(&mzs[0], &intensities[0], (unsigned)mzs.size(), rngEngine, 3);
+        em.SetConvergenceCriteria(recordingCriteria);
+        em.EstimateGmm();
+        return em.GetConvergenceReport();
+    }
+};
+
+TEST_F(ConvergenceMonitorTest, default_criteria_stop_on_absolute_change)
+{
+    std::vector<IterationRecord> records;
+
+    const ConvergenceReport report = Run<OptimizedExpectationMaximization>(ConvergenceCriteria(), &records);
+
+    EXPECT_EQ(report.reason, StopReason::Converged);
+    ASSERT_EQ(records.size(), report.iterations);
+    ASSERT_GT(records.size(), 1u);
+    const size_t last = records.size() - 1;
+    EXPECT_LE(fabs(records[last].logLikelihood - records[last - 1].logLikelihood), DEFAULT_ABSOLUTE_TOLERANCE);
+    EXPECT_GT(fabs(records[last - 1].logLikelihood - records[last - 2].logLikelihood), DEFAULT_ABSOLUTE_TOLERANCE);
+    EXPECT_EQ(report.logLikelihood, records[last].logLikelihood);
+}
+
+TEST_F(ConvergenceMonitorTest, relative_tolerance_stops_earlier)
+{
+    ConvergenceCriteria criteria;
+    criteria.relativeTolerance = 1e-4;
+
+    const ConvergenceReport absolute = Run<OptimizedExpectationMaximization>(ConvergenceCriteria());
+    const ConvergenceReport relative = Run<OptimizedExpectationMaximization>(criteria);
+
+    EXPECT_EQ(relative.reason, StopReason::Converged);
+    EXPECT_LT(relative.iterations, absolute.iterations);
+}
+
+TEST_F(ConvergenceMonitorTest, max_iterations_limit_run)
+{
+    ConvergenceCriteria criteria;
+    criteria.maxIterations = 5;
+    std::vector<IterationRecord> records;
+    std::vector<IterationRecord> fusedRecords;
+
+    const ConvergenceReport report = Run<OptimizedExpectationMaximization>(criteria, &records);
+    const ConvergenceReport fusedReport = Run<FusedExpectationMaximization<RandomInitializationRef>>(criteria, &fusedRecords);
+
+    EXPECT_EQ(report.reason, StopReason::MaxIterations);
+    EXPECT_EQ(report.iterations, 5u);
+    EXPECT_EQ(records.size(), 5u);
+    EXPECT_EQ(fusedReport.reason, StopReason::MaxIterations);
+    EXPECT_EQ(fusedReport.iterations, 5u);
+    EXPECT_EQ(fusedRecords.size(), 5u);
+}
+
+TEST_F(ConvergenceMonitorTest, time_budget_limits_run)
+{
+    ConvergenceCriteria criteria;
+    criteria.timeBudget = 1e-9;
+
+    const ConvergenceReport report = Run<OptimizedExpectationMaximization>(criteria);
+    const ConvergenceReport fusedReport = Run<FusedExpectationMaximization<RandomInitializationRef>>(criteria);
+
+    EXPECT_EQ(report.reason, StopReason::TimeBudget);
+    EXPECT_EQ(report.iterations, 1u);
+    EXPECT_EQ(fusedReport.reason, StopReason::TimeBudget);
+    EXPECT_EQ(fusedReport.iterations, 1u);
+}
+
+TEST_F(ConvergenceMonitorTest, records_telemetry_of_each_iteration)
+{
+    std::vector<IterationRecord> records;
+    std::vector<IterationRecord> fusedRecords;
+
+    Run<OptimizedExpectationMaximization>(ConvergenceCriteria(), &records);
+    Run<FusedExpectationMaximization<RandomInitializationRef>>(ConvergenceCriteria(), &fusedRecords);
+
+    for (unsigned i = 0; i < records.size(); i++)
+    {
+        EXPECT_EQ(records[i].iteration, i + 1);
+        EXPECT_GE(records[i].expectationSeconds, 0.0);
+        EXPECT_GE(records[i].maximizationSeconds, 0.0);
+        EXPECT_GE(records[i].logLikelihoodSeconds, 0.0);
+        EXPECT_TRUE(isfinite(records[i].logLikelihood));
+        EXPECT_EQ(records[i].collapsedComponents, 0u);
+    }
+    for (unsigned i = 0; i < fusedRecords.size(); i++)
+    {
+        EXPECT_EQ(fusedRecords[i].iteration, i + 1);
+        EXPECT_GE(fusedRecords[i].expectationSeconds, 0.0);
+        EXPECT_EQ(fusedRecords[i].maximizationSeconds, 0.0);
+        EXPECT_EQ(fusedRecords[i].logLikelihoodSeconds, 0.0);
+    }
+}
+
+TEST_F(ConvergenceMonitorTest, counts_collapsed_components)
+{
+    std::vector<GaussianComponent> components = {
+        { /*mean =*/ 10.0, /*deviation =*/ 1.0, /*weight =*/ 0.5 },
+        { /*mean =*/ 20.0, /*deviation =*/ 0.001, /*weight =*/ 0.25 },
+        { /*mean =*/ 30.0, /*deviation =*/ 1.0, /*weight =*/ 0.0 },
+        { /*mean =*/ 35.0, /*deviation =*/ NAN, /*weight =*/ 0.25 }
+    };
+    std::vector<IterationRecord> records;
+    ConvergenceCriteria criteria;
+    criteria.onIteration = [&records](const IterationRecord &record) { records.push_back(record); };
+    ConvergenceMonitor monitor(criteria, &mzs[0], (unsigned)mzs.size(), components);
+
+    EXPECT_TRUE(monitor.Continue(-10.0, 0.0, 0.0, 0.0));
+    components[1].deviation = 1.0;
+    EXPECT_FALSE(monitor.Continue(-10.0, 0.0, 0.0, 0.0));
+
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].collapsedComponents, 3u);
+    EXPECT_EQ(records[1].collapsedComponents, 2u);
+    EXPECT_EQ(monitor.Report().reason, StopReason::Converged);
+}
+
+TEST_F(ConvergenceMonitorTest, stops_on_likelihood_not_finite)
+{
+    ConvergenceCriteria criteria;
+    ConvergenceMonitor monitor(criteria, &mzs[0], (unsigned)mzs.size(), gaussianComponents);
+    ConvergenceMonitor infiniteMonitor(criteria, &mzs[0], (unsigned)mzs.size(), gaussianComponents);
+    ConvergenceMonitor initialMonitor(criteria, &mzs[0], (unsigned)mzs.size(), gaussianComponents);
+    initialMonitor.SetInitialLikelihood(-INFINITY);
+
+    EXPECT_TRUE(monitor.Continue(-10.0, 0.0, 0.0, 0.0));
+    EXPECT_FALSE(monitor.Continue(NAN, 0.0, 0.0, 0.0));
+    EXPECT_FALSE(infiniteMonitor.Continue(-INFINITY, 0.0, 0.0, 0.0));
+    // initial likelihood, which is not finite, does not stop the run
+    EXPECT_TRUE(initialMonitor.Continue(-10.0, 0.0, 0.0, 0.0));
+
+    EXPECT_EQ(monitor.Report().reason, StopReason::NotFinite);
+    EXPECT_EQ(monitor.Report().iterations, 2u);
+    EXPECT_EQ(infiniteMonitor.Report().reason, StopReason::NotFinite);
+    EXPECT_EQ(infiniteMonitor.Report().iterations, 1u);
+}
+}
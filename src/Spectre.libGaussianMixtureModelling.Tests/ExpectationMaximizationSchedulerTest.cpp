@@ -0,0 +1,260 @@
+/*
+* ExpectationMaximizationSchedulerTest.cpp
+* Provides implementation of tests checking asynchronous estimation
+* of many Gaussian Mixture Models on a shared pool of threads.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <atomic>
+#include <future>
+#include <gtest/gtest.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libException/OperationCancelledException.h"
+#include "ExpectationMaximizationScheduler.h"
+#include "GaussianDistribution.h"
+
+namespace spectre::unsupervised::gmm
+{
+class ExpectationMaximizationSchedulerTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<std::vector<double>> datasets;
+
+    virtual void SetUp() override
+    {
+        const unsigned size = 1000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = step * i;
+        }
+
+        // datasets of peaks shifted by one another
+        datasets.resize(6);
+        for (unsigned d = 0; d < datasets.size(); d++)
+        {
+            const std::vector<GaussianComponent> components = {
+                { /*mean =*/ 10.0 + d, /*deviation =*/ 1.0, /*weight =*/ 0.3 },
+                { /*mean =*/ 20.0 + d, /*deviation =*/ 2.0, /*weight =*/ 0.3 },
+                { /*mean =*/ 30.0 + d, /*deviation =*/ 1.5, /*weight =*/ 0.4 }
+            };
+            datasets[d].resize(size);
+            for (unsigned i = 0; i < size; i++)
+            {
+                datasets[d][i] = 1e-6;
+                for (const auto &component : components)
+                {
+                    datasets[d][i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+                }
+            }
+        }
+    }
+};
+
+TEST_F(ExpectationMaximizationSchedulerTest, jobs_estimate_the_same_models_as_direct_runs)
+{
+    ExpectationMaximizationScheduler<> scheduler(3);
+    const unsigned size = (unsigned)mzs.size();
+    std::vector<EstimationJob> jobs;
+    for (unsigned d = 0; d < datasets.size(); d++)
+    {
+        jobs.push_back(scheduler.Submit(&mzs[0], &datasets[d][0], size, 3, d));
+    }
+
+    for (unsigned d = 0; d < datasets.size(); d++)
+    {
+        RandomNumberGenerator rngEngine(d);
+        FusedExpectationMaximization<KMeansPlusPlusInitialization> em(&mzs[0], &datasets[d][0], size, rngEngine, 3);
+        const GaussianMixtureModel expected = em.EstimateGmm();
+
+        const GaussianMixtureModel model = jobs[d].Get();
+
+        ASSERT_EQ(model.components.size(), expected.components.size());
+        for (unsigned k = 0; k < expected.components.size(); k++)
+        {
+            EXPECT_NEAR(model.components[k].mean, expected.components[k].mean, 1e-9);
+            EXPECT_NEAR(model.components[k].deviation, expected.components[k].deviation, 1e-9);
+            EXPECT_NEAR(model.components[k].weight, expected.components[k].weight, 1e-9);
+        }
+    }
+}
+
+TEST_F(ExpectationMaximizationSchedulerTest, models_do_not_depend_on_load)
+{
+    const unsigned numberOfChunks = 4;
+    ExpectationMaximizationScheduler<> scheduler(3, numberOfChunks);
+    const unsigned size = (unsigned)mzs.size();
+    // the first job starts alone, while the next ones share the pool
+    std::vector<EstimationJob> jobs;
+    for (unsigned d = 0; d < datasets.size(); d++)
+    {
+        jobs.push_back(scheduler.Submit(&mzs[0], &datasets[d][0], size, 3, d));
+    }
+
+    ASSERT_EQ(scheduler.NumberOfChunks(), numberOfChunks);
+    for (unsigned d = 0; d < datasets.size(); d++)
+    {
+        RandomNumberGenerator rngEngine(d);
+        FusedExpectationMaximization<KMeansPlusPlusInitialization, StreamingIterationRunner> em(
+            &mzs[0], &datasets[d][0], size, rngEngine, 3, numberOfChunks);
+        const GaussianMixtureModel expected = em.EstimateGmm();
+
+        const GaussianMixtureModel model = jobs[d].Get();
+
+        ASSERT_EQ(model.components.size(), expected.components.size());
+        for (unsigned k = 0; k < expected.components.size(); k++)
+        {
+            EXPECT_EQ(model.components[k].mean, expected.components[k].mean);
+            EXPECT_EQ(model.components[k].deviation, expected.components[k].deviation);
+            EXPECT_EQ(model.components[k].weight, expected.components[k].weight);
+        }
+    }
+}
+
+TEST_F(ExpectationMaximizationSchedulerTest, cancelled_jobs_throw)
+{
+    ExpectationMaximizationScheduler<> scheduler(1);
+    const unsigned size = (unsigned)mzs.size();
+    // the only thread is held by the first job, until it is released
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    bool signalled = false;
+    ConvergenceCriteria criteria;
+    criteria.onIteration = [&started, released, &signalled](const IterationRecord &)
+    {
+        if (!signalled)
+        {
+            signalled = true;
+            started.set_value();
+        }
+        released.wait();
+    };
+    EstimationJob running = scheduler.Submit(&mzs[0], &datasets[0][0], size, 3, 0, criteria);
+    EstimationJob waiting = scheduler.Submit(&mzs[0], &datasets[1][0], size, 3, 0);
+    EstimationJob finishing = scheduler.Submit(&mzs[0], &datasets[2][0], size, 3, 0);
+    started.get_future().wait();
+
+    running.Cancel();
+    waiting.Cancel();
+    release.set_value();
+
+    EXPECT_THROW(running.Get(), spectre::core::exception::OperationCancelledException);
+    EXPECT_THROW(waiting.Get(), spectre::core::exception::OperationCancelledException);
+    EXPECT_EQ(finishing.Get().components.size(), 3u);
+}
+
+TEST_F(ExpectationMaximizationSchedulerTest, destruction_cancels_unfinished_jobs)
+{
+    std::vector<EstimationJob> jobs;
+    std::promise<void> started;
+    bool signalled = false;
+    {
+        ExpectationMaximizationScheduler<> scheduler(1);
+        ConvergenceCriteria criteria;
+        // never converging job, so it is still running when the scheduler is destroyed
+        criteria.maxIterations = 0;
+        criteria.absoluteTolerance = -1.0;
+        criteria.relativeTolerance = -1.0;
+        criteria.onIteration = [&started, &signalled](const IterationRecord &)
+        {
+            if (!signalled)
+            {
+                signalled = true;
+                started.set_value();
+            }
+        };
+        jobs.push_back(scheduler.Submit(&mzs[0], &datasets[0][0], (unsigned)mzs.size(), 3, 0, criteria));
+        jobs.push_back(scheduler.Submit(&mzs[0], &datasets[1][0], (unsigned)mzs.size(), 3, 0));
+        started.get_future().wait();
+    }
+
+    for (EstimationJob &job : jobs)
+    {
+        EXPECT_TRUE(job.IsReady());
+        EXPECT_THROW(job.Get(), spectre::core::exception::OperationCancelledException);
+    }
+}
+
+TEST_F(ExpectationMaximizationSchedulerTest, threads_in_use_never_exceed_the_pool)
+{
+    const unsigned numberOfThreads = 4;
+    ExpectationMaximizationScheduler<> scheduler(numberOfThreads);
+    const unsigned size = (unsigned)mzs.size();
+    std::atomic<unsigned> maximum(0);
+    ConvergenceCriteria criteria;
+    criteria.onIteration = [&scheduler, &maximum](const IterationRecord &)
+    {
+        unsigned inUse = scheduler.ThreadsInUse();
+#ifdef _OPENMP
+        // threads of parallel loops of this very job
+        EXPECT_LE((unsigned)omp_get_max_threads(), inUse);
+#endif
+        unsigned previous = maximum;
+        while (inUse > previous && !maximum.compare_exchange_weak(previous, inUse))
+        {
+        }
+    };
+    std::vector<EstimationJob> jobs;
+    for (unsigned d = 0; d < datasets.size(); d++)
+    {
+        jobs.push_back(scheduler.Submit(&mzs[0], &datasets[d][0], size, 3, d, criteria));
+    }
+
+    for (EstimationJob &job : jobs)
+    {
+        EXPECT_EQ(job.Get().components.size(), 3u);
+    }
+    EXPECT_GT(maximum.load(), 0u);
+    EXPECT_LE(maximum.load(), numberOfThreads);
+}
+
+TEST_F(ExpectationMaximizationSchedulerTest, single_job_uses_whole_pool)
+{
+    const unsigned numberOfThreads = 4;
+    ExpectationMaximizationScheduler<> scheduler(numberOfThreads);
+    std::atomic<unsigned> used(0);
+    ConvergenceCriteria criteria;
+    criteria.onIteration = [&scheduler, &used](const IterationRecord &)
+    {
+        used = scheduler.ThreadsInUse();
+    };
+
+    scheduler.Submit(&mzs[0], &datasets[0][0], (unsigned)mzs.size(), 3, 0, criteria).Get();
+
+    EXPECT_EQ(used.load(), numberOfThreads);
+}
+
+TEST_F(ExpectationMaximizationSchedulerTest, throws_on_null_arrays)
+{
+    ExpectationMaximizationScheduler<> scheduler(1);
+    const unsigned size = (unsigned)mzs.size();
+
+    EXPECT_THROW(scheduler.Submit(nullptr, &datasets[0][0], size, 3, 0),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(scheduler.Submit(&mzs[0], nullptr, size, 3, 0),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_GT(ExpectationMaximizationScheduler<>().NumberOfThreads(), 0u);
+    EXPECT_EQ(ExpectationMaximizationScheduler<>(3).NumberOfChunks(), 3u);
+}
+}
@@ -180,7 +180,7 @@ TEST_F(ExpectationMaximizationTest, test_em_ref_expectation)
         {
             DataType numerator = gaussianComponents[k].weight *
                 Gaussian(mzs[i], gaussianComponents[k].mean, gaussianComponents[k].deviation);
-            EXPECT_EQ(affilationMatrix[i][k], numerator / denominator);
+            EXPECT_EQ(affilationMatrix(k, i), numerator / denominator);
         }
     }
 }
@@ -193,7 +193,7 @@ TEST_F(ExpectationMaximizationTest, test_em_ref_maximization)
     {
         for (unsigned k = 0; k < gaussianComponents.size(); k++)
         {
-            affilationMatrix[i][k] = 0.1;
+            affilationMatrix(k, i) = 0.1;
         }
     }
 
@@ -209,8 +209,8 @@ TEST_F(ExpectationMaximizationTest, test_em_ref_maximization)
         DataType numerator = 0.0;
         for (unsigned i = 0; i < mzs.size(); i++)
         {
-            denominator += affilationMatrix[i][k] * intensities[i];
-            numerator += affilationMatrix[i][k] * mzs[i] * intensities[i];
+            denominator += affilationMatrix(k, i) * intensities[i];
+            numerator += affilationMatrix(k, i) * mzs[i] * intensities[i];
         }
         EXPECT_EQ(gaussianComponents[k].mean, numerator / denominator);
     }
@@ -224,8 +224,8 @@ TEST_F(ExpectationMaximizationTest, test_em_ref_maximization)
         DataType numerator = 0.0;
         for (unsigned i = 0; i < mzs.size(); i++)
         {
-            denominator += affilationMatrix[i][k] * intensities[i];
-            numerator += affilationMatrix[i][k] * pow(mzs[i] - gaussianComponents[k].mean, 2) * intensities[i];
+            denominator += affilationMatrix(k, i) * intensities[i];
+            numerator += affilationMatrix(k, i) * pow(mzs[i] - gaussianComponents[k].mean, 2) * intensities[i];
         }
         EXPECT_EQ(gaussianComponents[k].deviation, sqrt(numerator / denominator));
     }
@@ -245,7 +245,7 @@ TEST_F(ExpectationMaximizationTest, test_em_ref_maximization)
         DataType weight = 0.0;
         for (unsigned i = 0; i < mzs.size(); i++)
         {
-            weight += affilationMatrix[i][k] * intensities[i];
+            weight += affilationMatrix(k, i) * intensities[i];
         }
         EXPECT_EQ(gaussianComponents[k].weight, weight / totalDataSize);
     }
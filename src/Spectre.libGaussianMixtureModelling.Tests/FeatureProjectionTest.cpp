@@ -0,0 +1,217 @@
+/*
+* FeatureProjectionTest.cpp
+* Provides implementation of tests checking projection of spectra
+* onto components of Gaussian Mixture Model.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "FeatureProjection.h"
+#include "GaussianDistribution.h"
+
+namespace spectre::unsupervised::gmm
+{
+class FeatureProjectionTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> spectra;
+    std::vector<GaussianComponent> gaussianComponents;
+    const unsigned numberOfSpectra = 37;
+
+    // Spectra of three peaks of heights varying from spectrum to spectrum.
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ 10.0, /*deviation =*/ 1.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 13.0, /*deviation =*/ 2.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 35.0, /*deviation =*/ 1.5, /*weight =*/ 0.4 }
+        };
+
+        const unsigned size = 1000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        spectra.resize(size * numberOfSpectra);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = step * i;
+        }
+        for (unsigned s = 0; s < numberOfSpectra; s++)
+        {
+            for (unsigned i = 0; i < size; i++)
+            {
+                DataType intensity = 0.0;
+                for (unsigned k = 0; k < gaussianComponents.size(); k++)
+                {
+                    const DataType height = 1.0 + (s * (k + 1)) % 5;
+                    intensity += height * Gaussian(mzs[i], gaussianComponents[k].mean, gaussianComponents[k].deviation);
+                }
+                spectra[s * size + i] = intensity;
+            }
+        }
+    }
+
+    // Projection with affilations evaluated against all the components at every point.
+    std::vector<DataType> ProjectDensely() const
+    {
+        const unsigned size = (unsigned)mzs.size();
+        const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+        std::vector<DataType> features(numberOfSpectra * numberOfComponents, 0.0);
+        for (unsigned i = 0; i < size; i++)
+        {
+            std::vector<DataType> densities(numberOfComponents);
+            DataType denominator = 0.0;
+            for (unsigned k = 0; k < numberOfComponents; k++)
+            {
+                const GaussianComponent &component = gaussianComponents[k];
+                densities[k] = component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+                denominator += densities[k];
+            }
+            for (unsigned s = 0; s < numberOfSpectra; s++)
+            {
+                for (unsigned k = 0; k < numberOfComponents; k++)
+                {
+                    features[s * numberOfComponents + k] += spectra[s * size + i] * densities[k] / denominator;
+                }
+            }
+        }
+        return features;
+    }
+};
+
+TEST_F(FeatureProjectionTest, matches_dense_projection)
+{
+    const unsigned size = (unsigned)mzs.size();
+    // support wide enough to cover the whole m/z range
+    FeatureProjection projection(&mzs[0], size, gaussianComponents, 30.0);
+    std::vector<DataType> features(numberOfSpectra * gaussianComponents.size());
+
+    projection.Project(&spectra[0], numberOfSpectra, &features[0]);
+
+    const std::vector<DataType> expected = ProjectDensely();
+    for (unsigned i = 0; i < features.size(); i++)
+    {
+        EXPECT_NEAR(features[i], expected[i], 1e-10 * expected[i]);
+    }
+}
+
+TEST_F(FeatureProjectionTest, preserves_total_intensity_within_supports)
+{
+    const unsigned size = (unsigned)mzs.size();
+    FeatureProjection projection(&mzs[0], size, gaussianComponents);
+    const unsigned numberOfComponents = projection.NumberOfComponents();
+    std::vector<DataType> features(numberOfSpectra * numberOfComponents);
+
+    projection.Project(&spectra[0], numberOfSpectra, &features[0]);
+
+    for (unsigned s = 0; s < numberOfSpectra; s++)
+    {
+        DataType total = 0.0;
+        DataType projected = 0.0;
+        for (unsigned i = 0; i < size; i++)
+        {
+            total += spectra[s * size + i];
+        }
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            projected += features[s * numberOfComponents + k];
+        }
+        EXPECT_NEAR(projected, total, 1e-12 * total);
+    }
+}
+
+TEST_F(FeatureProjectionTest, separated_component_collects_its_peak)
+{
+    const unsigned size = (unsigned)mzs.size();
+    FeatureProjection projection(&mzs[0], size, gaussianComponents);
+    std::vector<DataType> features(numberOfSpectra * gaussianComponents.size());
+
+    projection.Project(&spectra[0], numberOfSpectra, &features[0]);
+
+    DataType peak = 0.0;
+    for (unsigned i = 0; i < size; i++)
+    {
+        peak += Gaussian(mzs[i], gaussianComponents[2].mean, gaussianComponents[2].deviation);
+    }
+    for (unsigned s = 0; s < numberOfSpectra; s++)
+    {
+        const DataType height = 1.0 + (s * 3) % 5;
+        EXPECT_NEAR(features[s * 3 + 2], height * peak, 1e-9 * height * peak);
+    }
+}
+
+TEST_F(FeatureProjectionTest, blockwise_projection_matches_direct_one)
+{
+    const unsigned size = (unsigned)mzs.size();
+    FeatureProjection projection(&mzs[0], size, gaussianComponents);
+    const unsigned numberOfComponents = projection.NumberOfComponents();
+    std::vector<DataType> expected(numberOfSpectra * numberOfComponents);
+    projection.Project(&spectra[0], numberOfSpectra, &expected[0]);
+
+    for (unsigned blockSize : { 1u, 5u, 16u, numberOfSpectra, 2 * numberOfSpectra })
+    {
+        std::vector<DataType> features(numberOfSpectra * numberOfComponents, -1.0);
+        unsigned maxRead = 0;
+        projection.ProjectBlockwise(numberOfSpectra, [&](unsigned begin, unsigned end, DataType *buffer)
+        {
+            maxRead = std::max(maxRead, end - begin);
+            std::copy(spectra.begin() + begin * size, spectra.begin() + end * size, buffer);
+        }, &features[0], blockSize);
+
+        EXPECT_LE(maxRead, blockSize);
+        for (unsigned i = 0; i < features.size(); i++)
+        {
+            EXPECT_EQ(features[i], expected[i]) << "block size " << blockSize;
+        }
+    }
+}
+
+TEST_F(FeatureProjectionTest, projects_onto_fitted_model)
+{
+    std::vector<DataType> meanSpectrum(mzs.size(), 1.0);
+    GaussianMixtureModel model(mzs, meanSpectrum, std::vector<GaussianComponent>(gaussianComponents));
+    FeatureProjection fromModel(model);
+    FeatureProjection fromComponents(&mzs[0], (unsigned)mzs.size(), gaussianComponents);
+    std::vector<DataType> expected(numberOfSpectra * gaussianComponents.size());
+    std::vector<DataType> actual(numberOfSpectra * gaussianComponents.size());
+
+    fromComponents.Project(&spectra[0], numberOfSpectra, &expected[0]);
+    fromModel.Project(&spectra[0], numberOfSpectra, &actual[0]);
+
+    EXPECT_EQ(fromModel.SpectrumLength(), mzs.size());
+    EXPECT_EQ(actual, expected);
+}
+
+TEST_F(FeatureProjectionTest, throws_on_invalid_arguments)
+{
+    const unsigned size = (unsigned)mzs.size();
+    std::vector<DataType> features(numberOfSpectra * gaussianComponents.size());
+
+    EXPECT_THROW(FeatureProjection(nullptr, size, gaussianComponents), spectre::core::exception::NullPointerException);
+    EXPECT_THROW(FeatureProjection(&mzs[0], size, gaussianComponents, 0.0),
+                 spectre::core::exception::ArgumentOutOfRangeException<DataType>);
+    FeatureProjection projection(&mzs[0], size, gaussianComponents);
+    EXPECT_THROW(projection.Project(nullptr, numberOfSpectra, &features[0]), spectre::core::exception::NullPointerException);
+    EXPECT_THROW(projection.Project(&spectra[0], numberOfSpectra, nullptr), spectre::core::exception::NullPointerException);
+    EXPECT_THROW(projection.ProjectBlockwise(numberOfSpectra, [](unsigned, unsigned, DataType *) {}, &features[0], 0),
+                 spectre::core::exception::ArgumentOutOfRangeException<unsigned>);
+}
+}
@@ -0,0 +1,215 @@
+/*
+* FusedExpectationMaximizationTest.cpp
+* Provides implementation of tests checking that single pass iterations
+* of Expectation Maximization algorithm match the reference runners.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <gtest/gtest.h>
+#include "ExpectationMaximization.h"
+#include "FusedExpectationMaximization.h"
+#include "FusedIterationRunner.h"
+#include "RandomInitializationRef.h"
+#include "StreamingIterationRunner.h"
+#include "ExpectationRunnerRef.h"
+#include "MaximizationRunnerRef.h"
+#include "LogLikelihoodCalculator.h"
+
+namespace spectre::unsupervised::gmm
+{
+class FusedExpectationMaximizationTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ 995.0, /*deviation =*/ 3.0, /*weight =*/ 0.25 },
+            { /*mean =*/ 1005.0,/*deviation =*/ 3.0, /*weight =*/ 0.25 },
+            { /*mean =*/ 998.0, /*deviation =*/ 9.0, /*weight =*/ 0.5 }
+        };
+
+        // m/z far from zero, where raw second moments would lose precision
+        const unsigned size = 3000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = 980.0 + step * i;
+            intensities[i] = 1e-6;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+        // start away from the optimum, so that the iteration moves components
+        gaussianComponents[0].mean = 993.0;
+        gaussianComponents[1].deviation = 4.0;
+        gaussianComponents[2].weight = 0.4;
+    }
+
+    // Sets intensities of the first and the last margin points to zero.
+    void UseZeroBaseline(unsigned margin)
+    {
+        std::fill(intensities.begin(), intensities.begin() + margin, 0.0);
+        std::fill(intensities.end() - margin, intensities.end(), 0.0);
+    }
+};
+
+TEST_F(FusedExpectationMaximizationTest, iteration_matches_reference_steps)
+{
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    std::vector<GaussianComponent> referenceComponents = gaussianComponents;
+    std::vector<GaussianComponent> fusedComponents = gaussianComponents;
+
+    const DataType expectedLikelihood =
+        LogLikelihoodCalculator(&mzs[0], &intensities[0], size, referenceComponents).CalculateLikelihood();
+    Matrix affilationMatrix(numberOfComponents, size);
+    ExpectationRunnerRef(&mzs[0], size, affilationMatrix, referenceComponents).Expectation();
+    MaximizationRunnerRef maximization(&mzs[0], &intensities[0], size, affilationMatrix, referenceComponents);
+    maximization.UpdateWeights();
+    maximization.UpdateMeans();
+    maximization.UpdateStdDeviations();
+
+    FusedIterationRunner fused(&mzs[0], &intensities[0], size, fusedComponents);
+    const DataType likelihood = fused.Iterate();
+
+    EXPECT_NEAR(likelihood, expectedLikelihood, 1e-10 * fabs(expectedLikelihood));
+    for (unsigned k = 0; k < numberOfComponents; k++)
+    {
+        EXPECT_NEAR(fusedComponents[k].weight, referenceComponents[k].weight, 1e-12);
+        EXPECT_NEAR(fusedComponents[k].mean, referenceComponents[k].mean, 1e-9);
+        EXPECT_NEAR(fusedComponents[k].deviation, referenceComponents[k].deviation, 1e-9);
+    }
+}
+
+TEST_F(FusedExpectationMaximizationTest, streaming_iterations_match_sequential_ones)
+{
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    std::vector<GaussianComponent> sequentialComponents = gaussianComponents;
+    std::vector<GaussianComponent> streamingComponents = gaussianComponents;
+    FusedIterationRunner sequential(&mzs[0], &intensities[0], size, sequentialComponents);
+    StreamingIterationRunner streaming(&mzs[0], &intensities[0], size, streamingComponents, 7);
+
+    for (int iteration = 0; iteration < 10; iteration++)
+    {
+        const DataType expectedLikelihood = sequential.Iterate();
+        EXPECT_NEAR(streaming.Iterate(), expectedLikelihood, 1e-10 * fabs(expectedLikelihood));
+    }
+    for (unsigned k = 0; k < numberOfComponents; k++)
+    {
+        EXPECT_NEAR(streamingComponents[k].weight, sequentialComponents[k].weight, 1e-12);
+        EXPECT_NEAR(streamingComponents[k].mean, sequentialComponents[k].mean, 1e-9);
+        EXPECT_NEAR(streamingComponents[k].deviation, sequentialComponents[k].deviation, 1e-9);
+    }
+}
+
+TEST_F(FusedExpectationMaximizationTest, streaming_iterations_are_reproducible)
+{
+    const unsigned size = (unsigned)mzs.size();
+    std::vector<GaussianComponent> firstComponents = gaussianComponents;
+    std::vector<GaussianComponent> secondComponents = gaussianComponents;
+    StreamingIterationRunner first(&mzs[0], &intensities[0], size, firstComponents);
+    StreamingIterationRunner second(&mzs[0], &intensities[0], size, secondComponents);
+
+    for (int iteration = 0; iteration < 5; iteration++)
+    {
+        ASSERT_EQ(first.Iterate(), second.Iterate());
+    }
+}
+
+TEST_F(FusedExpectationMaximizationTest, throws_on_null_data)
+{
+    EXPECT_THROW(FusedIterationRunner(nullptr, &intensities[0], (unsigned)mzs.size(), gaussianComponents),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(FusedIterationRunner(&mzs[0], nullptr, (unsigned)mzs.size(), gaussianComponents),
+                 spectre::core::exception::NullPointerException);
+}
+
+TEST_F(FusedExpectationMaximizationTest, whole_em_matches_reference)
+{
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    RandomNumberGenerator referenceEngine(0);
+    RandomNumberGenerator fusedEngine(0);
+
+    ExpectationMaximization<
+        RandomInitializationRef,
+        ExpectationRunnerRef,
+        MaximizationRunnerRef,
+        LogLikelihoodCalculator
+    > reference(&mzs[0], &intensities[0], size, referenceEngine, numberOfComponents);
+    FusedExpectationMaximization<RandomInitializationRef> fused(&mzs[0], &intensities[0], size,
+                                                                fusedEngine, numberOfComponents);
+
+    GaussianMixtureModel expected = reference.EstimateGmm();
+    GaussianMixtureModel actual = fused.EstimateGmm();
+
+    ASSERT_EQ(actual.components.size(), expected.components.size());
+    for (unsigned k = 0; k < numberOfComponents; k++)
+    {
+        EXPECT_NEAR(actual.components[k].weight, expected.components[k].weight, 1e-4);
+        EXPECT_NEAR(actual.components[k].mean, expected.components[k].mean, 1e-3);
+        EXPECT_NEAR(actual.components[k].deviation, expected.components[k].deviation, 1e-3);
+    }
+}
+
+TEST_F(FusedExpectationMaximizationTest, iterations_skip_points_of_zero_intensity)
+{
+    const unsigned margin = 300;
+    UseZeroBaseline(margin);
+    const unsigned size = (unsigned)mzs.size();
+    std::vector<double> nonzeroMzs(mzs.begin() + margin, mzs.end() - margin);
+    std::vector<double> nonzeroIntensities(intensities.begin() + margin, intensities.end() - margin);
+    std::vector<GaussianComponent> expectedComponents = gaussianComponents;
+    std::vector<GaussianComponent> sequentialComponents = gaussianComponents;
+    std::vector<GaussianComponent> streamingComponents = gaussianComponents;
+    FusedIterationRunner expected(&nonzeroMzs[0], &nonzeroIntensities[0], (unsigned)nonzeroMzs.size(),
+                                  expectedComponents);
+    FusedIterationRunner sequential(&mzs[0], &intensities[0], size, sequentialComponents);
+    StreamingIterationRunner streaming(&mzs[0], &intensities[0], size, streamingComponents, 7);
+
+    for (int iteration = 0; iteration < 10; iteration++)
+    {
+        const DataType expectedLikelihood = expected.Iterate();
+        ASSERT_TRUE(std::isfinite(expectedLikelihood));
+        EXPECT_NEAR(sequential.Iterate(), expectedLikelihood, 1e-10 * fabs(expectedLikelihood));
+        EXPECT_NEAR(streaming.Iterate(), expectedLikelihood, 1e-10 * fabs(expectedLikelihood));
+    }
+}
+
+TEST_F(FusedExpectationMaximizationTest, whole_em_converges_with_zero_baseline)
+{
+    UseZeroBaseline(300);
+    RandomNumberGenerator rngEngine(0);
+    FusedExpectationMaximization<RandomInitializationRef> fused(&mzs[0], &intensities[0], (unsigned)mzs.size(),
+                                                                rngEngine, (unsigned)gaussianComponents.size());
+
+    fused.EstimateGmm();
+
+    const ConvergenceReport report = fused.GetConvergenceReport();
+    EXPECT_GT(report.iterations, 2u);
+    EXPECT_TRUE(std::isfinite(report.logLikelihood));
+}
+}
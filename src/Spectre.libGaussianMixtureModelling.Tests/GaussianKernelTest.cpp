@@ -0,0 +1,197 @@
+/*
+* GaussianKernelTest.cpp
+* Provides implementation of tests checking batch evaluation
+* of weighted Gaussian functions.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <gtest/gtest.h>
+#include "GaussianDistribution.h"
+#include "GaussianKernel.h"
+
+namespace spectre::unsupervised::gmm
+{
+class GaussianKernelTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<GaussianComponent> gaussianComponents;
+    GaussianKernelComponents kernelComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ 1000.0, /*deviation =*/ 0.5, /*weight =*/ 0.25 },
+            { /*mean =*/ 1003.0, /*deviation =*/ 2.0, /*weight =*/ 0.7 },
+            { /*mean =*/ 990.0, /*deviation =*/ 30.0, /*weight =*/ 0.05 }
+        };
+        kernelComponents.Assign(gaussianComponents);
+
+        // odd size, so that the vectorized code has a remainder to handle
+        const unsigned size = 1001;
+        mzs.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = 950.0 + 0.1 * i;
+        }
+    }
+
+    template <typename Kernel>
+    void ExpectMatchesGaussian(Kernel kernel)
+    {
+        const unsigned size = (unsigned)mzs.size();
+        std::vector<double> densities(size);
+        for (unsigned k = 0; k < gaussianComponents.size(); k++)
+        {
+            const GaussianComponent &component = gaussianComponents[k];
+            kernel(&mzs[0], size, kernelComponents.means[k], kernelComponents.inverseDeviations[k],
+                   kernelComponents.logNormalizers[k], &densities[0]);
+            for (unsigned i = 0; i < size; i++)
+            {
+                const double expected = component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+                EXPECT_NEAR(densities[i], expected, 1e-12 * expected + 1e-300);
+            }
+        }
+    }
+};
+
+TEST_F(GaussianKernelTest, precomputes_component_parameters)
+{
+    ASSERT_EQ(kernelComponents.Size(), gaussianComponents.size());
+    EXPECT_DOUBLE_EQ(kernelComponents.means[1], 1003.0);
+    EXPECT_DOUBLE_EQ(kernelComponents.inverseDeviations[1], 0.5);
+    EXPECT_NEAR(kernelComponents.logNormalizers[1], log(0.7 * Gaussian(1003.0, 1003.0, 2.0)), 1e-15);
+}
+
+TEST_F(GaussianKernelTest, scalar_kernel_matches_gaussian)
+{
+    ExpectMatchesGaussian(EvaluateGaussianScalar);
+}
+
+TEST_F(GaussianKernelTest, dispatched_kernel_matches_gaussian)
+{
+    ExpectMatchesGaussian([](const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                             DataType logNormalizer, DataType *densities)
+    {
+        EvaluateGaussian(mzArray, count, mean, inverseDeviation, logNormalizer, densities);
+    });
+}
+
+TEST_F(GaussianKernelTest, avx2_kernel_matches_gaussian)
+{
+    if (!IsAvx2Supported())
+    {
+        return; // nothing to test on this processor
+    }
+    ExpectMatchesGaussian(EvaluateGaussianAvx2);
+}
+
+TEST_F(GaussianKernelTest, avx512_kernel_matches_gaussian)
+{
+    if (!IsAvx512Supported())
+    {
+        return; // nothing to test on this processor
+    }
+    ExpectMatchesGaussian(EvaluateGaussianAvx512);
+}
+
+TEST_F(GaussianKernelTest, single_precision_kernels_match_gaussian)
+{
+    // offsets from the first m/z value, as single precision m/z would lose the distances
+    const unsigned size = (unsigned)mzs.size();
+    std::vector<float> offsets(size);
+    for (unsigned i = 0; i < size; i++)
+    {
+        offsets[i] = (float)(mzs[i] - mzs[0]);
+    }
+    std::vector<float> densities(size);
+    std::vector<float> dispatchedDensities(size);
+    std::vector<float> avx2Densities(size);
+    std::vector<float> avx512Densities(size);
+    for (unsigned k = 0; k < gaussianComponents.size(); k++)
+    {
+        const GaussianComponent &component = gaussianComponents[k];
+        const float mean = (float)(kernelComponents.means[k] - mzs[0]);
+        const float inverseDeviation = (float)kernelComponents.inverseDeviations[k];
+        const float logNormalizer = (float)kernelComponents.logNormalizers[k];
+        EvaluateGaussianFloatScalar(&offsets[0], size, mean, inverseDeviation, logNormalizer, &densities[0]);
+        EvaluateGaussian(&offsets[0], size, mean, inverseDeviation, logNormalizer, &dispatchedDensities[0]);
+        if (IsAvx2Supported())
+        {
+            EvaluateGaussianFloatAvx2(&offsets[0], size, mean, inverseDeviation, logNormalizer, &avx2Densities[0]);
+        }
+        if (IsAvx512Supported())
+        {
+            EvaluateGaussianFloatAvx512(&offsets[0], size, mean, inverseDeviation, logNormalizer,
+                                        &avx512Densities[0]);
+        }
+        for (unsigned i = 0; i < size; i++)
+        {
+            const double expected = component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            // relative error grows with the exponent, up to about 87 before flushing to zero
+            const double tolerance = 1e-4 * expected + 1e-37;
+            EXPECT_NEAR(densities[i], expected, tolerance);
+            EXPECT_NEAR(dispatchedDensities[i], expected, tolerance);
+            if (IsAvx2Supported())
+            {
+                EXPECT_NEAR(avx2Densities[i], expected, tolerance);
+            }
+            if (IsAvx512Supported())
+            {
+                EXPECT_NEAR(avx512Densities[i], expected, tolerance);
+            }
+        }
+    }
+}
+
+TEST_F(GaussianKernelTest, kernel_handles_extreme_exponents)
+{
+    const unsigned size = 9;
+    const double standardizedDistances[size] = { 0.0, 1.0, 10.0, 30.0, 37.0, 38.0, 39.0, 1e3, 1e200 };
+    std::vector<double> distantMzs(size);
+    for (unsigned i = 0; i < size; i++)
+    {
+        distantMzs[i] = standardizedDistances[i];
+    }
+    std::vector<double> densities(size, -1.0);
+
+    EvaluateGaussian(&distantMzs[0], size, 0.0, 1.0, 0.0, &densities[0]);
+
+    for (unsigned i = 0; i < size; i++)
+    {
+        const double expected = exp(-0.5 * standardizedDistances[i] * standardizedDistances[i]);
+        EXPECT_GE(densities[i], 0.0);
+        EXPECT_NEAR(densities[i], expected, 1e-12 * expected + 1e-300);
+    }
+}
+
+TEST_F(GaussianKernelTest, zero_weight_component_has_zero_density)
+{
+    std::vector<GaussianComponent> components = { { /*mean =*/ 1000.0, /*deviation =*/ 1.0, /*weight =*/ 0.0 } };
+    GaussianKernelComponents parameters;
+    parameters.Assign(components);
+    std::vector<double> densities(mzs.size(), -1.0);
+
+    EvaluateGaussian(&mzs[0], (unsigned)mzs.size(), parameters, 0, &densities[0]);
+
+    for (double density : densities)
+    {
+        EXPECT_EQ(density, 0.0);
+    }
+}
+}
@@ -0,0 +1,120 @@
+/*
+* GaussianMixtureModelSerializationTest.cpp
+* Provides implementation of tests checking saving and loading
+* of Gaussian Mixture Models.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <limits>
+#include <sstream>
+#include <gtest/gtest.h>
+#include "Spectre.libException/CorruptedDataException.h"
+#include "GaussianMixtureModelSerialization.h"
+
+namespace spectre::unsupervised::gmm
+{
+class GaussianMixtureModelSerializationTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs = { 1.0, 2.0, 3.0, 4.0 };
+    std::vector<double> intensities = { 0.1, 0.7, 0.3, 1.0 / 3.0 };
+    std::vector<GaussianComponent> components = {
+        { /*mean =*/ 1.5, /*deviation =*/ 0.25, /*weight =*/ 0.4 },
+        { /*mean =*/ 3.1, /*deviation =*/ 1.0 / 7.0, /*weight =*/ 0.6 }
+    };
+
+    GaussianMixtureModel Model()
+    {
+        return GaussianMixtureModel(
+            gsl::span<double>(mzs.data(), (std::ptrdiff_t)mzs.size()),
+            gsl::span<double>(intensities.data(), (std::ptrdiff_t)intensities.size()),
+            std::vector<GaussianComponent>(components), 0.5, true, false
+        );
+    }
+
+    std::string Binary()
+    {
+        std::ostringstream stream(std::ios::binary);
+        WriteBinary(Model(), stream);
+        return stream.str();
+    }
+};
+
+TEST_F(GaussianMixtureModelSerializationTest, binary_format_restores_model_exactly)
+{
+    std::istringstream stream(Binary(), std::ios::binary);
+
+    const GaussianMixtureModel model = ReadBinary(stream);
+
+    EXPECT_EQ(model.originalMzArray, mzs);
+    EXPECT_EQ(model.originalMeanSpectrum, intensities);
+    ASSERT_EQ(model.components.size(), components.size());
+    for (unsigned k = 0; k < components.size(); k++)
+    {
+        EXPECT_EQ(model.components[k].mean, components[k].mean);
+        EXPECT_EQ(model.components[k].deviation, components[k].deviation);
+        EXPECT_EQ(model.components[k].weight, components[k].weight);
+    }
+    EXPECT_EQ(model.mzMergingThreshold, 0.5);
+    EXPECT_TRUE(model.isMerged);
+    EXPECT_FALSE(model.isNoiseReduced);
+}
+
+TEST_F(GaussianMixtureModelSerializationTest, binary_format_is_compact)
+{
+    // tag, version, flags and lengths of the arrays
+    const size_t header = 4 + sizeof(uint32_t) + 2 + 3 * sizeof(uint64_t);
+    const size_t payload = (2 * mzs.size() + 3 * components.size() + 1) * sizeof(double);
+
+    EXPECT_EQ(Binary().size(), header + payload);
+}
+
+TEST_F(GaussianMixtureModelSerializationTest, throws_on_corrupted_stream)
+{
+    const std::string binary = Binary();
+    std::string otherTag = binary;
+    otherTag[0] = 'X';
+    std::string otherVersion = binary;
+    otherVersion[4] = 2;
+    std::istringstream truncated(binary.substr(0, binary.size() - 1), std::ios::binary);
+    std::istringstream tagged(otherTag, std::ios::binary);
+    std::istringstream versioned(otherVersion, std::ios::binary);
+    std::istringstream empty("", std::ios::binary);
+
+    EXPECT_THROW(ReadBinary(truncated), spectre::core::exception::CorruptedDataException);
+    EXPECT_THROW(ReadBinary(tagged), spectre::core::exception::CorruptedDataException);
+    EXPECT_THROW(ReadBinary(versioned), spectre::core::exception::CorruptedDataException);
+    EXPECT_THROW(ReadBinary(empty), spectre::core::exception::CorruptedDataException);
+}
+
+TEST_F(GaussianMixtureModelSerializationTest, json_lists_all_fields)
+{
+    components[1].weight = std::numeric_limits<double>::quiet_NaN();
+    std::ostringstream stream;
+
+    WriteJson(Model(), stream);
+
+    EXPECT_EQ(stream.str(),
+              "{\"isMerged\":true,\"isNoiseReduced\":false,\"mzMergingThreshold\":0.5,"
+              "\"components\":[{\"mean\":1.5,\"deviation\":0.25,\"weight\":0.40000000000000002},"
+              "{\"mean\":3.1000000000000001,\"deviation\":0.14285714285714285,\"weight\":null}],"
+              "\"originalMzArray\":[1,2,3,4],"
+              "\"originalMeanSpectrum\":[0.10000000000000001,0.69999999999999996,0.29999999999999999,"
+              "0.33333333333333331]}");
+}
+}
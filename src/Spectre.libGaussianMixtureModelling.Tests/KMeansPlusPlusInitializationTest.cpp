@@ -0,0 +1,174 @@
+/*
+* KMeansPlusPlusInitializationTest.cpp
+* Provides implementation of tests checking k-means++ initialization
+* of Expectation Maximization algorithm.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "Spectre.libException/NullPointerException.h"
+#include "ExpectationMaximization.h"
+#include "ExpectationRunnerOpt.h"
+#include "GaussianDistribution.h"
+#include "KMeansPlusPlusInitialization.h"
+#include "LogLikelihoodCalculatorOpt.h"
+#include "MaximizationRunnerOpt.h"
+
+namespace spectre::unsupervised::gmm
+{
+class KMeansPlusPlusInitializationTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ 510.0, /*deviation =*/ 1.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 520.0, /*deviation =*/ 1.5, /*weight =*/ 0.5 },
+            { /*mean =*/ 535.0, /*deviation =*/ 1.0, /*weight =*/ 0.2 }
+        };
+
+        const unsigned size = 2000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = 500.0 + step * i;
+            intensities[i] = 1e-6;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+    }
+
+    std::vector<GaussianComponent> Initialize(unsigned numberOfComponents, unsigned seed = 0)
+    {
+        std::vector<GaussianComponent> components(numberOfComponents);
+        RandomNumberGenerator rngEngine(seed);
+        KMeansPlusPlusInitialization initialization(&mzs[0], &intensities[0], (unsigned)mzs.size(),
+                                                    components, rngEngine);
+        initialization.AssignRandomMeans();
+        initialization.AssignVariances();
+        initialization.AssignWeights();
+        return components;
+    }
+};
+
+TEST_F(KMeansPlusPlusInitializationTest, places_components_at_separated_peaks)
+{
+    for (unsigned seed = 0; seed < 10; seed++)
+    {
+        std::vector<GaussianComponent> components = Initialize(3, seed);
+
+        for (unsigned k = 0; k < 3; k++)
+        {
+            EXPECT_NEAR(components[k].mean, gaussianComponents[k].mean, 0.1) << "seed " << seed;
+            EXPECT_NEAR(components[k].deviation, gaussianComponents[k].deviation, 0.1) << "seed " << seed;
+            EXPECT_NEAR(components[k].weight, gaussianComponents[k].weight, 0.01) << "seed " << seed;
+        }
+    }
+}
+
+TEST_F(KMeansPlusPlusInitializationTest, yields_valid_components_when_more_than_peaks)
+{
+    std::vector<GaussianComponent> components = Initialize(20);
+
+    DataType sum = 0.0;
+    for (unsigned k = 0; k < components.size(); k++)
+    {
+        EXPECT_GT(components[k].deviation, 0.0);
+        EXPECT_GT(components[k].weight, 0.0);
+        EXPECT_GE(components[k].mean, mzs.front());
+        EXPECT_LE(components[k].mean, mzs.back());
+        if (k > 0)
+        {
+            EXPECT_LE(components[k - 1].mean, components[k].mean);
+        }
+        sum += components[k].weight;
+    }
+    EXPECT_NEAR(sum, 1.0, 1e-12);
+}
+
+TEST_F(KMeansPlusPlusInitializationTest, does_not_depend_on_order_of_data)
+{
+    std::vector<GaussianComponent> expected = Initialize(5);
+    std::reverse(mzs.begin(), mzs.end());
+    std::reverse(intensities.begin(), intensities.end());
+
+    std::vector<GaussianComponent> actual = Initialize(5);
+
+    for (unsigned k = 0; k < expected.size(); k++)
+    {
+        EXPECT_EQ(actual[k].mean, expected[k].mean);
+        EXPECT_EQ(actual[k].deviation, expected[k].deviation);
+        EXPECT_EQ(actual[k].weight, expected[k].weight);
+    }
+}
+
+TEST_F(KMeansPlusPlusInitializationTest, handles_zero_intensities)
+{
+    std::fill(intensities.begin(), intensities.end(), 0.0);
+
+    std::vector<GaussianComponent> components = Initialize(3);
+
+    for (const GaussianComponent &component : components)
+    {
+        EXPECT_GT(component.deviation, 0.0);
+        EXPECT_DOUBLE_EQ(component.weight, 1.0 / 3.0);
+    }
+}
+
+TEST_F(KMeansPlusPlusInitializationTest, plugs_into_expectation_maximization)
+{
+    const unsigned size = (unsigned)mzs.size();
+    RandomNumberGenerator rngEngine(0);
+    ExpectationMaximization<
+        KMeansPlusPlusInitialization,
+        ExpectationRunnerOpt,
+        MaximizationRunnerOpt,
+        LogLikelihoodCalculatorOpt
+    > em(&mzs[0], &intensities[0], size, rngEngine, 3);
+
+    GaussianMixtureModel model = em.EstimateGmm();
+
+    for (unsigned k = 0; k < 3; k++)
+    {
+        EXPECT_NEAR(model.components[k].mean, gaussianComponents[k].mean, 1e-3);
+        EXPECT_NEAR(model.components[k].deviation, gaussianComponents[k].deviation, 1e-3);
+        EXPECT_NEAR(model.components[k].weight, gaussianComponents[k].weight, 1e-3);
+    }
+}
+
+TEST_F(KMeansPlusPlusInitializationTest, throws_on_null_data)
+{
+    std::vector<GaussianComponent> components(3);
+    RandomNumberGenerator rngEngine(0);
+    const unsigned size = (unsigned)mzs.size();
+
+    EXPECT_THROW(KMeansPlusPlusInitialization(nullptr, &intensities[0], size, components, rngEngine),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(KMeansPlusPlusInitialization(&mzs[0], nullptr, size, components, rngEngine),
+                 spectre::core::exception::NullPointerException);
+}
+}
@@ -0,0 +1,213 @@
+/*
+* LogSpaceRunnersTest.cpp
+* Provides implementation of tests checking runners of Expectation
+* Maximization algorithm operating in log domain.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <gtest/gtest.h>
+#include "ExpectationMaximization.h"
+#include "ExpectationRunnerLog.h"
+#include "ExpectationRunnerRef.h"
+#include "GaussianDistribution.h"
+#include "LogLikelihoodCalculator.h"
+#include "LogLikelihoodCalculatorLog.h"
+#include "MaximizationRunnerOpt.h"
+#include "MaximizationRunnerRef.h"
+#include "RandomInitializationRef.h"
+
+namespace spectre::unsupervised::gmm
+{
+class LogSpaceRunnersTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/-5.0, /*deviation =*/ 3.0, /*weight =*/ 0.25 },
+            { /*mean =*/ 5.0, /*deviation =*/ 3.0, /*weight =*/ 0.25 },
+            { /*mean =*/ -2.0,/*deviation =*/ 9.0, /*weight =*/ 0.5 }
+        };
+
+        const unsigned size = 1000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = -20.0 + step * i;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+    }
+
+    // Narrow components, densities of which underflow to zero over most of the m/z range.
+    void UseNarrowComponents()
+    {
+        gaussianComponents = {
+            { /*mean =*/ -19.0, /*deviation =*/ 0.01, /*weight =*/ 0.5 },
+            { /*mean =*/ -18.0, /*deviation =*/ 0.01, /*weight =*/ 0.5 }
+        };
+    }
+};
+
+TEST_F(LogSpaceRunnersTest, expectation_matches_reference)
+{
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    Matrix reference(numberOfComponents, size);
+    Matrix logSpace(numberOfComponents, size);
+
+    ExpectationRunnerRef(&mzs[0], size, reference, gaussianComponents).Expectation();
+    ExpectationRunnerLog(&mzs[0], size, logSpace, gaussianComponents).Expectation();
+
+    for (unsigned i = 0; i < size; i++)
+    {
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            EXPECT_NEAR(logSpace(k, i), reference(k, i), 1e-12);
+        }
+    }
+}
+
+TEST_F(LogSpaceRunnersTest, loglikelihood_matches_reference)
+{
+    const unsigned size = (unsigned)mzs.size();
+    LogLikelihoodCalculator reference(&mzs[0], &intensities[0], size, gaussianComponents);
+    LogLikelihoodCalculatorLog logSpace(&mzs[0], &intensities[0], size, gaussianComponents);
+
+    const DataType expected = reference.CalculateLikelihood();
+    EXPECT_NEAR(logSpace.CalculateLikelihood(), expected, 1e-10 * fabs(expected));
+}
+
+TEST_F(LogSpaceRunnersTest, reference_runners_break_far_from_narrow_components)
+{
+    UseNarrowComponents();
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    Matrix affilationMatrix(numberOfComponents, size);
+
+    ExpectationRunnerRef(&mzs[0], size, affilationMatrix, gaussianComponents).Expectation();
+    const DataType likelihood =
+        LogLikelihoodCalculator(&mzs[0], &intensities[0], size, gaussianComponents).CalculateLikelihood();
+
+    EXPECT_TRUE(std::isnan(affilationMatrix(0, size - 1)));
+    EXPECT_FALSE(std::isfinite(likelihood));
+}
+
+TEST_F(LogSpaceRunnersTest, expectation_is_finite_far_from_narrow_components)
+{
+    UseNarrowComponents();
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    Matrix affilationMatrix(numberOfComponents, size);
+
+    ExpectationRunnerLog(&mzs[0], size, affilationMatrix, gaussianComponents).Expectation();
+
+    for (unsigned i = 0; i < size; i++)
+    {
+        DataType sum = 0.0;
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            ASSERT_TRUE(std::isfinite(affilationMatrix(k, i))) << "point " << i << ", component " << k;
+            sum += affilationMatrix(k, i);
+        }
+        EXPECT_NEAR(sum, 1.0, 1e-12);
+    }
+    // points right of both components belong to the closer one
+    EXPECT_NEAR(affilationMatrix(1, size - 1), 1.0, 1e-12);
+    EXPECT_NEAR(affilationMatrix(0, 0), 1.0, 1e-12);
+}
+
+TEST_F(LogSpaceRunnersTest, loglikelihood_is_finite_far_from_narrow_components)
+{
+    UseNarrowComponents();
+    const unsigned size = (unsigned)mzs.size();
+    intensities[size / 2] = 0.0;
+    LogLikelihoodCalculatorLog logSpace(&mzs[0], &intensities[0], size, gaussianComponents);
+
+    const DataType likelihood = logSpace.CalculateLikelihood();
+
+    EXPECT_TRUE(std::isfinite(likelihood));
+    // m/z = 20 is 3800 deviations from the closer component
+    const DataType farthest = log(0.5 / (sqrt(2.0 * 3.14159265358979323846) * 0.01)) - 0.5 * 3800.0 * 3800.0;
+    EXPECT_LT(likelihood, farthest);
+}
+
+TEST_F(LogSpaceRunnersTest, whole_em_matches_reference)
+{
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    RandomNumberGenerator referenceEngine(0);
+    RandomNumberGenerator logSpaceEngine(0);
+
+    ExpectationMaximization<
+        RandomInitializationRef,
+        ExpectationRunnerRef,
+        MaximizationRunnerRef,
+        LogLikelihoodCalculator
+    > reference(&mzs[0], &intensities[0], size, referenceEngine, numberOfComponents);
+    ExpectationMaximization<
+        RandomInitializationRef,
+        ExpectationRunnerLog,
+        MaximizationRunnerOpt,
+        LogLikelihoodCalculatorLog
+    > logSpace(&mzs[0], &intensities[0], size, logSpaceEngine, numberOfComponents);
+
+    GaussianMixtureModel expected = reference.EstimateGmm();
+    GaussianMixtureModel actual = logSpace.EstimateGmm();
+
+    ASSERT_EQ(actual.components.size(), expected.components.size());
+    for (unsigned k = 0; k < numberOfComponents; k++)
+    {
+        EXPECT_NEAR(actual.components[k].weight, expected.components[k].weight, 1e-4);
+        EXPECT_NEAR(actual.components[k].mean, expected.components[k].mean, 1e-3);
+        EXPECT_NEAR(actual.components[k].deviation, expected.components[k].deviation, 1e-3);
+    }
+}
+
+TEST_F(LogSpaceRunnersTest, whole_em_skips_points_of_zero_intensity)
+{
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    intensities[size / 2] = 0.0;
+    RandomNumberGenerator rngEngine(0);
+
+    ExpectationMaximization<
+        RandomInitializationRef,
+        ExpectationRunnerLog,
+        MaximizationRunnerOpt,
+        LogLikelihoodCalculatorLog
+    > logSpace(&mzs[0], &intensities[0], size, rngEngine, numberOfComponents);
+
+    GaussianMixtureModel model = logSpace.EstimateGmm();
+
+    EXPECT_GT(logSpace.GetConvergenceReport().iterations, 1u);
+    for (const auto &component : model.components)
+    {
+        EXPECT_TRUE(std::isfinite(component.mean));
+        EXPECT_TRUE(std::isfinite(component.deviation));
+    }
+}
+}
@@ -0,0 +1,122 @@
+/*
+* MatrixTest.cpp
+* Provides implementation of tests checking layouts, alignment
+* and ownership of Matrix.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "Matrix.h"
+
+namespace spectre::unsupervised::gmm
+{
+namespace
+{
+// odd dimensions, so that rows and columns need padding to stay aligned
+constexpr unsigned HEIGHT = 5;
+constexpr unsigned WIDTH = 13;
+
+void Fill(Matrix &matrix)
+{
+    for (unsigned row = 0; row < matrix.Height(); row++)
+    {
+        for (unsigned column = 0; column < matrix.Width(); column++)
+        {
+            matrix(row, column) = 100.0 * row + column;
+        }
+    }
+}
+
+bool IsAligned(const DataType *pointer)
+{
+    return reinterpret_cast<uintptr_t>(pointer) % MATRIX_ALIGNMENT == 0;
+}
+}
+
+TEST(MatrixTest, row_major_rows_are_contiguous_and_aligned)
+{
+    Matrix matrix(HEIGHT, WIDTH, MatrixLayout::RowMajor);
+    Fill(matrix);
+
+    for (unsigned row = 0; row < HEIGHT; row++)
+    {
+        const gsl::span<DataType> elements = matrix.Row(row);
+        ASSERT_EQ((unsigned)elements.size(), WIDTH);
+        EXPECT_TRUE(IsAligned(elements.data()));
+        for (unsigned column = 0; column < WIDTH; column++)
+        {
+            EXPECT_EQ(elements[column], 100.0 * row + column);
+            EXPECT_EQ(&matrix.At<MatrixLayout::RowMajor>(row, column), &elements[column]);
+        }
+    }
+}
+
+TEST(MatrixTest, column_major_columns_are_contiguous_and_aligned)
+{
+    Matrix matrix(HEIGHT, WIDTH, MatrixLayout::ColumnMajor);
+    Fill(matrix);
+
+    for (unsigned column = 0; column < WIDTH; column++)
+    {
+        const gsl::span<DataType> elements = matrix.Column(column);
+        ASSERT_EQ((unsigned)elements.size(), HEIGHT);
+        EXPECT_TRUE(IsAligned(elements.data()));
+        for (unsigned row = 0; row < HEIGHT; row++)
+        {
+            EXPECT_EQ(elements[row], 100.0 * row + column);
+            EXPECT_EQ(&matrix.At<MatrixLayout::ColumnMajor>(row, column), &elements[row]);
+        }
+    }
+}
+
+TEST(MatrixTest, elements_do_not_overlap)
+{
+    for (MatrixLayout layout : { MatrixLayout::RowMajor, MatrixLayout::ColumnMajor })
+    {
+        Matrix matrix(HEIGHT, WIDTH, layout);
+        Fill(matrix);
+
+        for (unsigned row = 0; row < HEIGHT; row++)
+        {
+            for (unsigned column = 0; column < WIDTH; column++)
+            {
+                EXPECT_EQ(matrix(row, column), 100.0 * row + column);
+            }
+        }
+    }
+}
+
+TEST(MatrixTest, move_transfers_data)
+{
+    Matrix source(HEIGHT, WIDTH, MatrixLayout::RowMajor);
+    Fill(source);
+    const DataType *data = source.Row(0).data();
+
+    Matrix moved(std::move(source));
+    Matrix assigned(1, 1, MatrixLayout::ColumnMajor);
+    assigned = std::move(moved);
+
+    EXPECT_EQ(source.Height(), 0u);
+    EXPECT_EQ(moved.Width(), 0u);
+    ASSERT_EQ(assigned.Height(), HEIGHT);
+    ASSERT_EQ(assigned.Width(), WIDTH);
+    EXPECT_EQ(assigned.Layout(), MatrixLayout::RowMajor);
+    EXPECT_EQ(assigned.Row(0).data(), data);
+    EXPECT_EQ(assigned(HEIGHT - 1, WIDTH - 1), 100.0 * (HEIGHT - 1) + WIDTH - 1);
+}
+}
@@ -0,0 +1,263 @@
+/*
+* ModelSelectionTest.cpp
+* Provides implementation of tests checking selection of number of
+* components of Gaussian Mixture Model.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <gtest/gtest.h>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "FusedIterationRunner.h"
+#include "GaussianDistribution.h"
+#include "ModelSelection.h"
+#include "WeightedLogLikelihoodCalculator.h"
+
+namespace spectre::unsupervised::gmm
+{
+// Iteration runner counting the iterations of all its instances.
+class CountingIterationRunner : public FusedIterationRunner
+{
+public:
+    using FusedIterationRunner::FusedIterationRunner;
+
+    DataType Iterate() override
+    {
+        iterations++;
+        return FusedIterationRunner::Iterate();
+    }
+
+    static unsigned iterations;
+};
+
+unsigned CountingIterationRunner::iterations = 0;
+
+// Iteration runner breaking models of two components, so that neither
+// their likelihood, nor their score is finite.
+class NotFiniteIterationRunner : public CountingIterationRunner
+{
+public:
+    using CountingIterationRunner::CountingIterationRunner;
+
+    DataType Iterate() override
+    {
+        const DataType likelihood = CountingIterationRunner::Iterate();
+        if (m_Components.size() != 2)
+        {
+            return likelihood;
+        }
+        for (auto &component : m_Components)
+        {
+            component.mean = NAN;
+        }
+        return NAN;
+    }
+};
+
+class ModelSelectionTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ 10.0, /*deviation =*/ 1.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 20.0, /*deviation =*/ 2.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 35.0, /*deviation =*/ 1.5, /*weight =*/ 0.4 }
+        };
+
+        const unsigned size = 1000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = step * i;
+            intensities[i] = 1e-6;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+    }
+};
+
+TEST_F(ModelSelectionTest, selects_true_number_of_components)
+{
+    const unsigned size = (unsigned)mzs.size();
+    for (unsigned chains = 1; chains <= 6; chains++)
+    {
+        ModelSelection<> selection(&mzs[0], &intensities[0], size, InformationCriterion::Bayesian, chains);
+
+        ModelSelectionResult result = selection.SelectModel(1, 6, 0);
+
+        ASSERT_EQ(result.model.components.size(), 3u) << chains << " chains";
+        for (unsigned k = 0; k < 3; k++)
+        {
+            EXPECT_NEAR(result.model.components[k].mean, gaussianComponents[k].mean, 1e-2);
+        }
+    }
+}
+
+TEST_F(ModelSelectionTest, scores_follow_criterion_formula)
+{
+    const unsigned size = (unsigned)mzs.size();
+    ModelSelection<> bayesian(&mzs[0], &intensities[0], size, InformationCriterion::Bayesian, 2);
+    ModelSelection<> akaike(&mzs[0], &intensities[0], size, InformationCriterion::Akaike, 2);
+
+    ModelSelectionResult bayesianResult = bayesian.SelectModel(2, 5, 0);
+    ModelSelectionResult akaikeResult = akaike.SelectModel(2, 5, 0);
+
+    ASSERT_EQ(bayesianResult.scores.size(), 4u);
+    ASSERT_EQ(akaikeResult.scores.size(), 4u);
+    for (unsigned i = 0; i < 4; i++)
+    {
+        const ModelScore &score = bayesianResult.scores[i];
+        const DataType parameters = 3.0 * score.numberOfComponents - 1.0;
+        EXPECT_EQ(score.numberOfComponents, i + 2);
+        EXPECT_DOUBLE_EQ(score.score, parameters * log((DataType)size) - 2.0 * score.logLikelihood);
+        EXPECT_EQ(akaikeResult.scores[i].logLikelihood, score.logLikelihood);
+        EXPECT_DOUBLE_EQ(akaikeResult.scores[i].score, 2.0 * parameters - 2.0 * score.logLikelihood);
+    }
+}
+
+TEST_F(ModelSelectionTest, selected_model_has_lowest_score)
+{
+    ModelSelection<> selection(&mzs[0], &intensities[0], (unsigned)mzs.size(), InformationCriterion::Akaike, 3);
+
+    ModelSelectionResult result = selection.SelectModel(1, 8, 1);
+
+    for (const ModelScore &score : result.scores)
+    {
+        if (score.numberOfComponents == result.model.components.size())
+        {
+            for (const ModelScore &other : result.scores)
+            {
+                EXPECT_LE(score.score, other.score);
+            }
+            return;
+        }
+    }
+    FAIL() << "selected model not scored";
+}
+
+TEST_F(ModelSelectionTest, cold_fits_do_not_depend_on_range)
+{
+    const unsigned size = (unsigned)mzs.size();
+    // as many chains as models, so that every model is fitted cold
+    ModelSelection<> narrow(&mzs[0], &intensities[0], size, InformationCriterion::Bayesian, 2);
+    ModelSelection<> wide(&mzs[0], &intensities[0], size, InformationCriterion::Bayesian, 4);
+
+    ModelSelectionResult narrowResult = narrow.SelectModel(3, 4, 5);
+    ModelSelectionResult wideResult = wide.SelectModel(1, 4, 5);
+
+    ASSERT_EQ(wideResult.scores.size(), 4u);
+    EXPECT_EQ(narrowResult.scores[0].logLikelihood, wideResult.scores[2].logLikelihood);
+    EXPECT_EQ(narrowResult.scores[1].logLikelihood, wideResult.scores[3].logLikelihood);
+}
+
+TEST_F(ModelSelectionTest, fits_stop_after_max_iterations)
+{
+    const unsigned maxIterations = 3;
+    ModelSelection<KMeansPlusPlusInitialization, CountingIterationRunner> selection(
+        &mzs[0], &intensities[0], (unsigned)mzs.size(), InformationCriterion::Bayesian, 1, 0.0, maxIterations);
+    CountingIterationRunner::iterations = 0;
+
+    selection.SelectModel(2, 4, 0);
+
+    EXPECT_EQ(CountingIterationRunner::iterations, 3 * maxIterations);
+}
+
+TEST_F(ModelSelectionTest, skips_models_not_finite)
+{
+    // no limit of iterations, so that only likelihood not finite stops the fit
+    ModelSelection<KMeansPlusPlusInitialization, NotFiniteIterationRunner> selection(
+        &mzs[0], &intensities[0], (unsigned)mzs.size(), InformationCriterion::Bayesian, 3,
+        DEFAULT_SELECTION_TOLERANCE, 0);
+    ModelSelection<> reference(&mzs[0], &intensities[0], (unsigned)mzs.size(), InformationCriterion::Bayesian, 3,
+                               DEFAULT_SELECTION_TOLERANCE, 0);
+
+    ModelSelectionResult result = selection.SelectModel(2, 4, 0);
+    ModelSelectionResult expected = reference.SelectModel(2, 4, 0);
+
+    EXPECT_FALSE(isfinite(result.scores[0].score));
+    EXPECT_EQ(result.scores[1].score, expected.scores[1].score);
+    EXPECT_EQ(result.scores[2].score, expected.scores[2].score);
+    EXPECT_EQ(result.model.components.size(), 3u);
+}
+
+TEST_F(ModelSelectionTest, split_preserves_mixture_moments)
+{
+    const std::vector<GaussianComponent> split = ModelSelection<>::SplitWidestComponent(gaussianComponents);
+
+    ASSERT_EQ(split.size(), gaussianComponents.size() + 1);
+    DataType weights[2] = { 0.0, 0.0 };
+    DataType firstMoments[2] = { 0.0, 0.0 };
+    DataType secondMoments[2] = { 0.0, 0.0 };
+    for (const GaussianComponent &component : gaussianComponents)
+    {
+        weights[0] += component.weight;
+        firstMoments[0] += component.weight * component.mean;
+        secondMoments[0] += component.weight * (component.deviation * component.deviation + component.mean * component.mean);
+    }
+    for (const GaussianComponent &component : split)
+    {
+        weights[1] += component.weight;
+        firstMoments[1] += component.weight * component.mean;
+        secondMoments[1] += component.weight * (component.deviation * component.deviation + component.mean * component.mean);
+    }
+    EXPECT_NEAR(weights[1], weights[0], 1e-12);
+    EXPECT_NEAR(firstMoments[1], firstMoments[0], 1e-12);
+    EXPECT_NEAR(secondMoments[1], secondMoments[0], 1e-10);
+    // components stay ordered by mean
+    for (unsigned k = 1; k < split.size(); k++)
+    {
+        EXPECT_LT(split[k - 1].mean, split[k].mean);
+    }
+}
+
+TEST_F(ModelSelectionTest, throws_on_invalid_range)
+{
+    ModelSelection<> selection(&mzs[0], &intensities[0], (unsigned)mzs.size());
+
+    EXPECT_THROW(selection.SelectModel(0, 3, 0), spectre::core::exception::ArgumentOutOfRangeException<unsigned>);
+    EXPECT_THROW(selection.SelectModel(4, 3, 0), spectre::core::exception::ArgumentOutOfRangeException<unsigned>);
+}
+
+TEST_F(ModelSelectionTest, weighted_likelihood_penalizes_mass_outside_peaks)
+{
+    const unsigned size = (unsigned)mzs.size();
+    std::vector<GaussianComponent> fitting = gaussianComponents;
+    std::vector<GaussianComponent> withBackground = gaussianComponents;
+    for (GaussianComponent &component : withBackground)
+    {
+        component.weight *= 0.9;
+    }
+    // broad component covering m/z range, where intensities are negligible
+    withBackground.push_back({ /*mean =*/ 27.0, /*deviation =*/ 20.0, /*weight =*/ 0.1 });
+
+    const DataType fittingLikelihood =
+        WeightedLogLikelihoodCalculator(&mzs[0], &intensities[0], size, fitting).CalculateLikelihood();
+    const DataType backgroundLikelihood =
+        WeightedLogLikelihoodCalculator(&mzs[0], &intensities[0], size, withBackground).CalculateLikelihood();
+
+    EXPECT_GT(fittingLikelihood, backgroundLikelihood);
+}
+}
@@ -0,0 +1,153 @@
+/*
+* MultiStartExpectationMaximizationTest.cpp
+* Provides implementation of tests checking Expectation Maximization
+* algorithm restarted multiple times.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <gtest/gtest.h>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "FusedExpectationMaximization.h"
+#include "GaussianDistribution.h"
+#include "LogLikelihoodCalculatorLog.h"
+#include "MultiStartExpectationMaximization.h"
+#include "RandomInitializationRef.h"
+
+namespace spectre::unsupervised::gmm
+{
+class MultiStartExpectationMaximizationTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ 10.0, /*deviation =*/ 1.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 20.0, /*deviation =*/ 2.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 35.0, /*deviation =*/ 1.5, /*weight =*/ 0.4 }
+        };
+
+        const unsigned size = 1000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = step * i;
+            intensities[i] = 1e-6;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+    }
+};
+
+TEST_F(MultiStartExpectationMaximizationTest, picks_restart_of_highest_likelihood)
+{
+    const unsigned size = (unsigned)mzs.size();
+    MultiStartExpectationMaximization<> multiStart(&mzs[0], &intensities[0], size, 3);
+
+    MultiStartResult result = multiStart.EstimateGmmMultiStart(8, 0);
+
+    ASSERT_EQ(result.restarts.size(), 8u);
+    for (const RestartDiagnostics &restart : result.restarts)
+    {
+        EXPECT_LE(restart.logLikelihood, result.restarts[result.bestRestart].logLikelihood);
+    }
+    const DataType likelihood = LogLikelihoodCalculatorLog(&mzs[0], &intensities[0], size,
+                                                           result.model.components).CalculateLikelihood();
+    EXPECT_EQ(likelihood, result.restarts[result.bestRestart].logLikelihood);
+}
+
+TEST_F(MultiStartExpectationMaximizationTest, restarts_get_distinct_seeds)
+{
+    MultiStartExpectationMaximization<> multiStart(&mzs[0], &intensities[0], (unsigned)mzs.size(), 3);
+
+    MultiStartResult result = multiStart.EstimateGmmMultiStart(8, 0);
+
+    for (unsigned i = 0; i < result.restarts.size(); i++)
+    {
+        for (unsigned j = i + 1; j < result.restarts.size(); j++)
+        {
+            EXPECT_NE(result.restarts[i].seed, result.restarts[j].seed);
+        }
+    }
+}
+
+TEST_F(MultiStartExpectationMaximizationTest, result_is_reproducible)
+{
+    MultiStartExpectationMaximization<> multiStart(&mzs[0], &intensities[0], (unsigned)mzs.size(), 3);
+
+    MultiStartResult first = multiStart.EstimateGmmMultiStart(6, 42);
+    MultiStartResult second = multiStart.EstimateGmmMultiStart(6, 42);
+
+    EXPECT_EQ(first.bestRestart, second.bestRestart);
+    for (unsigned i = 0; i < first.restarts.size(); i++)
+    {
+        EXPECT_EQ(first.restarts[i].seed, second.restarts[i].seed);
+        EXPECT_EQ(first.restarts[i].logLikelihood, second.restarts[i].logLikelihood);
+    }
+    for (unsigned k = 0; k < first.model.components.size(); k++)
+    {
+        EXPECT_EQ(first.model.components[k].mean, second.model.components[k].mean);
+        EXPECT_EQ(first.model.components[k].deviation, second.model.components[k].deviation);
+        EXPECT_EQ(first.model.components[k].weight, second.model.components[k].weight);
+    }
+}
+
+TEST_F(MultiStartExpectationMaximizationTest, best_restart_is_reproducible_from_its_seed)
+{
+    const unsigned size = (unsigned)mzs.size();
+    MultiStartExpectationMaximization<> multiStart(&mzs[0], &intensities[0], size, 3);
+
+    MultiStartResult result = multiStart.EstimateGmmMultiStart(4, 7);
+    RandomNumberGenerator rngEngine(result.restarts[result.bestRestart].seed);
+    FusedExpectationMaximization<RandomInitializationRef> single(&mzs[0], &intensities[0], size, rngEngine, 3);
+    GaussianMixtureModel expected = single.EstimateGmm();
+
+    ASSERT_EQ(result.model.components.size(), expected.components.size());
+    for (unsigned k = 0; k < expected.components.size(); k++)
+    {
+        EXPECT_EQ(result.model.components[k].mean, expected.components[k].mean);
+        EXPECT_EQ(result.model.components[k].deviation, expected.components[k].deviation);
+        EXPECT_EQ(result.model.components[k].weight, expected.components[k].weight);
+    }
+}
+
+TEST_F(MultiStartExpectationMaximizationTest, throws_on_zero_restarts)
+{
+    MultiStartExpectationMaximization<> multiStart(&mzs[0], &intensities[0], (unsigned)mzs.size(), 3);
+
+    EXPECT_THROW(multiStart.EstimateGmmMultiStart(0, 0),
+                 spectre::core::exception::ArgumentOutOfRangeException<unsigned>);
+}
+
+TEST_F(MultiStartExpectationMaximizationTest, throws_on_null_data)
+{
+    const unsigned size = (unsigned)mzs.size();
+    EXPECT_THROW(MultiStartExpectationMaximization<>(nullptr, &intensities[0], size),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(MultiStartExpectationMaximization<>(&mzs[0], nullptr, size),
+                 spectre::core::exception::NullPointerException);
+}
+}
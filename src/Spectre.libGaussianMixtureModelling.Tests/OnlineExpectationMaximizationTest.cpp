@@ -0,0 +1,173 @@
+/*
+* OnlineExpectationMaximizationTest.cpp
+* Provides implementation of tests checking online variant of
+* Expectation Maximization algorithm.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <gtest/gtest.h>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "GaussianDistribution.h"
+#include "OnlineExpectationMaximization.h"
+
+namespace spectre::unsupervised::gmm
+{
+class OnlineExpectationMaximizationTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ 510.0, /*deviation =*/ 1.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 520.0, /*deviation =*/ 1.5, /*weight =*/ 0.5 },
+            { /*mean =*/ 535.0, /*deviation =*/ 1.0, /*weight =*/ 0.2 }
+        };
+
+        const unsigned size = 8000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities = std::vector<double>(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = 500.0 + step * i;
+        }
+        intensities = Generate(gaussianComponents);
+    }
+
+    std::vector<double> Generate(const std::vector<GaussianComponent> &components) const
+    {
+        std::vector<double> values(mzs.size(), 1e-6);
+        for (unsigned i = 0; i < mzs.size(); i++)
+        {
+            for (const auto &component : components)
+            {
+                values[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+        return values;
+    }
+
+    void ExpectNear(const std::vector<GaussianComponent> &actual, const std::vector<GaussianComponent> &expected,
+                    DataType tolerance) const
+    {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (unsigned k = 0; k < expected.size(); k++)
+        {
+            EXPECT_NEAR(actual[k].mean, expected[k].mean, tolerance);
+            EXPECT_NEAR(actual[k].deviation, expected[k].deviation, tolerance);
+            EXPECT_NEAR(actual[k].weight, expected[k].weight, tolerance);
+        }
+    }
+};
+
+TEST_F(OnlineExpectationMaximizationTest, random_order_recovers_components)
+{
+    RandomNumberGenerator rngEngine(0);
+    OnlineExpectationMaximization<> em(&mzs[0], &intensities[0], (unsigned)mzs.size(), rngEngine, 3, 256);
+
+    GaussianMixtureModel model = em.EstimateGmm(2);
+
+    EXPECT_EQ(em.GetNumberOfSteps(), 2u * 32u);
+    ExpectNear(model.components, gaussianComponents, 1e-2);
+}
+
+TEST_F(OnlineExpectationMaximizationTest, sequential_order_recovers_components)
+{
+    RandomNumberGenerator rngEngine(0);
+    OnlineExpectationMaximization<> em(&mzs[0], &intensities[0], (unsigned)mzs.size(), rngEngine, 3, 256,
+                                       DEFAULT_STEP_EXPONENT, BatchOrder::Sequential);
+
+    GaussianMixtureModel model = em.EstimateGmm(2);
+
+    ExpectNear(model.components, gaussianComponents, 1e-2);
+}
+
+TEST_F(OnlineExpectationMaximizationTest, update_follows_new_data)
+{
+    RandomNumberGenerator rngEngine(0);
+    OnlineExpectationMaximization<> em(&mzs[0], &intensities[0], (unsigned)mzs.size(), rngEngine, 3, 256);
+    em.EstimateGmm(1);
+    std::vector<GaussianComponent> shiftedComponents = gaussianComponents;
+    shiftedComponents[2].mean += 1.0;
+    const std::vector<double> shifted = Generate(shiftedComponents);
+
+    // new data arrives in interleaved batches
+    const unsigned numberOfBatches = 32;
+    std::vector<double> batchMzs;
+    std::vector<double> batchIntensities;
+    for (unsigned pass = 0; pass < 4; pass++)
+    {
+        for (unsigned batch = 0; batch < numberOfBatches; batch++)
+        {
+            batchMzs.clear();
+            batchIntensities.clear();
+            for (unsigned i = batch; i < mzs.size(); i += numberOfBatches)
+            {
+                batchMzs.push_back(mzs[i]);
+                batchIntensities.push_back(shifted[i]);
+            }
+            em.Update(&batchMzs[0], &batchIntensities[0], (unsigned)batchMzs.size());
+        }
+    }
+
+    EXPECT_EQ(em.GetNumberOfSteps(), 5u * numberOfBatches);
+    ExpectNear(em.GetComponents(), shiftedComponents, 5e-2);
+}
+
+TEST_F(OnlineExpectationMaximizationTest, is_reproducible_for_seed)
+{
+    RandomNumberGenerator firstEngine(3);
+    RandomNumberGenerator secondEngine(3);
+    OnlineExpectationMaximization<> first(&mzs[0], &intensities[0], (unsigned)mzs.size(), firstEngine, 3, 100);
+    OnlineExpectationMaximization<> second(&mzs[0], &intensities[0], (unsigned)mzs.size(), secondEngine, 3, 100);
+
+    GaussianMixtureModel firstModel = first.EstimateGmm(2);
+    GaussianMixtureModel secondModel = second.EstimateGmm(2);
+
+    for (unsigned k = 0; k < 3; k++)
+    {
+        EXPECT_EQ(firstModel.components[k].mean, secondModel.components[k].mean);
+        EXPECT_EQ(firstModel.components[k].deviation, secondModel.components[k].deviation);
+        EXPECT_EQ(firstModel.components[k].weight, secondModel.components[k].weight);
+    }
+}
+
+TEST_F(OnlineExpectationMaximizationTest, throws_on_invalid_arguments)
+{
+    RandomNumberGenerator rngEngine(0);
+    const unsigned size = (unsigned)mzs.size();
+
+    EXPECT_THROW(OnlineExpectationMaximization<>(nullptr, &intensities[0], size, rngEngine),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(OnlineExpectationMaximization<>(&mzs[0], nullptr, size, rngEngine),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(OnlineExpectationMaximization<>(&mzs[0], &intensities[0], size, rngEngine, 3, 0),
+                 spectre::core::exception::ArgumentOutOfRangeException<unsigned>);
+    EXPECT_THROW(OnlineExpectationMaximization<>(&mzs[0], &intensities[0], size, rngEngine, 3, 256, 0.5),
+                 spectre::core::exception::ArgumentOutOfRangeException<DataType>);
+    EXPECT_THROW(OnlineExpectationMaximization<>(&mzs[0], &intensities[0], size, rngEngine, 3, 256, 1.5),
+                 spectre::core::exception::ArgumentOutOfRangeException<DataType>);
+    OnlineExpectationMaximization<> em(&mzs[0], &intensities[0], size, rngEngine, 3);
+    EXPECT_THROW(em.Update(nullptr, &intensities[0], size), spectre::core::exception::NullPointerException);
+}
+}
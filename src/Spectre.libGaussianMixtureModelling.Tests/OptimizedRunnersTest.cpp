@@ -0,0 +1,215 @@
+/*
+* OptimizedRunnersTest.cpp
+* Provides implementation of tests checking that optimized runners
+* of Expectation Maximization algorithm match the reference ones.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include "ExpectationMaximization.h"
+#include "RandomInitializationRef.h"
+#include "ExpectationRunnerRef.h"
+#include "ExpectationRunnerOpt.h"
+#include "MaximizationRunnerRef.h"
+#include "MaximizationRunnerOpt.h"
+#include "LogLikelihoodCalculator.h"
+#include "LogLikelihoodCalculatorOpt.h"
+
+namespace spectre::unsupervised::gmm
+{
+class OptimizedRunnersTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/-5.0, /*deviation =*/ 3.0, /*weight =*/ 0.25 },
+            { /*mean =*/ 5.0, /*deviation =*/ 3.0, /*weight =*/ 0.25 },
+            { /*mean =*/ -2.0,/*deviation =*/ 9.0, /*weight =*/ 0.5 }
+        };
+
+        // more points than a single reduction block holds
+        const unsigned size = 5 * REDUCTION_BLOCK_SIZE + 17;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = -20.0 + step * i;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+    }
+
+    void FillWithPseudoRandomAffilations(Matrix &affilationMatrix)
+    {
+        const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+        for (unsigned i = 0; i < mzs.size(); i++)
+        {
+            for (unsigned k = 0; k < numberOfComponents; k++)
+            {
+                affilationMatrix(k, i) = 0.1 + 0.8 * ((i * 7 + k * 13) % 10) / 10.0;
+            }
+        }
+    }
+};
+
+TEST_F(OptimizedRunnersTest, expectation_matches_reference)
+{
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    Matrix reference(numberOfComponents, size);
+    Matrix optimized(numberOfComponents, size);
+
+    ExpectationRunnerRef(&mzs[0], size, reference, gaussianComponents).Expectation();
+    ExpectationRunnerOpt(&mzs[0], size, optimized, gaussianComponents).Expectation();
+
+    for (unsigned i = 0; i < size; i++)
+    {
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            EXPECT_NEAR(optimized(k, i), reference(k, i), 1e-12);
+        }
+    }
+}
+
+TEST_F(OptimizedRunnersTest, maximization_matches_reference)
+{
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    Matrix affilationMatrix(numberOfComponents, size);
+    FillWithPseudoRandomAffilations(affilationMatrix);
+    std::vector<GaussianComponent> referenceComponents = gaussianComponents;
+    std::vector<GaussianComponent> optimizedComponents = gaussianComponents;
+
+    MaximizationRunnerRef reference(&mzs[0], &intensities[0], size, affilationMatrix, referenceComponents);
+    MaximizationRunnerOpt optimized(&mzs[0], &intensities[0], size, affilationMatrix, optimizedComponents);
+    reference.UpdateWeights();
+    reference.UpdateMeans();
+    reference.UpdateStdDeviations();
+    optimized.UpdateWeights();
+    optimized.UpdateMeans();
+    optimized.UpdateStdDeviations();
+
+    for (unsigned k = 0; k < numberOfComponents; k++)
+    {
+        EXPECT_NEAR(optimizedComponents[k].weight, referenceComponents[k].weight, 1e-12);
+        EXPECT_NEAR(optimizedComponents[k].mean, referenceComponents[k].mean, 1e-10);
+        EXPECT_NEAR(optimizedComponents[k].deviation, referenceComponents[k].deviation, 1e-10);
+    }
+}
+
+TEST_F(OptimizedRunnersTest, loglikelihood_matches_reference)
+{
+    const unsigned size = (unsigned)mzs.size();
+    LogLikelihoodCalculator reference(&mzs[0], &intensities[0], size, gaussianComponents);
+    LogLikelihoodCalculatorOpt optimized(&mzs[0], &intensities[0], size, gaussianComponents);
+
+    const DataType expected = reference.CalculateLikelihood();
+    EXPECT_NEAR(optimized.CalculateLikelihood(), expected, 1e-10 * fabs(expected));
+}
+
+TEST_F(OptimizedRunnersTest, loglikelihood_is_reproducible)
+{
+    const unsigned size = (unsigned)mzs.size();
+    LogLikelihoodCalculatorOpt optimized(&mzs[0], &intensities[0], size, gaussianComponents);
+
+    const DataType first = optimized.CalculateLikelihood();
+    for (int run = 0; run < 5; run++)
+    {
+        ASSERT_EQ(optimized.CalculateLikelihood(), first);
+    }
+}
+
+TEST_F(OptimizedRunnersTest, whole_em_matches_reference)
+{
+    const unsigned size = (unsigned)mzs.size();
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    RandomNumberGenerator referenceEngine(0);
+    RandomNumberGenerator optimizedEngine(0);
+
+    ExpectationMaximization<
+        RandomInitializationRef,
+        ExpectationRunnerRef,
+        MaximizationRunnerRef,
+        LogLikelihoodCalculator
+    > reference(&mzs[0], &intensities[0], size, referenceEngine, numberOfComponents);
+    ExpectationMaximization<
+        RandomInitializationRef,
+        ExpectationRunnerOpt,
+        MaximizationRunnerOpt,
+        LogLikelihoodCalculatorOpt
+    > optimized(&mzs[0], &intensities[0], size, optimizedEngine, numberOfComponents);
+
+    GaussianMixtureModel expected = reference.EstimateGmm();
+    GaussianMixtureModel actual = optimized.EstimateGmm();
+
+    ASSERT_EQ(actual.components.size(), expected.components.size());
+    for (unsigned k = 0; k < numberOfComponents; k++)
+    {
+        EXPECT_NEAR(actual.components[k].weight, expected.components[k].weight, 1e-4);
+        EXPECT_NEAR(actual.components[k].mean, expected.components[k].mean, 1e-3);
+        EXPECT_NEAR(actual.components[k].deviation, expected.components[k].deviation, 1e-3);
+    }
+}
+
+TEST_F(OptimizedRunnersTest, loglikelihood_skips_points_of_zero_intensity)
+{
+    const unsigned margin = 500;
+    std::fill(intensities.begin(), intensities.begin() + margin, 0.0);
+    std::fill(intensities.end() - margin, intensities.end(), 0.0);
+    std::vector<double> nonzeroMzs(mzs.begin() + margin, mzs.end() - margin);
+    std::vector<double> nonzeroIntensities(intensities.begin() + margin, intensities.end() - margin);
+
+    const DataType expected = LogLikelihoodCalculatorOpt(&nonzeroMzs[0], &nonzeroIntensities[0],
+        (unsigned)nonzeroMzs.size(), gaussianComponents).CalculateLikelihood();
+    const DataType actual = LogLikelihoodCalculatorOpt(&mzs[0], &intensities[0], (unsigned)mzs.size(),
+        gaussianComponents).CalculateLikelihood();
+
+    ASSERT_TRUE(std::isfinite(expected));
+    EXPECT_NEAR(actual, expected, 1e-10 * fabs(expected));
+}
+
+TEST_F(OptimizedRunnersTest, whole_em_converges_with_zero_baseline)
+{
+    const unsigned margin = 500;
+    std::fill(intensities.begin(), intensities.begin() + margin, 0.0);
+    std::fill(intensities.end() - margin, intensities.end(), 0.0);
+    RandomNumberGenerator rngEngine(0);
+    ExpectationMaximization<
+        RandomInitializationRef,
+        ExpectationRunnerOpt,
+        MaximizationRunnerOpt,
+        LogLikelihoodCalculatorOpt
+    > optimized(&mzs[0], &intensities[0], (unsigned)mzs.size(), rngEngine, (unsigned)gaussianComponents.size());
+
+    optimized.EstimateGmm();
+
+    const ConvergenceReport report = optimized.GetConvergenceReport();
+    EXPECT_GT(report.iterations, 2u);
+    EXPECT_TRUE(std::isfinite(report.logLikelihood));
+}
+}
@@ -0,0 +1,166 @@
+/*
+* PresetInitializationTest.cpp
+* Provides implementation of tests checking warm start of Expectation
+* Maximization algorithm from components of a saved model.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <sstream>
+#include <gtest/gtest.h>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "ExpectationMaximization.h"
+#include "ExpectationRunnerRef.h"
+#include "FusedExpectationMaximization.h"
+#include "GaussianDistribution.h"
+#include "GaussianMixtureModelSerialization.h"
+#include "LogLikelihoodCalculator.h"
+#include "MaximizationRunnerRef.h"
+#include "PresetInitialization.h"
+#include "RandomInitializationRef.h"
+
+namespace spectre::unsupervised::gmm
+{
+class PresetInitializationTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<double> changedIntensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ 10.0, /*deviation =*/ 2.0, /*weight =*/ 0.2 },
+            { /*mean =*/ 15.0, /*deviation =*/ 2.5, /*weight =*/ 0.2 },
+            { /*mean =*/ 20.0, /*deviation =*/ 2.0, /*weight =*/ 0.3 },
+            { /*mean =*/ 28.0, /*deviation =*/ 3.0, /*weight =*/ 0.1 },
+            { /*mean =*/ 35.0, /*deviation =*/ 1.5, /*weight =*/ 0.2 }
+        };
+
+        // overlapping components make cold start converge slowly,
+        // reprocessed dataset differs by a slight, uneven change of intensities
+        const unsigned size = 1000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        changedIntensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = step * i;
+            intensities[i] = 1e-6;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+            changedIntensities[i] = intensities[i] * (1.0 + 0.02 * sin(0.1 * i));
+        }
+    }
+};
+
+TEST_F(PresetInitializationTest, keeps_preset_components_and_normalizes_weights)
+{
+    std::vector<GaussianComponent> components = {
+        { /*mean =*/ 10.0, /*deviation =*/ 1.0, /*weight =*/ 0.2 },
+        { /*mean =*/ 20.0, /*deviation =*/ 2.0, /*weight =*/ 0.6 }
+    };
+    RandomNumberGenerator rngEngine(0);
+    PresetInitialization initialization(&mzs[0], &intensities[0], (unsigned)mzs.size(), components, rngEngine);
+
+    initialization.AssignRandomMeans();
+    initialization.AssignVariances();
+    initialization.AssignWeights();
+
+    EXPECT_EQ(components[0].mean, 10.0);
+    EXPECT_EQ(components[1].deviation, 2.0);
+    EXPECT_DOUBLE_EQ(components[0].weight, 0.25);
+    EXPECT_DOUBLE_EQ(components[1].weight, 0.75);
+}
+
+TEST_F(PresetInitializationTest, warm_start_from_saved_model_converges_in_few_iterations)
+{
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    RandomNumberGenerator rngEngine(0);
+    FusedExpectationMaximization<RandomInitializationRef> coldStart(
+        &mzs[0], &intensities[0], (unsigned)mzs.size(), rngEngine, numberOfComponents);
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    WriteBinary(coldStart.EstimateGmm(), stream);
+    const unsigned coldIterations = coldStart.GetConvergenceReport().iterations;
+
+    const GaussianMixtureModel saved = ReadBinary(stream);
+    FusedExpectationMaximization<PresetInitialization> warmStart(
+        &mzs[0], &changedIntensities[0], (unsigned)mzs.size(), rngEngine, saved.components);
+    const GaussianMixtureModel model = warmStart.EstimateGmm();
+
+    EXPECT_LT(warmStart.GetConvergenceReport().iterations, coldIterations / 10);
+    ASSERT_EQ(model.components.size(), saved.components.size());
+    for (unsigned k = 0; k < saved.components.size(); k++)
+    {
+        EXPECT_NEAR(model.components[k].mean, saved.components[k].mean, 1e-2);
+        EXPECT_NEAR(model.components[k].deviation, saved.components[k].deviation, 1e-2);
+        EXPECT_NEAR(model.components[k].weight, saved.components[k].weight, 1e-2);
+    }
+}
+
+TEST_F(PresetInitializationTest, reference_em_resumes_from_initial_components)
+{
+    const unsigned numberOfComponents = (unsigned)gaussianComponents.size();
+    RandomNumberGenerator rngEngine(0);
+    FusedExpectationMaximization<RandomInitializationRef> coldStart(
+        &mzs[0], &intensities[0], (unsigned)mzs.size(), rngEngine, numberOfComponents);
+    const GaussianMixtureModel saved = coldStart.EstimateGmm();
+    const unsigned coldIterations = coldStart.GetConvergenceReport().iterations;
+
+    ExpectationMaximization<
+        PresetInitialization,
+        ExpectationRunnerRef,
+        MaximizationRunnerRef,
+        LogLikelihoodCalculator
+    > warmStart(&mzs[0], &changedIntensities[0], (unsigned)mzs.size(), rngEngine, saved.components);
+    const GaussianMixtureModel model = warmStart.EstimateGmm();
+
+    EXPECT_LT(warmStart.GetConvergenceReport().iterations, coldIterations / 10);
+    ASSERT_EQ(model.components.size(), saved.components.size());
+    for (unsigned k = 0; k < saved.components.size(); k++)
+    {
+        EXPECT_NEAR(model.components[k].mean, saved.components[k].mean, 1e-2);
+        EXPECT_NEAR(model.components[k].deviation, saved.components[k].deviation, 1e-2);
+        EXPECT_NEAR(model.components[k].weight, saved.components[k].weight, 1e-2);
+    }
+}
+
+TEST_F(PresetInitializationTest, throws_on_components_not_preset)
+{
+    const unsigned size = (unsigned)mzs.size();
+    std::vector<GaussianComponent> components(2);
+    RandomNumberGenerator rngEngine(0);
+
+    EXPECT_THROW(PresetInitialization(nullptr, &intensities[0], size, gaussianComponents, rngEngine),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(PresetInitialization(&mzs[0], nullptr, size, gaussianComponents, rngEngine),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(PresetInitialization(&mzs[0], &intensities[0], size, components, rngEngine),
+                 spectre::core::exception::ArgumentOutOfRangeException<DataType>);
+    EXPECT_THROW(FusedExpectationMaximization<PresetInitialization>(&mzs[0], &intensities[0], size, rngEngine, 2),
+                 spectre::core::exception::ArgumentOutOfRangeException<DataType>);
+    EXPECT_THROW((ExpectationMaximization<PresetInitialization, ExpectationRunnerRef, MaximizationRunnerRef,
+                                          LogLikelihoodCalculator>(&mzs[0], &intensities[0], size, rngEngine, 2)),
+                 spectre::core::exception::ArgumentOutOfRangeException<DataType>);
+}
+}
@@ -0,0 +1,199 @@
+/*
+* SegmentedDecompositionTest.cpp
+* Provides implementation of tests checking segmented decomposition
+* of long spectra into Gaussian Mixture Model.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "FusedExpectationMaximization.h"
+#include "GaussianDistribution.h"
+#include "KMeansPlusPlusInitialization.h"
+#include "SegmentedDecomposition.h"
+
+namespace spectre::unsupervised::gmm
+{
+class SegmentedDecompositionTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    virtual void SetUp() override
+    {
+        const unsigned numberOfPeaks = 40;
+        for (unsigned k = 0; k < numberOfPeaks; k++)
+        {
+            gaussianComponents.push_back({ /*mean =*/ 505.0 + 10.0 * k,
+                                           /*deviation =*/ 0.5 + 0.25 * (k % 3),
+                                           /*weight =*/ (1.0 + k % 4) / 100.0 });
+        }
+
+        const unsigned size = 16000;
+        const double step = 400.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = 500.0 + step * i;
+            intensities[i] = 1e-6;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+    }
+};
+
+TEST_F(SegmentedDecompositionTest, segments_cover_spectrum_and_split_at_valleys)
+{
+    const unsigned size = (unsigned)mzs.size();
+    SegmentedDecomposition<> decomposition(&mzs[0], &intensities[0], size, 1024, 256);
+
+    const std::vector<SpectrumSegment> segments = decomposition.FindSegments();
+
+    ASSERT_GT(segments.size(), 1u);
+    EXPECT_EQ(segments.front().begin, 0u);
+    EXPECT_EQ(segments.back().end, size);
+    for (unsigned s = 0; s < segments.size(); s++)
+    {
+        EXPECT_LT(segments[s].begin, segments[s].end);
+        EXPECT_LE(segments[s].fitBegin, segments[s].begin);
+        EXPECT_GE(segments[s].fitEnd, segments[s].end);
+        EXPECT_GE(segments[s].numberOfComponents, 1u);
+        if (s > 0)
+        {
+            EXPECT_EQ(segments[s - 1].end, segments[s].begin);
+            EXPECT_LT(intensities[segments[s].begin], 1e-4);
+        }
+    }
+}
+
+TEST_F(SegmentedDecompositionTest, recovers_peaks_of_long_spectrum)
+{
+    SegmentedDecomposition<> decomposition(&mzs[0], &intensities[0], (unsigned)mzs.size(), 1024, 256);
+
+    GaussianMixtureModel model = decomposition.EstimateGmm(0);
+
+    ASSERT_EQ(model.components.size(), gaussianComponents.size());
+    DataType sum = 0.0;
+    for (unsigned k = 0; k < gaussianComponents.size(); k++)
+    {
+        EXPECT_NEAR(model.components[k].mean, gaussianComponents[k].mean, 1e-2);
+        EXPECT_NEAR(model.components[k].deviation, gaussianComponents[k].deviation, 1e-2);
+        sum += model.components[k].weight;
+    }
+    EXPECT_NEAR(sum, 1.0, 1e-12);
+    // weights are normalized over the sum of the generating ones
+    EXPECT_NEAR(model.components[1].weight / model.components[0].weight,
+                gaussianComponents[1].weight / gaussianComponents[0].weight, 1e-2);
+}
+
+TEST_F(SegmentedDecompositionTest, recovers_peaks_with_zero_baseline)
+{
+    // baseline removed, so that segments are cut at zero intensities
+    for (auto &intensity : intensities)
+    {
+        intensity = intensity > 1e-5 ? intensity - 1e-6 : 0.0;
+    }
+    SegmentedDecomposition<> decomposition(&mzs[0], &intensities[0], (unsigned)mzs.size(), 1024, 256);
+
+    const std::vector<SpectrumSegment> segments = decomposition.FindSegments();
+    GaussianMixtureModel model = decomposition.EstimateGmm(0);
+
+    for (unsigned s = 0; s < segments.size(); s++)
+    {
+        if (s > 0)
+        {
+            EXPECT_EQ(intensities[segments[s].begin], 0.0);
+        }
+        RandomNumberGenerator rngEngine(0);
+        FusedExpectationMaximization<KMeansPlusPlusInitialization> em(
+            &mzs[segments[s].fitBegin], &intensities[segments[s].fitBegin],
+            segments[s].fitEnd - segments[s].fitBegin, rngEngine, segments[s].numberOfComponents);
+        em.EstimateGmm();
+        EXPECT_TRUE(std::isfinite(em.GetConvergenceReport().logLikelihood));
+    }
+    ASSERT_EQ(model.components.size(), gaussianComponents.size());
+    for (unsigned k = 0; k < gaussianComponents.size(); k++)
+    {
+        EXPECT_NEAR(model.components[k].mean, gaussianComponents[k].mean, 1e-2);
+        EXPECT_NEAR(model.components[k].deviation, gaussianComponents[k].deviation, 1e-2);
+        EXPECT_TRUE(std::isfinite(model.components[k].weight));
+    }
+}
+
+TEST_F(SegmentedDecompositionTest, single_segment_matches_expectation_maximization)
+{
+    const unsigned size = 2000;
+    SegmentedDecomposition<> decomposition(&mzs[0], &intensities[0], size, size, 128);
+    const std::vector<SpectrumSegment> segments = decomposition.FindSegments();
+    ASSERT_EQ(segments.size(), 1u);
+    RandomNumberGenerator rngEngine(DeriveSeeds(7, 1)[0]);
+    FusedExpectationMaximization<KMeansPlusPlusInitialization> em(&mzs[0], &intensities[0], size, rngEngine,
+                                                                  segments[0].numberOfComponents);
+
+    std::vector<GaussianComponent> expected = em.EstimateGmm().components;
+    GaussianMixtureModel actual = decomposition.EstimateGmm(7);
+    std::sort(expected.begin(), expected.end(),
+              [](const GaussianComponent &first, const GaussianComponent &second)
+              {
+                  return first.mean < second.mean;
+              });
+
+    ASSERT_EQ(actual.components.size(), expected.size());
+    for (unsigned k = 0; k < expected.size(); k++)
+    {
+        EXPECT_DOUBLE_EQ(actual.components[k].mean, expected[k].mean);
+        EXPECT_DOUBLE_EQ(actual.components[k].deviation, expected[k].deviation);
+        EXPECT_NEAR(actual.components[k].weight, expected[k].weight, 1e-12);
+    }
+}
+
+TEST_F(SegmentedDecompositionTest, does_not_depend_on_scheduling)
+{
+    SegmentedDecomposition<> decomposition(&mzs[0], &intensities[0], (unsigned)mzs.size(), 1024, 256);
+
+    GaussianMixtureModel first = decomposition.EstimateGmm(3);
+    GaussianMixtureModel second = decomposition.EstimateGmm(3);
+
+    ASSERT_EQ(first.components.size(), second.components.size());
+    for (unsigned k = 0; k < first.components.size(); k++)
+    {
+        EXPECT_EQ(first.components[k].mean, second.components[k].mean);
+        EXPECT_EQ(first.components[k].deviation, second.components[k].deviation);
+        EXPECT_EQ(first.components[k].weight, second.components[k].weight);
+    }
+}
+
+TEST_F(SegmentedDecompositionTest, throws_on_invalid_arguments)
+{
+    const unsigned size = (unsigned)mzs.size();
+
+    EXPECT_THROW(SegmentedDecomposition<>(nullptr, &intensities[0], size),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(SegmentedDecomposition<>(&mzs[0], nullptr, size),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(SegmentedDecomposition<>(&mzs[0], &intensities[0], size, 0),
+                 spectre::core::exception::ArgumentOutOfRangeException<unsigned>);
+}
+}
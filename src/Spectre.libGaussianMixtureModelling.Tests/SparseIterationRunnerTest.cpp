@@ -0,0 +1,215 @@
+/*
+* SparseIterationRunnerTest.cpp
+* Provides implementation of tests checking iterations of Expectation
+* Maximization algorithm evaluating components within truncated support.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "FusedExpectationMaximization.h"
+#include "FusedIterationRunner.h"
+#include "GaussianDistribution.h"
+#include "RandomInitializationRef.h"
+#include "SparseIterationRunner.h"
+
+namespace spectre::unsupervised::gmm
+{
+class SparseIterationRunnerTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+
+    // Spectrum of many narrow peaks, with m/z range [0, 1000).
+    virtual void SetUp() override
+    {
+        const unsigned numberOfComponents = 50;
+        gaussianComponents.resize(numberOfComponents);
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            gaussianComponents[k] = { /*mean =*/ 20.0 * k + 10.0, /*deviation =*/ 2.0 + (k % 3),
+                                      /*weight =*/ 1.0 / numberOfComponents };
+        }
+
+        const unsigned size = 20000;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = 1000.0 * i / size;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+
+        // start away from the optimum, so that the iterations move components
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            gaussianComponents[k].mean += 0.5;
+            gaussianComponents[k].deviation *= 1.5;
+        }
+    }
+
+    void ExpectIterationsMatchFused(SparseIterationRunner &sparse, std::vector<GaussianComponent> &sparseComponents,
+                                    double tolerance)
+    {
+        std::vector<GaussianComponent> fusedComponents = gaussianComponents;
+        FusedIterationRunner fused(&mzs[0], &intensities[0], (unsigned)mzs.size(), fusedComponents);
+        for (int iteration = 0; iteration < 5; iteration++)
+        {
+            const DataType expectedLikelihood = fused.Iterate();
+            EXPECT_NEAR(sparse.Iterate(), expectedLikelihood, tolerance * fabs(expectedLikelihood));
+        }
+        for (unsigned k = 0; k < fusedComponents.size(); k++)
+        {
+            EXPECT_NEAR(sparseComponents[k].weight, fusedComponents[k].weight, tolerance);
+            EXPECT_NEAR(sparseComponents[k].mean, fusedComponents[k].mean, tolerance * fusedComponents[k].mean);
+            EXPECT_NEAR(sparseComponents[k].deviation, fusedComponents[k].deviation, tolerance);
+        }
+    }
+};
+
+TEST_F(SparseIterationRunnerTest, matches_fused_iterations_with_default_cutoff)
+{
+    std::vector<GaussianComponent> sparseComponents = gaussianComponents;
+    SparseIterationRunner sparse(&mzs[0], &intensities[0], (unsigned)mzs.size(), sparseComponents);
+
+    ExpectIterationsMatchFused(sparse, sparseComponents, 1e-9);
+}
+
+TEST_F(SparseIterationRunnerTest, matches_fused_iterations_with_wide_cutoff)
+{
+    std::vector<GaussianComponent> sparseComponents = gaussianComponents;
+    SparseIterationRunner sparse(&mzs[0], &intensities[0], (unsigned)mzs.size(), sparseComponents, 1000.0, 3);
+
+    ExpectIterationsMatchFused(sparse, sparseComponents, 1e-12);
+}
+
+TEST_F(SparseIterationRunnerTest, affiliates_points_out_of_support_to_closest_components)
+{
+    // with narrow support most of the points are not covered by any component
+    std::vector<GaussianComponent> sparseComponents = gaussianComponents;
+    SparseIterationRunner sparse(&mzs[0], &intensities[0], (unsigned)mzs.size(), sparseComponents, 0.5);
+
+    const DataType likelihood = sparse.Iterate();
+
+    EXPECT_TRUE(std::isfinite(likelihood));
+    for (const auto &component : sparseComponents)
+    {
+        EXPECT_TRUE(std::isfinite(component.mean));
+        EXPECT_TRUE(std::isfinite(component.deviation));
+        EXPECT_GT(component.weight, 0.0);
+    }
+}
+
+TEST_F(SparseIterationRunnerTest, handles_gaps_between_narrow_peaks)
+{
+    // points halfway between the peaks are 50 deviations away from both,
+    // where densities of the components underflow to zero
+    const unsigned numberOfPeaks = 20;
+    const unsigned pointsPerPeak = 1000;
+    std::vector<GaussianComponent> peaks(numberOfPeaks);
+    for (unsigned k = 0; k < numberOfPeaks; k++)
+    {
+        peaks[k] = { /*mean =*/ k + 0.5, /*deviation =*/ 0.01, /*weight =*/ 1.0 / numberOfPeaks };
+    }
+    std::vector<double> gappedMzs(numberOfPeaks * pointsPerPeak);
+    std::vector<double> gappedIntensities(gappedMzs.size());
+    for (unsigned i = 0; i < gappedMzs.size(); i++)
+    {
+        gappedMzs[i] = (double)i / pointsPerPeak;
+        gappedIntensities[i] = 1e-3;
+        for (const auto &peak : peaks)
+        {
+            gappedIntensities[i] += peak.weight * Gaussian(gappedMzs[i], peak.mean, peak.deviation);
+        }
+    }
+
+    std::vector<GaussianComponent> sparseComponents = peaks;
+    SparseIterationRunner sparse(&gappedMzs[0], &gappedIntensities[0], (unsigned)gappedMzs.size(), sparseComponents);
+    for (int iteration = 0; iteration < 5; iteration++)
+    {
+        EXPECT_TRUE(std::isfinite(sparse.Iterate()));
+    }
+
+    double totalWeight = 0.0;
+    for (unsigned k = 0; k < numberOfPeaks; k++)
+    {
+        EXPECT_NEAR(sparseComponents[k].mean, peaks[k].mean, 0.05);
+        EXPECT_TRUE(std::isfinite(sparseComponents[k].deviation));
+        EXPECT_GT(sparseComponents[k].weight, 0.0);
+        totalWeight += sparseComponents[k].weight;
+    }
+    EXPECT_NEAR(totalWeight, 1.0, 1e-9);
+}
+
+TEST_F(SparseIterationRunnerTest, skips_points_of_zero_intensity)
+{
+    // every component keeps some nonzero points within its support
+    const unsigned margin = 300;
+    std::fill(intensities.begin(), intensities.begin() + margin, 0.0);
+    std::fill(intensities.end() - margin, intensities.end(), 0.0);
+
+    std::vector<GaussianComponent> sparseComponents = gaussianComponents;
+    SparseIterationRunner sparse(&mzs[0], &intensities[0], (unsigned)mzs.size(), sparseComponents);
+    ExpectIterationsMatchFused(sparse, sparseComponents, 1e-9);
+
+    // with narrow support zero points out of support of all the components are skipped as well
+    std::vector<GaussianComponent> narrowComponents = gaussianComponents;
+    SparseIterationRunner narrow(&mzs[0], &intensities[0], (unsigned)mzs.size(), narrowComponents, 0.5);
+    for (int iteration = 0; iteration < 5; iteration++)
+    {
+        EXPECT_TRUE(std::isfinite(narrow.Iterate()));
+    }
+}
+
+TEST_F(SparseIterationRunnerTest, throws_on_non_positive_cutoff)
+{
+    EXPECT_THROW(SparseIterationRunner(&mzs[0], &intensities[0], (unsigned)mzs.size(), gaussianComponents, 0.0),
+                 spectre::core::exception::ArgumentOutOfRangeException<DataType>);
+    EXPECT_THROW(SparseIterationRunner(&mzs[0], &intensities[0], (unsigned)mzs.size(), gaussianComponents, -1.0),
+                 spectre::core::exception::ArgumentOutOfRangeException<DataType>);
+}
+
+TEST_F(SparseIterationRunnerTest, whole_em_accepts_cutoff)
+{
+    const unsigned size = 2000;
+    const unsigned numberOfComponents = 3;
+    RandomNumberGenerator fusedEngine(0);
+    RandomNumberGenerator sparseEngine(0);
+
+    FusedExpectationMaximization<RandomInitializationRef> fused(&mzs[0], &intensities[0], size,
+                                                                fusedEngine, numberOfComponents);
+    FusedExpectationMaximization<RandomInitializationRef, SparseIterationRunner> sparse(
+        &mzs[0], &intensities[0], size, sparseEngine, numberOfComponents, 1000.0);
+
+    GaussianMixtureModel expected = fused.EstimateGmm();
+    GaussianMixtureModel actual = sparse.EstimateGmm();
+
+    ASSERT_EQ(actual.components.size(), expected.components.size());
+    for (unsigned k = 0; k < numberOfComponents; k++)
+    {
+        EXPECT_NEAR(actual.components[k].weight, expected.components[k].weight, 1e-4);
+        EXPECT_NEAR(actual.components[k].mean, expected.components[k].mean, 1e-3);
+        EXPECT_NEAR(actual.components[k].deviation, expected.components[k].deviation, 1e-3);
+    }
+}
+}
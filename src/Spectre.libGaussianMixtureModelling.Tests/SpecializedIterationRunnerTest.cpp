@@ -0,0 +1,220 @@
+/*
+* SpecializedIterationRunnerTest.cpp
+* Provides implementation of tests checking iterations of Expectation
+* Maximization algorithm specialized for scalar type and number of components.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define GTEST_LANG_CXX11 1
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "FusedExpectationMaximization.h"
+#include "FusedIterationRunner.h"
+#include "GaussianDistribution.h"
+#include "KMeansPlusPlusInitialization.h"
+#include "SpecializedIterationRunner.h"
+
+namespace spectre::unsupervised::gmm
+{
+class SpecializedIterationRunnerTest : public ::testing::Test
+{
+protected:
+
+    std::vector<double> mzs;
+    std::vector<double> intensities;
+    std::vector<GaussianComponent> gaussianComponents;
+    std::vector<GaussianComponent> initialComponents;
+
+    virtual void SetUp() override
+    {
+        gaussianComponents = {
+            { /*mean =*/ 995.0, /*deviation =*/ 3.0, /*weight =*/ 0.25 },
+            { /*mean =*/ 1005.0,/*deviation =*/ 3.0, /*weight =*/ 0.25 },
+            { /*mean =*/ 998.0, /*deviation =*/ 9.0, /*weight =*/ 0.5 }
+        };
+
+        // m/z far from zero, where single precision would lose the distances
+        const unsigned size = 3000;
+        const double step = 40.0 / size;
+        mzs.resize(size);
+        intensities.resize(size);
+        for (unsigned i = 0; i < size; i++)
+        {
+            mzs[i] = 980.0 + step * i;
+            intensities[i] = 1e-6;
+            for (const auto &component : gaussianComponents)
+            {
+                intensities[i] += component.weight * Gaussian(mzs[i], component.mean, component.deviation);
+            }
+        }
+        initialComponents = gaussianComponents;
+        initialComponents[0].mean = 993.0;
+        initialComponents[1].deviation = 4.0;
+        initialComponents[2].weight = 0.4;
+    }
+
+    template <typename Runner>
+    std::vector<DataType> Run(std::vector<GaussianComponent> &components, unsigned numberOfIterations)
+    {
+        Runner runner(&mzs[0], &intensities[0], (unsigned)mzs.size(), components);
+        std::vector<DataType> likelihoods;
+        for (unsigned i = 0; i < numberOfIterations; i++)
+        {
+            likelihoods.push_back(runner.Iterate());
+        }
+        return likelihoods;
+    }
+
+    void ExpectNear(const std::vector<GaussianComponent> &actual, const std::vector<GaussianComponent> &expected,
+                    DataType tolerance) const
+    {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (unsigned k = 0; k < expected.size(); k++)
+        {
+            EXPECT_NEAR(actual[k].weight, expected[k].weight, tolerance);
+            EXPECT_NEAR(actual[k].mean, expected[k].mean, tolerance);
+            EXPECT_NEAR(actual[k].deviation, expected[k].deviation, tolerance);
+        }
+    }
+};
+
+TEST_F(SpecializedIterationRunnerTest, double_precision_matches_fused_runner)
+{
+    std::vector<GaussianComponent> expected = initialComponents;
+    std::vector<GaussianComponent> actual = initialComponents;
+
+    const std::vector<DataType> expectedLikelihoods = Run<FusedIterationRunner>(expected, 10);
+    const std::vector<DataType> likelihoods = Run<SpecializedIterationRunner<double>>(actual, 10);
+
+    for (unsigned i = 0; i < likelihoods.size(); i++)
+    {
+        EXPECT_NEAR(likelihoods[i], expectedLikelihoods[i], 1e-10 * fabs(expectedLikelihoods[i]));
+    }
+    ExpectNear(actual, expected, 1e-9);
+}
+
+TEST_F(SpecializedIterationRunnerTest, single_precision_follows_double_precision)
+{
+    std::vector<GaussianComponent> expected = initialComponents;
+    std::vector<GaussianComponent> actual = initialComponents;
+
+    const std::vector<DataType> expectedLikelihoods = Run<SpecializedIterationRunner<double>>(expected, 10);
+    const std::vector<DataType> likelihoods = Run<SpecializedIterationRunner<float>>(actual, 10);
+
+    for (unsigned i = 0; i < likelihoods.size(); i++)
+    {
+        EXPECT_NEAR(likelihoods[i], expectedLikelihoods[i], 1e-5 * fabs(expectedLikelihoods[i]));
+    }
+    ExpectNear(actual, expected, 1e-4);
+}
+
+TEST_F(SpecializedIterationRunnerTest, static_number_of_components_matches_dynamic_one)
+{
+    std::vector<GaussianComponent> dynamicComponents = initialComponents;
+    std::vector<GaussianComponent> staticComponents = initialComponents;
+    std::vector<GaussianComponent> dynamicFloatComponents = initialComponents;
+    std::vector<GaussianComponent> staticFloatComponents = initialComponents;
+
+    Run<SpecializedIterationRunner<double>>(dynamicComponents, 10);
+    Run<SpecializedIterationRunner<double, 3>>(staticComponents, 10);
+    Run<SpecializedIterationRunner<float>>(dynamicFloatComponents, 10);
+    Run<SpecializedIterationRunner<float, 3>>(staticFloatComponents, 10);
+
+    ExpectNear(staticComponents, dynamicComponents, 1e-12);
+    ExpectNear(staticFloatComponents, dynamicFloatComponents, 1e-12);
+}
+
+TEST_F(SpecializedIterationRunnerTest, points_underflowing_in_single_precision_are_evaluated_in_double)
+{
+    // points more than 14 deviations away from both components, where
+    // single precision densities are all flushed to zero
+    std::vector<GaussianComponent> components = {
+        { /*mean =*/ 995.0, /*deviation =*/ 0.5, /*weight =*/ 0.5 },
+        { /*mean =*/ 1005.0, /*deviation =*/ 0.5, /*weight =*/ 0.5 }
+    };
+    std::vector<GaussianComponent> expected = components;
+
+    const std::vector<DataType> expectedLikelihoods = Run<SpecializedIterationRunner<double>>(expected, 1);
+    const std::vector<DataType> likelihoods = Run<SpecializedIterationRunner<float, 2>>(components, 1);
+
+    EXPECT_TRUE(isfinite(likelihoods[0]));
+    EXPECT_NEAR(likelihoods[0], expectedLikelihoods[0], 1e-5 * fabs(expectedLikelihoods[0]));
+    ExpectNear(components, expected, 1e-4);
+}
+
+TEST_F(SpecializedIterationRunnerTest, skips_points_of_zero_intensity)
+{
+    const unsigned margin = 300;
+    std::fill(intensities.begin(), intensities.begin() + margin, 0.0);
+    std::fill(intensities.end() - margin, intensities.end(), 0.0);
+    std::vector<GaussianComponent> expected = initialComponents;
+    std::vector<GaussianComponent> actual = initialComponents;
+
+    const std::vector<DataType> expectedLikelihoods = Run<FusedIterationRunner>(expected, 10);
+    const std::vector<DataType> likelihoods = Run<SpecializedIterationRunner<double>>(actual, 10);
+
+    for (unsigned i = 0; i < likelihoods.size(); i++)
+    {
+        EXPECT_TRUE(isfinite(likelihoods[i]));
+        EXPECT_NEAR(likelihoods[i], expectedLikelihoods[i], 1e-10 * fabs(expectedLikelihoods[i]));
+    }
+    ExpectNear(actual, expected, 1e-9);
+
+    // zero points underflowing in single precision are skipped in double precision fallback as well
+    std::vector<GaussianComponent> narrowComponents = {
+        { /*mean =*/ 995.0, /*deviation =*/ 0.5, /*weight =*/ 0.5 },
+        { /*mean =*/ 1005.0, /*deviation =*/ 0.5, /*weight =*/ 0.5 }
+    };
+    std::vector<GaussianComponent> narrowExpected = narrowComponents;
+
+    const std::vector<DataType> narrowExpectedLikelihoods = Run<SpecializedIterationRunner<double>>(narrowExpected, 1);
+    const std::vector<DataType> narrowLikelihoods = Run<SpecializedIterationRunner<float, 2>>(narrowComponents, 1);
+
+    EXPECT_TRUE(isfinite(narrowLikelihoods[0]));
+    EXPECT_NEAR(narrowLikelihoods[0], narrowExpectedLikelihoods[0], 1e-5 * fabs(narrowExpectedLikelihoods[0]));
+    ExpectNear(narrowComponents, narrowExpected, 1e-4);
+}
+
+TEST_F(SpecializedIterationRunnerTest, single_precision_estimates_gmm)
+{
+    RandomNumberGenerator rngEngine(0);
+    FusedExpectationMaximization<KMeansPlusPlusInitialization, SpecializedIterationRunner<float, 3>>
+        em(&mzs[0], &intensities[0], (unsigned)mzs.size(), rngEngine, 3);
+    RandomNumberGenerator referenceEngine(0);
+    FusedExpectationMaximization<KMeansPlusPlusInitialization>
+        reference(&mzs[0], &intensities[0], (unsigned)mzs.size(), referenceEngine, 3);
+
+    GaussianMixtureModel model = em.EstimateGmm();
+    GaussianMixtureModel expected = reference.EstimateGmm();
+
+    ExpectNear(model.components, expected.components, 1e-2);
+}
+
+TEST_F(SpecializedIterationRunnerTest, throws_on_invalid_arguments)
+{
+    const unsigned size = (unsigned)mzs.size();
+    std::vector<GaussianComponent> components = initialComponents;
+
+    EXPECT_THROW(SpecializedIterationRunner<float>(nullptr, &intensities[0], size, components),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW(SpecializedIterationRunner<float>(&mzs[0], nullptr, size, components),
+                 spectre::core::exception::NullPointerException);
+    EXPECT_THROW((SpecializedIterationRunner<float, 4>(&mzs[0], &intensities[0], size, components)),
+                 spectre::core::exception::ArgumentOutOfRangeException<unsigned>);
+}
+}
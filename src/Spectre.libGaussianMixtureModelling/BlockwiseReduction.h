@@ -0,0 +1,120 @@
+/*
+ * BlockwiseReduction.h
+ * Provides parallel, yet deterministic, summation over data points
+ * used by optimized runners of Gaussian Mixture Modelling.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Number of data points summed up by a single task of blockwise reduction.
+/// </summary>
+constexpr unsigned REDUCTION_BLOCK_SIZE = 1024;
+
+/// <summary>
+/// Computes a set of sums over all data points in parallel. Data points
+/// are split into blocks of REDUCTION_BLOCK_SIZE, partial sums of each block
+/// are computed concurrently and then added up sequentially in order of blocks.
+/// As the split does not depend on the number of threads, nor on scheduling,
+/// the result is bitwise reproducible between runs.
+/// </summary>
+/// <param name="size">Number of data points.</param>
+/// <param name="numberOfSums">Number of sums computed simultaneously.</param>
+/// <param name="accumulate">Callable of signature (unsigned begin, unsigned end, DataType *sums),
+/// adding contributions of points [begin, end) to zero-initialized sums.</param>
+/// <returns>Sums over all data points.</returns>
+template <typename BlockAccumulator>
+std::vector<DataType> ReduceBlockwise(unsigned size, unsigned numberOfSums, BlockAccumulator accumulate)
+{
+    const int numberOfBlocks = static_cast<int>((size + REDUCTION_BLOCK_SIZE - 1) / REDUCTION_BLOCK_SIZE);
+    std::vector<DataType> partialSums(static_cast<size_t>(numberOfBlocks) * numberOfSums, 0.0);
+
+    #pragma omp parallel for schedule(static)
+    for (int block = 0; block < numberOfBlocks; block++)
+    {
+        const unsigned begin = static_cast<unsigned>(block) * REDUCTION_BLOCK_SIZE;
+        const unsigned end = begin + REDUCTION_BLOCK_SIZE < size ? begin + REDUCTION_BLOCK_SIZE : size;
+        accumulate(begin, end, &partialSums[static_cast<size_t>(block) * numberOfSums]);
+    }
+
+    std::vector<DataType> sums(numberOfSums, 0.0);
+    for (int block = 0; block < numberOfBlocks; block++)
+    {
+        const DataType *blockSums = &partialSums[static_cast<size_t>(block) * numberOfSums];
+        for (unsigned s = 0; s < numberOfSums; s++)
+        {
+            sums[s] += blockSums[s];
+        }
+    }
+    return sums;
+}
+
+/// <summary>
+/// Scratch buffers of parallel loops, one per thread, kept between the loops,
+/// so that their bodies do not allocate memory on every call.
+/// </summary>
+class ThreadScratch
+{
+public:
+    /// <summary>
+    /// Makes sure, that each thread of the next parallel loop has a buffer
+    /// of at least the given size. Has to be called outside of the loop.
+    /// </summary>
+    /// <param name="size">Number of values in each buffer.</param>
+    void Reserve(size_t size)
+    {
+#ifdef _OPENMP
+        const size_t numberOfThreads = static_cast<size_t>(omp_get_max_threads());
+#else
+        const size_t numberOfThreads = 1;
+#endif
+        if (m_Buffers.size() < numberOfThreads)
+        {
+            m_Buffers.resize(numberOfThreads);
+        }
+        for (std::vector<DataType> &buffer : m_Buffers)
+        {
+            if (buffer.size() < size)
+            {
+                buffer.resize(size);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Gets buffer of the calling thread.
+    /// </summary>
+    /// <returns>Buffer of at least the size reserved last.</returns>
+    DataType *Get()
+    {
+#ifdef _OPENMP
+        return m_Buffers[static_cast<size_t>(omp_get_thread_num())].data();
+#else
+        return m_Buffers[0].data();
+#endif
+    }
+
+private:
+    std::vector<std::vector<DataType>> m_Buffers;
+};
+}
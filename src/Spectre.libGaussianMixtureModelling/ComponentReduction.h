@@ -0,0 +1,230 @@
+/*
+ * ComponentReduction.h
+ * Provides post-processing of Gaussian Mixture Model, which merges
+ * components of nearby means and removes negligible ones.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/FusedIterationRunner.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Default weight, relative to the total weight of the components,
+/// below which a component is considered negligible.
+/// </summary>
+constexpr DataType DEFAULT_MIN_COMPONENT_WEIGHT = 0.0001;
+
+/// <summary>
+/// Default number of iterations refining the reduced components.
+/// </summary>
+constexpr unsigned DEFAULT_REFINEMENT_ITERATIONS = 10;
+
+/// <summary>
+/// Merges components, which means are closer than the threshold, into single
+/// components of the same weight, mean and variance as the merged mixture.
+/// Components are visited in order of means and each is merged into the
+/// preceding group, when its mean is closer than the threshold to the mean
+/// of the group, so chains of close components collapse into one.
+/// </summary>
+/// <param name="components">Components to be merged.</param>
+/// <param name="mzMergingThreshold">Distance between means, below which components are merged.</param>
+/// <returns>Merged components, sorted by means.</returns>
+inline std::vector<GaussianComponent> MergeComponents(const std::vector<GaussianComponent> &components,
+                                                      DataType mzMergingThreshold)
+{
+    std::vector<GaussianComponent> sorted(components);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const GaussianComponent &first, const GaussianComponent &second) { return first.mean < second.mean; });
+
+    std::vector<GaussianComponent> merged;
+    for (const GaussianComponent &component : sorted)
+    {
+        if (merged.empty() || !(component.mean - merged.back().mean < mzMergingThreshold))
+        {
+            merged.push_back(component);
+            continue;
+        }
+        // variance of the mixture is the weighted mean of variances around the merged mean
+        GaussianComponent &group = merged.back();
+        const DataType weight = group.weight + component.weight;
+        if (!(weight > 0.0))
+        {
+            continue;
+        }
+        const DataType mean = (group.weight * group.mean + component.weight * component.mean) / weight;
+        const DataType groupShift = group.mean - mean;
+        const DataType componentShift = component.mean - mean;
+        const DataType variance = (group.weight * (group.deviation * group.deviation + groupShift * groupShift)
+            + component.weight * (component.deviation * component.deviation + componentShift * componentShift)) / weight;
+        group = { mean, sqrt(variance), weight };
+    }
+    return merged;
+}
+
+/// <summary>
+/// Removes components of negligible weight, of deviation narrower than given one,
+/// or with parameters not being finite numbers. Weights of remaining components
+/// are normalized to sum up to one.
+/// </summary>
+/// <param name="components">Components to be pruned.</param>
+/// <param name="minWeight">Weight, relative to the total one, below which components are removed.</param>
+/// <param name="minDeviation">Deviation, below which components are removed.</param>
+/// <returns>Remaining components, in the original order. Empty, when none remains.</returns>
+inline std::vector<GaussianComponent> PruneComponents(const std::vector<GaussianComponent> &components,
+                                                      DataType minWeight, DataType minDeviation)
+{
+    DataType totalWeight = 0.0;
+    for (const GaussianComponent &component : components)
+    {
+        if (isfinite(component.weight))
+        {
+            totalWeight += component.weight;
+        }
+    }
+
+    std::vector<GaussianComponent> pruned;
+    DataType remainingWeight = 0.0;
+    for (const GaussianComponent &component : components)
+    {
+        if (isfinite(component.mean) && isfinite(component.deviation) && isfinite(component.weight)
+            && component.weight > minWeight * totalWeight && component.deviation >= minDeviation
+            && component.deviation > 0.0)
+        {
+            pruned.push_back(component);
+            remainingWeight += component.weight;
+        }
+    }
+    for (GaussianComponent &component : pruned)
+    {
+        component.weight /= remainingWeight;
+    }
+    return pruned;
+}
+
+/// <summary>
+/// Class reduces number of components of a fitted model by removing negligible
+/// components and merging close ones. Reduced components are then used to
+/// warm-start a few iterations of the algorithm, which recover the fit lost
+/// by merging. Fewer components make projection of spectra onto the model
+/// proportionally faster.
+/// </summary>
+/// <param name="IterationRunner">Class performing whole iteration of the em algorithm,
+/// constructed from m/z values, intensities, size and components.</param>
+template <typename IterationRunner = FusedIterationRunner>
+class ComponentReduction
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with data the model was fitted to.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="mzMergingThreshold">Distance between means, below which components are merged.
+    /// 0 disables merging.</param>
+    /// <param name="minWeight">Weight, relative to the total one, below which components are removed.</param>
+    /// <param name="minDeviation">Deviation, below which components are removed. Defaults
+    /// to half of the mean distance between consecutive m/z values.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when mzMergingThreshold is negative</exception>
+    ComponentReduction(DataType *mzArray, DataType *intensities, unsigned size, DataType mzMergingThreshold,
+                       DataType minWeight = DEFAULT_MIN_COMPONENT_WEIGHT, DataType minDeviation = 0.0)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size),
+          m_MzMergingThreshold(mzMergingThreshold), m_MinWeight(minWeight), m_MinDeviation(minDeviation)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        if (!(mzMergingThreshold >= 0.0))
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<DataType>(
+                "mzMergingThreshold", 0.0, std::numeric_limits<DataType>::max(), mzMergingThreshold);
+        }
+
+        if (m_MinDeviation == 0.0 && size > 1)
+        {
+            const auto range = std::minmax_element(mzArray, mzArray + size);
+            m_MinDeviation = 0.5 * (*range.second - *range.first) / (size - 1);
+        }
+    }
+
+    /// <summary>
+    /// Prunes and merges the components, refines them with a few iterations
+    /// and prunes components which collapsed during the refinement.
+    /// </summary>
+    /// <param name="components">Components of the fitted model.</param>
+    /// <param name="refinementIterations">Number of iterations refining the reduced components.</param>
+    /// <returns>Model of reduced components, sorted by means.</returns>
+    GaussianMixtureModel Reduce(const std::vector<GaussianComponent> &components,
+                                unsigned refinementIterations = DEFAULT_REFINEMENT_ITERATIONS) const
+    {
+        std::vector<GaussianComponent> reduced = PruneComponents(components, m_MinWeight, m_MinDeviation);
+        reduced = MergeComponents(reduced, m_MzMergingThreshold);
+
+        if (!reduced.empty() && refinementIterations > 0)
+        {
+            IterationRunner iteration(m_pMzArray, m_pIntensities, m_DataSize, reduced);
+            for (unsigned i = 0; i < refinementIterations; i++)
+            {
+                iteration.Iterate();
+            }
+            reduced = PruneComponents(reduced, m_MinWeight, m_MinDeviation);
+        }
+
+        return GaussianMixtureModel(
+            gsl::span<DataType>(m_pMzArray, m_DataSize),
+            gsl::span<DataType>(m_pIntensities, m_DataSize),
+            std::move(reduced), m_MzMergingThreshold, m_MzMergingThreshold > 0.0, true
+        );
+    }
+
+    /// <summary>
+    /// Reduces components of the fitted model.
+    /// </summary>
+    /// <param name="model">Fitted model.</param>
+    /// <param name="refinementIterations">Number of iterations refining the reduced components.</param>
+    /// <returns>Model of reduced components, sorted by means.</returns>
+    GaussianMixtureModel Reduce(const GaussianMixtureModel &model,
+                                unsigned refinementIterations = DEFAULT_REFINEMENT_ITERATIONS) const
+    {
+        return Reduce(model.components, refinementIterations);
+    }
+
+private:
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    DataType m_MzMergingThreshold;
+    DataType m_MinWeight;
+    DataType m_MinDeviation;
+};
+}
@@ -0,0 +1,214 @@
+/*
+ * CompressedExpectationMaximization.h
+ * Provides implementation of Expectation Maximization algorithm
+ * run on the spectrum stripped of zero intensities and with
+ * adjacent m/z bins coalesced.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <limits>
+#include <vector>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/ConvergenceMonitor.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/FusedExpectationMaximization.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/RandomInitializationRef.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Spectrum reduced to weighted representatives of its m/z bins.
+/// </summary>
+struct CompressedSpectrum
+{
+    /// <summary>
+    /// M/z values of the representatives, in ascending order.
+    /// </summary>
+    std::vector<DataType> mzs;
+
+    /// <summary>
+    /// Total intensities of the bins each representative stands for.
+    /// </summary>
+    std::vector<DataType> intensities;
+};
+
+/// <summary>
+/// Compresses the spectrum by dropping points of zero intensity and by
+/// coalescing consecutive remaining points into groups, which span no more
+/// than mzTolerance. Each group is represented by a single point at its
+/// intensity-weighted mean m/z, carrying the total intensity of the group.
+/// </summary>
+/// <param name="mzArray">Array of m/z values, in ascending order.</param>
+/// <param name="intensities">Set of corresponding non-negative mean intensities values.</param>
+/// <param name="size">Size of the mzArray and itensities arrays.</param>
+/// <param name="mzTolerance">Greatest m/z span of coalesced points. 0 only drops zeros.</param>
+/// <returns>Compressed spectrum.</returns>
+inline CompressedSpectrum CompressSpectrum(const DataType *mzArray, const DataType *intensities, unsigned size,
+                                           DataType mzTolerance)
+{
+    CompressedSpectrum compressed;
+    DataType groupBegin = 0.0;
+    DataType groupIntensity = 0.0;
+    DataType groupMoment = 0.0;
+    for (unsigned i = 0; i < size; i++)
+    {
+        if (intensities[i] == 0.0)
+        {
+            continue;
+        }
+        if (groupIntensity != 0.0 && mzArray[i] - groupBegin > mzTolerance)
+        {
+            compressed.mzs.push_back(groupMoment / groupIntensity);
+            compressed.intensities.push_back(groupIntensity);
+            groupIntensity = 0.0;
+            groupMoment = 0.0;
+        }
+        if (groupIntensity == 0.0)
+        {
+            groupBegin = mzArray[i];
+        }
+        groupIntensity += intensities[i];
+        groupMoment += intensities[i] * mzArray[i];
+    }
+    if (groupIntensity != 0.0)
+    {
+        compressed.mzs.push_back(groupMoment / groupIntensity);
+        compressed.intensities.push_back(groupIntensity);
+    }
+    return compressed;
+}
+
+/// <summary>
+/// Class runs Expectation Maximization algorithm on the compressed spectrum,
+/// so the O(N*K) work of each iteration is done for the representatives only.
+/// </summary>
+/// <remarks>
+/// Dropping zero intensities is exact: such points contribute to none of the
+/// estimated parameters. Coalescing is approximate. Given responsibilities,
+/// the representative at the weighted mean preserves the total weight and the
+/// first moment of its group, while the variance of the group around its mean,
+/// at most mzTolerance^2 / 4, is lost. Each estimated variance is therefore
+/// underestimated by at most mzTolerance^2 / 4. Responsibilities themselves
+/// are evaluated at the representative instead of at each point, which changes
+/// log density of component k by at most
+/// mzTolerance * |mz - mean_k| / deviation_k^2 + mzTolerance^2 / (2 * deviation_k^2).
+/// Hence the tolerance should be kept well below the narrowest expected deviation.
+/// Log likelihood reported by the algorithm refers to the compressed spectrum.
+/// </remarks>
+/// <param name="ExpectationMaximizationAlgorithm">Class performing a single run of the algorithm,
+/// constructible like ExpectationMaximization.</param>
+template <typename ExpectationMaximizationAlgorithm = FusedExpectationMaximization<RandomInitializationRef>>
+class CompressedExpectationMaximization
+{
+public:
+    /// <summary>
+    /// Constructor compressing the spectrum and initializing the algorithm with it.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values, in ascending order.</param>
+    /// <param name="intensities">Set of corresponding non-negative mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="rngEngine">Mersenne-Twister engine to be used during initialization step.</param>
+    /// <param name="numberOfComponents">Number of Gaussian components that build up the approximation.</param>
+    /// <param name="mzTolerance">Greatest m/z span of coalesced points. 0 only drops zeros.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when mzTolerance is negative</exception>
+    CompressedExpectationMaximization(DataType *mzArray, DataType *intensities, const unsigned size,
+                                      RandomNumberGenerator &rngEngine, const unsigned numberOfComponents = 2,
+                                      DataType mzTolerance = 0.0)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size)
+          , m_Compressed(Compress(mzArray, intensities, size, mzTolerance))
+          , m_Algorithm(m_Compressed.mzs.data(), m_Compressed.intensities.data(),
+                        (unsigned)m_Compressed.mzs.size(), rngEngine, numberOfComponents)
+    {
+    }
+
+    /// <summary>
+    /// Sets conditions stopping the iterations of the next runs.
+    /// </summary>
+    /// <param name="criteria">Conditions stopping the iterations.</param>
+    void SetConvergenceCriteria(const ConvergenceCriteria &criteria)
+    {
+        m_Algorithm.SetConvergenceCriteria(criteria);
+    }
+
+    /// <summary>
+    /// Gets summary of the last run.
+    /// </summary>
+    /// <returns>Summary of the last run.</returns>
+    ConvergenceReport GetConvergenceReport() const
+    {
+        return m_Algorithm.GetConvergenceReport();
+    }
+
+    /// <summary>
+    /// Gets number of points the algorithm is run on.
+    /// </summary>
+    /// <returns>Size of the compressed spectrum.</returns>
+    unsigned CompressedSize() const
+    {
+        return (unsigned)m_Compressed.mzs.size();
+    }
+
+    /// <summary>
+    /// Performs a full algorithm run on the compressed spectrum.
+    /// </summary>
+    /// <returns>
+    /// Gaussian Mixture Model containing all the components with their appropriate
+    /// parameters, along with the original, uncompressed spectrum.
+    /// </returns>
+    GaussianMixtureModel EstimateGmm()
+    {
+        GaussianMixtureModel model = m_Algorithm.EstimateGmm();
+        return GaussianMixtureModel(
+            gsl::span<DataType>(m_pMzArray, m_DataSize),
+            gsl::span<DataType>(m_pIntensities, m_DataSize),
+            std::move(model.components)
+        );
+    }
+
+private:
+    static CompressedSpectrum Compress(DataType *mzArray, DataType *intensities, unsigned size,
+                                       DataType mzTolerance)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        if (!(mzTolerance >= 0.0))
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<DataType>(
+                "mzTolerance", 0.0, std::numeric_limits<DataType>::max(), mzTolerance);
+        }
+
+        return CompressSpectrum(mzArray, intensities, size, mzTolerance);
+    }
+
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    CompressedSpectrum m_Compressed;
+    ExpectationMaximizationAlgorithm m_Algorithm;
+};
+}
@@ -0,0 +1,276 @@
+/*
+ * ConvergenceMonitor.h
+ * Provides stop conditions of Expectation Maximization algorithm
+ * and per-iteration telemetry of its runs.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Default absolute change of log likelihood, below which iterations stop.
+/// </summary>
+constexpr DataType DEFAULT_ABSOLUTE_TOLERANCE = 0.00000001;
+
+/// <summary>
+/// Telemetry of a single iteration of the algorithm.
+/// </summary>
+struct IterationRecord
+{
+    /// <summary>
+    /// Number of the iteration, starting from 1.
+    /// </summary>
+    unsigned iteration;
+
+    /// <summary>
+    /// Log likelihood computed in the iteration. Fused runs compute it
+    /// for the components from before the iteration.
+    /// </summary>
+    DataType logLikelihood;
+
+    /// <summary>
+    /// Time of expectation step, in seconds. Fused runs report here
+    /// the time of the whole iteration.
+    /// </summary>
+    double expectationSeconds;
+
+    /// <summary>
+    /// Time of maximization step, in seconds.
+    /// </summary>
+    double maximizationSeconds;
+
+    /// <summary>
+    /// Time of log likelihood calculation, in seconds.
+    /// </summary>
+    double logLikelihoodSeconds;
+
+    /// <summary>
+    /// Number of components of no weight, or deviation narrower than half
+    /// of the mean distance between consecutive m/z values.
+    /// </summary>
+    unsigned collapsedComponents;
+};
+
+/// <summary>
+/// Conditions stopping the iterations. The run stops on whichever is met first.
+/// </summary>
+struct ConvergenceCriteria
+{
+    /// <summary>
+    /// Change of log likelihood, below which iterations stop.
+    /// </summary>
+    DataType absoluteTolerance = DEFAULT_ABSOLUTE_TOLERANCE;
+
+    /// <summary>
+    /// Change of log likelihood relative to its magnitude, below which iterations stop.
+    /// 0 disables the condition.
+    /// </summary>
+    DataType relativeTolerance = 0.0;
+
+    /// <summary>
+    /// Maximal number of iterations. 0 means no limit.
+    /// </summary>
+    unsigned maxIterations = 0;
+
+    /// <summary>
+    /// Time after which iterations stop, in seconds, not counting initialization.
+    /// 0 means no limit.
+    /// </summary>
+    double timeBudget = 0.0;
+
+    /// <summary>
+    /// Optional callback receiving telemetry of each iteration.
+    /// </summary>
+    std::function<void(const IterationRecord &)> onIteration;
+};
+
+/// <summary>
+/// Reason, for which iterations stopped.
+/// </summary>
+enum class StopReason
+{
+    Converged,
+    MaxIterations,
+    TimeBudget,
+    NotFinite
+};
+
+/// <summary>
+/// Summary of a run of the algorithm.
+/// </summary>
+struct ConvergenceReport
+{
+    /// <summary>
+    /// Number of iterations performed.
+    /// </summary>
+    unsigned iterations;
+
+    /// <summary>
+    /// Log likelihood computed in the last iteration.
+    /// </summary>
+    DataType logLikelihood;
+
+    /// <summary>
+    /// Reason, for which iterations stopped.
+    /// </summary>
+    StopReason reason;
+
+    /// <summary>
+    /// Time of all the iterations, in seconds.
+    /// </summary>
+    double seconds;
+};
+
+/// <summary>
+/// Class tracks iterations of a single run against the convergence criteria.
+/// </summary>
+class ConvergenceMonitor
+{
+public:
+    /// <summary>
+    /// Constructor starting the clock of the run.
+    /// </summary>
+    /// <param name="criteria">Conditions stopping the iterations.</param>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="size">Size of the mzArray.</param>
+    /// <param name="components">Components updated by the run.</param>
+    ConvergenceMonitor(const ConvergenceCriteria &criteria, const DataType *mzArray, unsigned size,
+                       const std::vector<GaussianComponent> &components)
+        : m_Criteria(criteria), m_Components(components), m_MinDeviation(0.0), m_Iterations(0)
+          , m_HasLikelihood(false), m_Likelihood(0.0), m_Reason(StopReason::Converged)
+          , m_Start(Clock::now()), m_LapStart(m_Start)
+    {
+        if (m_Criteria.onIteration && size > 1)
+        {
+            const auto range = std::minmax_element(mzArray, mzArray + size);
+            m_MinDeviation = 0.5 * (*range.second - *range.first) / (size - 1);
+        }
+    }
+
+    /// <summary>
+    /// Sets log likelihood of the initial components, which the first iteration is compared to.
+    /// </summary>
+    /// <param name="likelihood">Log likelihood of the initial components.</param>
+    void SetInitialLikelihood(DataType likelihood)
+    {
+        m_Likelihood = likelihood;
+        m_HasLikelihood = true;
+    }
+
+    /// <summary>
+    /// Measures time since the previous call, or construction.
+    /// </summary>
+    /// <returns>Time, in seconds.</returns>
+    double Lap()
+    {
+        const Clock::time_point now = Clock::now();
+        const double seconds = std::chrono::duration<double>(now - m_LapStart).count();
+        m_LapStart = now;
+        return seconds;
+    }
+
+    /// <summary>
+    /// Records finished iteration and checks the stop conditions.
+    /// </summary>
+    /// <param name="likelihood">Log likelihood computed in the iteration.</param>
+    /// <param name="expectationSeconds">Time of expectation step, in seconds.</param>
+    /// <param name="maximizationSeconds">Time of maximization step, in seconds.</param>
+    /// <param name="logLikelihoodSeconds">Time of log likelihood calculation, in seconds.</param>
+    /// <returns>True, when the next iteration should be performed.</returns>
+    bool Continue(DataType likelihood, double expectationSeconds, double maximizationSeconds,
+                  double logLikelihoodSeconds)
+    {
+        m_Iterations++;
+        if (m_Criteria.onIteration)
+        {
+            m_Criteria.onIteration({ m_Iterations, likelihood, expectationSeconds, maximizationSeconds,
+                                     logLikelihoodSeconds, CountCollapsedComponents() });
+        }
+
+        // likelihood, which is not finite, is not compared to
+        const bool hadLikelihood = m_HasLikelihood && isfinite(m_Likelihood);
+        const DataType change = fabs(m_Likelihood - likelihood);
+        m_Likelihood = likelihood;
+        m_HasLikelihood = true;
+        if (!isfinite(likelihood))
+        {
+            m_Reason = StopReason::NotFinite;
+            return false;
+        }
+        if (hadLikelihood && (change <= m_Criteria.absoluteTolerance
+                              || change <= m_Criteria.relativeTolerance * fabs(likelihood)))
+        {
+            m_Reason = StopReason::Converged;
+            return false;
+        }
+        if (m_Criteria.maxIterations != 0 && m_Iterations >= m_Criteria.maxIterations)
+        {
+            m_Reason = StopReason::MaxIterations;
+            return false;
+        }
+        if (m_Criteria.timeBudget > 0.0
+            && std::chrono::duration<double>(Clock::now() - m_Start).count() >= m_Criteria.timeBudget)
+        {
+            m_Reason = StopReason::TimeBudget;
+            return false;
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// Summarizes the run so far.
+    /// </summary>
+    /// <returns>Summary of the run.</returns>
+    ConvergenceReport Report() const
+    {
+        return { m_Iterations, m_Likelihood, m_Reason, std::chrono::duration<double>(Clock::now() - m_Start).count() };
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    unsigned CountCollapsedComponents() const
+    {
+        unsigned collapsed = 0;
+        for (const GaussianComponent &component : m_Components)
+        {
+            if (!(component.weight > 0.0) || !(component.deviation >= m_MinDeviation))
+            {
+                collapsed++;
+            }
+        }
+        return collapsed;
+    }
+
+    const ConvergenceCriteria &m_Criteria;
+    const std::vector<GaussianComponent> &m_Components;
+    DataType m_MinDeviation;
+    unsigned m_Iterations;
+    bool m_HasLikelihood;
+    DataType m_Likelihood;
+    StopReason m_Reason;
+    Clock::time_point m_Start;
+    Clock::time_point m_LapStart;
+};
+}
@@ -21,6 +21,7 @@ limitations under the License.
 #pragma once
 #include <random>
 #include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/ConvergenceMonitor.h"
 #include "Spectre.libGaussianMixtureModelling/DataType.h"
 #include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
 #include "Spectre.libGaussianMixtureModelling/Matrix.h"
@@ -35,9 +36,12 @@ namespace spectre::unsupervised::gmm
 /// for the purpose of Guassian Mixture Modelling of the
 /// spectral data.
 /// </summary>
-/// <param name="InitializationRunner">Class performing Initialization step of the em algorithm.</param>
+/// <param name="InitializationRunner">Class performing Initialization step of the em algorithm, constructed
+/// from m/z values, intensities, size, components and random number generator.</param>
 /// <param name="ExpectationRunner">Class performing expectation step of the em algorithm.</param>
-/// <param name="MaximizationRunner">Class performing maximization step of the em algorithm.</param>
+/// <param name="MaximizationRunner">Class performing maximization step of the em algorithm. Its
+/// AFFILATION_LAYOUT determines layout of the affilation matrix, as the matrix is read thrice
+/// in maximization step and written once in expectation step.</param>
 /// <param name="LogLikelihoodCalculator">Class performing log likelihood of resulting calculation.</param>
 template <typename InitializationRunner, typename ExpectationRunner, typename MaximizationRunner, typename LogLikelihoodCalculator>
 class ExpectationMaximization
@@ -55,8 +59,9 @@ public:
     ExpectationMaximization(DataType *mzArray, DataType *intensities, const unsigned size,
                             RandomNumberGenerator &rngEngine, const unsigned numberOfComponents = 2)
         : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size), m_Components(numberOfComponents)
-          , m_AffilationMatrix(numberOfComponents, size)
-          , m_Initialization(mzArray, size, m_Components, rngEngine)
+          , m_Convergence(), m_Report()
+          , m_AffilationMatrix(numberOfComponents, size, MaximizationRunner::AFFILATION_LAYOUT)
+          , m_Initialization(mzArray, intensities, size, m_Components, rngEngine)
           , m_Expectation(mzArray, size, m_AffilationMatrix, m_Components)
           , m_Maximization(mzArray, intensities, size, m_AffilationMatrix, m_Components)
           , m_LogLikelihoodCalculator(mzArray, intensities, size, m_Components)
@@ -73,8 +78,59 @@ public:
     }
 
     /// <summary>
-    /// Performs a full algorithm run. Terminates when change in log likelihood
-    /// is sufficiently small (lower than  0.00000001).
+    /// Constructor presetting the components, which is used for warm start
+    /// with PresetInitialization, e.g. from components of a model estimated
+    /// for a previous version of the data.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="rngEngine">Mersenne-Twister engine to be used during initialization step.</param>
+    /// <param name="initialComponents">Components the algorithm starts with.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    ExpectationMaximization(DataType *mzArray, DataType *intensities, const unsigned size,
+                            RandomNumberGenerator &rngEngine, const std::vector<GaussianComponent> &initialComponents)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size), m_Components(initialComponents)
+          , m_Convergence(), m_Report()
+          , m_AffilationMatrix((unsigned)initialComponents.size(), size, MaximizationRunner::AFFILATION_LAYOUT)
+          , m_Initialization(mzArray, intensities, size, m_Components, rngEngine)
+          , m_Expectation(mzArray, size, m_AffilationMatrix, m_Components)
+          , m_Maximization(mzArray, intensities, size, m_AffilationMatrix, m_Components)
+          , m_LogLikelihoodCalculator(mzArray, intensities, size, m_Components)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+    }
+
+    /// <summary>
+    /// Sets conditions stopping the iterations of the next runs. By default,
+    /// iterations stop when change in log likelihood is lower than 0.00000001.
+    /// </summary>
+    /// <param name="criteria">Conditions stopping the iterations.</param>
+    void ExpectationMaximization::SetConvergenceCriteria(const ConvergenceCriteria &criteria)
+    {
+        m_Convergence = criteria;
+    }
+
+    /// <summary>
+    /// Gets summary of the last run.
+    /// </summary>
+    /// <returns>Summary of the last run.</returns>
+    ConvergenceReport ExpectationMaximization::GetConvergenceReport() const
+    {
+        return m_Report;
+    }
+
+    /// <summary>
+    /// Performs a full algorithm run. Terminates when any of the convergence
+    /// criteria is met.
     /// </summary>
     /// <returns>
     /// Gaussian Mixture Model containing all the components with their appropriate
@@ -82,19 +138,24 @@ public:
     /// </returns>
     GaussianMixtureModel ExpectationMaximization::EstimateGmm()
     {
-        constexpr DataType MIN_LIKELIHOOD_CHANGE = 0.00000001;
         Initialization();
 
-        DataType oldLikelihood; // used as iterations terminator
-        DataType newLikelihood = m_LogLikelihoodCalculator.CalculateLikelihood();
+        ConvergenceMonitor monitor(m_Convergence, m_pMzArray, m_DataSize, m_Components);
+        monitor.SetInitialLikelihood(m_LogLikelihoodCalculator.CalculateLikelihood());
+        DataType likelihood;
+        double expectationSeconds, maximizationSeconds, logLikelihoodSeconds;
         do
         {
+            monitor.Lap();
             Expectation();
-            oldLikelihood = newLikelihood;
+            expectationSeconds = monitor.Lap();
             Maximization();
-            newLikelihood = m_LogLikelihoodCalculator.CalculateLikelihood();
+            maximizationSeconds = monitor.Lap();
+            likelihood = m_LogLikelihoodCalculator.CalculateLikelihood();
+            logLikelihoodSeconds = monitor.Lap();
         }
-        while (abs(oldLikelihood - newLikelihood) > MIN_LIKELIHOOD_CHANGE);
+        while (monitor.Continue(likelihood, expectationSeconds, maximizationSeconds, logLikelihoodSeconds));
+        m_Report = monitor.Report();
 
         return GaussianMixtureModel(
             gsl::span<DataType>(m_pMzArray, m_DataSize),
@@ -128,6 +189,8 @@ private:
     DataType *m_pIntensities;
     unsigned m_DataSize;
     std::vector<GaussianComponent> m_Components;
+    ConvergenceCriteria m_Convergence;
+    ConvergenceReport m_Report;
 
     InitializationRunner m_Initialization;
     ExpectationRunner m_Expectation;
@@ -0,0 +1,381 @@
+/*
+ * ExpectationMaximizationScheduler.h
+ * Provides asynchronous estimation of many Gaussian Mixture Models
+ * on a shared pool of threads.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libException/OperationCancelledException.h"
+#include "Spectre.libGaussianMixtureModelling/ConvergenceMonitor.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/FusedExpectationMaximization.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/KMeansPlusPlusInitialization.h"
+#include "Spectre.libGaussianMixtureModelling/StreamingIterationRunner.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Handle of a model estimation submitted to ExpectationMaximizationScheduler.
+/// </summary>
+class EstimationJob
+{
+public:
+    /// <summary>
+    /// Constructor binding the handle to the result and cancellation flag of the job.
+    /// </summary>
+    /// <param name="model">Future result of the job.</param>
+    /// <param name="cancelled">Flag set on cancellation of the job.</param>
+    EstimationJob(std::future<GaussianMixtureModel> &&model, std::shared_ptr<std::atomic<bool>> cancelled)
+        : m_Model(std::move(model)), m_Cancelled(std::move(cancelled))
+    {
+    }
+
+    /// <summary>
+    /// Waits for the job to finish and returns the estimated model. May be called once.
+    /// </summary>
+    /// <returns>Estimated model.</returns>
+    /// <exception cref="OperationCancelledException">Thrown when the job was cancelled.</exception>
+    GaussianMixtureModel Get()
+    {
+        return m_Model.get();
+    }
+
+    /// <summary>
+    /// Waits for the job to finish, either way.
+    /// </summary>
+    void Wait() const
+    {
+        m_Model.wait();
+    }
+
+    /// <summary>
+    /// Checks whether the job finished, either way.
+    /// </summary>
+    /// <returns>True, when the result is available.</returns>
+    bool IsReady() const
+    {
+        return m_Model.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    /// <summary>
+    /// Cancels the job. Waiting job is not started at all, running one
+    /// stops after its current iteration. Finished job is not affected.
+    /// </summary>
+    void Cancel()
+    {
+        *m_Cancelled = true;
+    }
+
+private:
+    std::future<GaussianMixtureModel> m_Model;
+    std::shared_ptr<std::atomic<bool>> m_Cancelled;
+};
+
+/// <summary>
+/// Class runs estimations of Gaussian Mixture Models for many datasets at
+/// once, on a fixed pool of threads shared by all of them. Jobs are started
+/// in order of submission, each on a single pool thread. Data of every job
+/// is split into the same, fixed number of chunks, so that the estimated
+/// model does not depend on load of the pool. Only the number of threads
+/// processing the chunks is elastic: parallel loops inside a job are given
+/// an equal share of the pool, i.e. size of the pool divided by number of
+/// jobs running or waiting, which is recomputed after each iteration.
+/// Threads given to all the running jobs never exceed size of the pool,
+/// so that the cores are not oversubscribed, whether there are few large
+/// jobs or many small ones.
+/// </summary>
+/// <param name="ExpectationMaximizationAlgorithm">Class performing a single run of the algorithm,
+/// constructible like ExpectationMaximization followed by number of chunks of parallel
+/// loops, e.g. FusedExpectationMaximization with StreamingIterationRunner, and accepting
+/// ConvergenceCriteria.</param>
+template <typename ExpectationMaximizationAlgorithm =
+              FusedExpectationMaximization<KMeansPlusPlusInitialization, StreamingIterationRunner>>
+class ExpectationMaximizationScheduler
+{
+public:
+    /// <summary>
+    /// Constructor starting the pool of threads.
+    /// </summary>
+    /// <param name="numberOfThreads">Size of the pool. 0 stands for the number of hardware threads.</param>
+    /// <param name="numberOfChunks">Number of chunks data of each job is split into.
+    /// 0 stands for size of the pool.</param>
+    explicit ExpectationMaximizationScheduler(unsigned numberOfThreads = 0, unsigned numberOfChunks = 0)
+        : m_NumberOfThreads(numberOfThreads != 0 ? numberOfThreads
+                                                 : std::max(1u, std::thread::hardware_concurrency()))
+          , m_NumberOfChunks(numberOfChunks != 0 ? numberOfChunks : m_NumberOfThreads)
+          , m_Running(0), m_ThreadsInUse(0), m_Stopping(false)
+    {
+        for (unsigned i = 0; i < m_NumberOfThreads; i++)
+        {
+            m_Workers.emplace_back([this]() { Work(); });
+        }
+    }
+
+    ExpectationMaximizationScheduler(const ExpectationMaximizationScheduler &) = delete;
+    ExpectationMaximizationScheduler &operator=(const ExpectationMaximizationScheduler &) = delete;
+
+    /// <summary>
+    /// Destructor cancelling all the jobs not finished yet and waiting for the pool to stop.
+    /// </summary>
+    ~ExpectationMaximizationScheduler()
+    {
+        std::deque<Task> abandoned;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+            abandoned.swap(m_Queue);
+            for (const std::shared_ptr<std::atomic<bool>> &cancelled : m_RunningFlags)
+            {
+                *cancelled = true;
+            }
+        }
+        m_WorkAvailable.notify_all();
+        m_ThreadsReleased.notify_all();
+        for (Task &task : abandoned)
+        {
+            Abandon(task);
+        }
+        for (std::thread &worker : m_Workers)
+        {
+            worker.join();
+        }
+    }
+
+    /// <summary>
+    /// Submits estimation of the model. Arrays have to be kept alive until the job finishes.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="numberOfComponents">Number of Gaussian components that build up the approximation.</param>
+    /// <param name="seed">Seed of the random number generator used for initialization.</param>
+    /// <param name="criteria">Conditions stopping the iterations.</param>
+    /// <returns>Handle of the job.</returns>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    EstimationJob Submit(DataType *mzArray, DataType *intensities, unsigned size, unsigned numberOfComponents,
+                         uint64_t seed, const ConvergenceCriteria &criteria = ConvergenceCriteria())
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        Task task { mzArray, intensities, size, numberOfComponents, seed, criteria,
+                    std::promise<GaussianMixtureModel>(), std::make_shared<std::atomic<bool>>(false) };
+        EstimationJob job(task.model.get_future(), task.cancelled);
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Queue.push_back(std::move(task));
+        }
+        m_WorkAvailable.notify_one();
+        return job;
+    }
+
+    /// <summary>
+    /// Gets size of the pool.
+    /// </summary>
+    /// <returns>Number of threads.</returns>
+    unsigned NumberOfThreads() const
+    {
+        return m_NumberOfThreads;
+    }
+
+    /// <summary>
+    /// Gets number of chunks data of each job is split into.
+    /// </summary>
+    /// <returns>Number of chunks.</returns>
+    unsigned NumberOfChunks() const
+    {
+        return m_NumberOfChunks;
+    }
+
+    /// <summary>
+    /// Gets number of threads given to parallel loops of the running jobs.
+    /// </summary>
+    /// <returns>Number of threads, at most size of the pool.</returns>
+    unsigned ThreadsInUse()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_ThreadsInUse;
+    }
+
+private:
+    struct Task
+    {
+        DataType *mzArray;
+        DataType *intensities;
+        unsigned size;
+        unsigned numberOfComponents;
+        uint64_t seed;
+        ConvergenceCriteria criteria;
+        std::promise<GaussianMixtureModel> model;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+    };
+
+    void Work()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        while (true)
+        {
+            m_WorkAvailable.wait(lock, [this]() { return m_Stopping || !m_Queue.empty(); });
+            if (m_Stopping)
+            {
+                return;
+            }
+            Task task = std::move(m_Queue.front());
+            m_Queue.pop_front();
+            if (*task.cancelled)
+            {
+                lock.unlock();
+                Abandon(task);
+                lock.lock();
+                continue;
+            }
+            m_Running++;
+            m_RunningFlags.push_back(task.cancelled);
+            m_ThreadsReleased.wait(lock, [this, &task]()
+            {
+                return *task.cancelled || m_ThreadsInUse < m_NumberOfThreads;
+            });
+            unsigned numberOfThreads = 0;
+            if (!*task.cancelled)
+            {
+                // more threads than chunks would have nothing to do
+                const unsigned share = std::min(m_NumberOfChunks, FairShare());
+                numberOfThreads = std::min(share, m_NumberOfThreads - m_ThreadsInUse);
+                m_ThreadsInUse += numberOfThreads;
+                lock.unlock();
+                Run(task, numberOfThreads);
+                lock.lock();
+            }
+            else
+            {
+                lock.unlock();
+                Abandon(task);
+                lock.lock();
+            }
+
+            m_Running--;
+            m_ThreadsInUse -= numberOfThreads;
+            m_RunningFlags.erase(std::find(m_RunningFlags.begin(), m_RunningFlags.end(), task.cancelled));
+            m_ThreadsReleased.notify_all();
+        }
+    }
+
+    unsigned FairShare() const
+    {
+        return std::max(1u, m_NumberOfThreads / (m_Running + (unsigned)m_Queue.size()));
+    }
+
+    // Moves number of threads of a running job towards its current fair share,
+    // taking only threads released by the other jobs.
+    void Rebalance(unsigned &numberOfThreads)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            const unsigned share = std::min(m_NumberOfChunks, FairShare());
+            const unsigned free = m_NumberOfThreads - m_ThreadsInUse;
+            const unsigned granted = share > numberOfThreads ? std::min(share, numberOfThreads + free) : share;
+            m_ThreadsInUse = m_ThreadsInUse - numberOfThreads + granted;
+            numberOfThreads = granted;
+        }
+        m_ThreadsReleased.notify_all();
+#ifdef _OPENMP
+        omp_set_num_threads((int)numberOfThreads);
+#endif
+    }
+
+    void Run(Task &task, unsigned &numberOfThreads)
+    {
+        try
+        {
+#ifdef _OPENMP
+            omp_set_num_threads((int)numberOfThreads);
+#endif
+            // cancellation is checked after each iteration, through the iteration callback
+            ConvergenceCriteria criteria = task.criteria;
+            const std::shared_ptr<std::atomic<bool>> cancelled = task.cancelled;
+            const std::function<void(const IterationRecord &)> onIteration = task.criteria.onIteration;
+            criteria.onIteration = [this, cancelled, onIteration, &numberOfThreads](
+                const IterationRecord &record)
+            {
+                if (onIteration)
+                {
+                    onIteration(record);
+                }
+                if (*cancelled)
+                {
+                    throw spectre::core::exception::OperationCancelledException("Estimation was cancelled.");
+                }
+                Rebalance(numberOfThreads);
+            };
+
+            RandomNumberGenerator rngEngine(task.seed);
+            ExpectationMaximizationAlgorithm algorithm(task.mzArray, task.intensities, task.size, rngEngine,
+                                                       task.numberOfComponents, m_NumberOfChunks);
+            algorithm.SetConvergenceCriteria(criteria);
+            task.model.set_value(algorithm.EstimateGmm());
+        }
+        catch (...)
+        {
+            task.model.set_exception(std::current_exception());
+        }
+    }
+
+    static void Abandon(Task &task)
+    {
+        task.model.set_exception(std::make_exception_ptr(
+            spectre::core::exception::OperationCancelledException("Estimation was cancelled.")));
+    }
+
+    const unsigned m_NumberOfThreads;
+    const unsigned m_NumberOfChunks;
+    unsigned m_Running;
+    unsigned m_ThreadsInUse;
+    bool m_Stopping;
+    std::deque<Task> m_Queue;
+    std::vector<std::shared_ptr<std::atomic<bool>>> m_RunningFlags;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkAvailable;
+    std::condition_variable m_ThreadsReleased;
+    std::vector<std::thread> m_Workers;
+};
+}
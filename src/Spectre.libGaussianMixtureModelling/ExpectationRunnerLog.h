@@ -0,0 +1,127 @@
+/*
+ * ExpectationRunnerLog.h
+ * Provides numerically stable implementation of expectation step of
+ * Expectation Maximization algorithm used for Gaussian Mixture Modelling.
+ *
+ * Affilation of point x to component k is computed in log domain as
+ * exp(l_k(x) - log(sum_j(exp(l_j(x))))), where l_k(x) is logarithm of
+ * weighted density of component k, log-normalizer minus squared
+ * standardized distance halved. The sum is evaluated with log-sum-exp
+ * trick, i.e. with the greatest l_j(x) factored out, so it never underflows,
+ * even for points where densities of all the components are below
+ * the smallest representable double and reference runner yields 0 / 0.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <vector>
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/BlockwiseReduction.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianKernel.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/Matrix.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Class serves the purpose of expectation step of Expectation Maximization algorithm,
+/// computing affilations in log domain. Blocks of data points are processed in parallel.
+/// </summary>
+class ExpectationRunnerLog
+{
+public:
+    /// <summary>
+    /// Layout of affilation matrix, in which affilations to each component are written contiguously.
+    /// </summary>
+    static constexpr MatrixLayout AFFILATION_LAYOUT = MatrixLayout::RowMajor;
+
+    /// <summary>
+    /// Constructor initializing the class with data required during expectation step.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="affilationMatrix">Matrix symbolising the probability of affilation
+    /// of each sample to a certain gaussian component.</param>
+    /// <param name="components">Gaussian components.</param>
+    /// <exception cref="NullPointerException">Thrown when mzArray pointer is null</exception>
+    ExpectationRunnerLog(DataType *mzArray, unsigned size, Matrix &affilationMatrix,
+                         std::vector<GaussianComponent> &components)
+        : m_pMzArray(mzArray), m_DataSize(size), m_AffilationMatrix(affilationMatrix)
+          , m_Components(components)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+    }
+
+    /// <summary>
+    /// Fills affilation (gamma) matrix with probabilities of affilation of each sample
+    /// to a certain gaussian component.
+    /// </summary>
+    void Expectation()
+    {
+        if (m_AffilationMatrix.Layout() == MatrixLayout::RowMajor)
+        {
+            Expectation<MatrixLayout::RowMajor>();
+        }
+        else
+        {
+            Expectation<MatrixLayout::ColumnMajor>();
+        }
+    }
+
+private:
+    template <MatrixLayout Layout>
+    void Expectation()
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        m_KernelComponents.Assign(m_Components);
+        // affilations to all the components followed by logarithms of mixture density
+        m_Scratch.Reserve((numberOfComponents + 1) * KERNEL_BLOCK_SIZE);
+
+        const int numberOfBlocks = (int)((m_DataSize + KERNEL_BLOCK_SIZE - 1) / KERNEL_BLOCK_SIZE);
+        #pragma omp parallel
+        {
+            DataType *affilations = m_Scratch.Get();
+            DataType *logMixtureDensities = affilations + numberOfComponents * KERNEL_BLOCK_SIZE;
+
+            #pragma omp for schedule(static)
+            for (int block = 0; block < numberOfBlocks; block++)
+            {
+                const unsigned begin = (unsigned)block * KERNEL_BLOCK_SIZE;
+                const unsigned count = begin + KERNEL_BLOCK_SIZE < m_DataSize ? KERNEL_BLOCK_SIZE : m_DataSize - begin;
+                EvaluateLogMixture(m_pMzArray + begin, count, m_KernelComponents,
+                                   affilations, logMixtureDensities);
+                for (unsigned k = 0; k < numberOfComponents; k++)
+                {
+                    for (unsigned j = 0; j < count; j++)
+                    {
+                        m_AffilationMatrix.At<Layout>(k, begin + j) = affilations[k * KERNEL_BLOCK_SIZE + j];
+                    }
+                }
+            }
+        }
+    }
+
+    DataType *m_pMzArray;
+    unsigned m_DataSize;
+    Matrix &m_AffilationMatrix;
+    std::vector<GaussianComponent> &m_Components;
+    GaussianKernelComponents m_KernelComponents;
+    ThreadScratch m_Scratch;
+};
+}
@@ -0,0 +1,138 @@
+/*
+ * ExpectationRunnerOpt.h
+ * Provides optimized, parallel implementation of expectation part
+ * of EM algorithm used for Gaussian Mixture Modelling.
+ *
+ * For the mathematical background please refer to ExpectationRunnerRef.h,
+ * which this class is numerically equivalent to, up to the rounding errors.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianKernel.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/Matrix.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Class serves the purpose of expectation step of Expectation Maximization algorithm.
+/// Blocks of data points are processed in parallel, each Gaussian is evaluated once
+/// per point by the vectorized kernel and its normalization constant is computed
+/// once per component.
+/// </summary>
+class ExpectationRunnerOpt
+{
+public:
+    /// <summary>
+    /// Layout of affilation matrix, in which densities of each component are written contiguously.
+    /// </summary>
+    static constexpr MatrixLayout AFFILATION_LAYOUT = MatrixLayout::RowMajor;
+
+    /// <summary>
+    /// Constructor initializing the class with data required during expectation step.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="affilationMatrix">Matrix symbolising the probability of affilation
+    /// of each sample to a certain gaussian component.</param>
+    /// <param name="components">Gaussian components.</param>
+    /// <exception cref="NullPointerException">Thrown when mzArray pointer is null</exception>
+    ExpectationRunnerOpt(DataType *mzArray, unsigned size, Matrix &affilationMatrix,
+                         std::vector<GaussianComponent> &components)
+        : m_pMzArray(mzArray), m_DataSize(size), m_AffilationMatrix(affilationMatrix)
+          , m_Components(components)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+    }
+
+    /// <summary>
+    /// Fills affilation (gamma) matrix with probabilities of affilation of each sample
+    /// to a certain gaussian component.
+    /// </summary>
+    void Expectation()
+    {
+        if (m_AffilationMatrix.Layout() == MatrixLayout::RowMajor)
+        {
+            Expectation<MatrixLayout::RowMajor>();
+        }
+        else
+        {
+            Expectation<MatrixLayout::ColumnMajor>();
+        }
+    }
+
+private:
+    template <MatrixLayout Layout>
+    void Expectation()
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        m_KernelComponents.Assign(m_Components);
+
+        const int numberOfBlocks = (int)((m_DataSize + KERNEL_BLOCK_SIZE - 1) / KERNEL_BLOCK_SIZE);
+        #pragma omp parallel
+        {
+            std::vector<DataType> densities(KERNEL_BLOCK_SIZE);
+            std::vector<DataType> denominators(KERNEL_BLOCK_SIZE);
+
+            #pragma omp for schedule(static)
+            for (int block = 0; block < numberOfBlocks; block++)
+            {
+                const unsigned begin = (unsigned)block * KERNEL_BLOCK_SIZE;
+                const unsigned count = begin + KERNEL_BLOCK_SIZE < m_DataSize ? KERNEL_BLOCK_SIZE : m_DataSize - begin;
+                // rows of row-major matrix are contiguous, so the kernel writes straight into them,
+                // while columns of column-major one are strided and densities have to be copied
+                const unsigned copied = Layout == MatrixLayout::RowMajor ? 0 : count;
+                std::fill(denominators.begin(), denominators.begin() + count, 0.0);
+                for (unsigned k = 0; k < numberOfComponents; k++)
+                {
+                    DataType *componentDensities = Layout == MatrixLayout::RowMajor
+                        ? &m_AffilationMatrix.At<Layout>(k, begin) : densities.data();
+                    EvaluateGaussian(m_pMzArray + begin, count, m_KernelComponents, k, componentDensities);
+                    for (unsigned j = 0; j < copied; j++)
+                    {
+                        m_AffilationMatrix.At<Layout>(k, begin + j) = componentDensities[j];
+                    }
+                    for (unsigned j = 0; j < count; j++)
+                    {
+                        denominators[j] += componentDensities[j];
+                    }
+                }
+
+                for (unsigned k = 0; k < numberOfComponents; k++)
+                {
+                    for (unsigned j = 0; j < count; j++)
+                    {
+                        m_AffilationMatrix.At<Layout>(k, begin + j) /= denominators[j];
+                    }
+                }
+            }
+        }
+    }
+
+    DataType *m_pMzArray;
+    unsigned m_DataSize;
+    Matrix &m_AffilationMatrix;
+    std::vector<GaussianComponent> &m_Components;
+    GaussianKernelComponents m_KernelComponents;
+};
+}
@@ -47,6 +47,11 @@ namespace spectre::unsupervised::gmm
 class ExpectationRunnerRef
 {
 public:
+    /// <summary>
+    /// Layout of affilation matrix, in which affilations of each point are written contiguously.
+    /// </summary>
+    static constexpr MatrixLayout AFFILATION_LAYOUT = MatrixLayout::ColumnMajor;
+
     /// <summary>
     /// Constructor initializing the class with data required during expectation step.
     /// </summary>
@@ -92,7 +97,7 @@ public:
             {
                 DataType numerator = m_Components[k].weight *
                     Gaussian(m_pMzArray[i], m_Components[k].mean, m_Components[k].deviation);
-                m_AffilationMatrix[i][k] = numerator / denominator;
+                m_AffilationMatrix(k, i) = numerator / denominator;
             }
         }
     }
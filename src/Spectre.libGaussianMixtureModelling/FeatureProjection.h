@@ -0,0 +1,252 @@
+/*
+ * FeatureProjection.h
+ * Provides projection of spectra onto components of fitted Gaussian
+ * Mixture Model, i.e. extraction of features of the spectra.
+ *
+ * Intensity of a spectrum at each m/z value is distributed among the
+ * components proportionally to their weighted densities there, so the
+ * feature of k-th component is sum over i of s[i] * r[k][i], where
+ * r[k][i] = w[k] * N(mz[i]; mean[k], sd[k]) / sum over j of w[j] * N(mz[i]; mean[j], sd[j]).
+ * As the m/z axis is shared by all the spectra, r is computed once, and
+ * only within the truncated supports of the components, like in
+ * SparseIterationRunner. Intensities out of support of all the components
+ * are not attributed to any.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianKernel.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/SparseIterationRunner.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Default number of spectra held in memory at once by blockwise projection.
+/// </summary>
+constexpr unsigned DEFAULT_PROJECTION_BLOCK_SIZE = 1024;
+
+/// <summary>
+/// Number of spectra projected together by a single task, so that weights
+/// of a component are read from the cache for all but the first of them.
+/// </summary>
+constexpr unsigned PROJECTION_TILE_SIZE = 8;
+
+/// <summary>
+/// Class projects spectra sharing the m/z axis onto components of a Gaussian
+/// Mixture Model, producing matrix of features of spectra by components.
+/// Weights of the components are precomputed on construction.
+/// </summary>
+class FeatureProjection
+{
+public:
+    /// <summary>
+    /// Constructor precomputing weights of the components.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values shared by all the spectra, sorted in ascending order.</param>
+    /// <param name="size">Size of the mzArray and of each of the spectra.</param>
+    /// <param name="components">Gaussian components spectra are projected onto.</param>
+    /// <param name="cutoff">Half-width of the component support, in standard deviations.</param>
+    /// <exception cref="NullPointerException">Thrown when mzArray pointer is null</exception>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when cutoff is not positive</exception>
+    FeatureProjection(const DataType *mzArray, unsigned size, const std::vector<GaussianComponent> &components,
+                      DataType cutoff = DEFAULT_SUPPORT_CUTOFF)
+        : m_DataSize(size), m_NumberOfComponents((unsigned)components.size())
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (!(cutoff > 0.0))
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<DataType>(
+                "cutoff", 0.0, std::numeric_limits<DataType>::max(), cutoff);
+        }
+
+        PrecomputeWeights(mzArray, components, cutoff);
+    }
+
+    /// <summary>
+    /// Constructor precomputing weights of components of the model over its m/z axis.
+    /// </summary>
+    /// <param name="model">Fitted model, which m/z values are sorted in ascending order.</param>
+    /// <param name="cutoff">Half-width of the component support, in standard deviations.</param>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when cutoff is not positive</exception>
+    explicit FeatureProjection(const GaussianMixtureModel &model, DataType cutoff = DEFAULT_SUPPORT_CUTOFF)
+        : FeatureProjection(model.originalMzArray.data(), (unsigned)model.originalMzArray.size(),
+                            model.components, cutoff)
+    { }
+
+    /// <summary>
+    /// Number of features of each spectrum.
+    /// </summary>
+    unsigned NumberOfComponents() const
+    {
+        return m_NumberOfComponents;
+    }
+
+    /// <summary>
+    /// Number of m/z values of each spectrum.
+    /// </summary>
+    unsigned SpectrumLength() const
+    {
+        return m_DataSize;
+    }
+
+    /// <summary>
+    /// Projects spectra in parallel.
+    /// </summary>
+    /// <param name="spectra">Spectra laid out one after another, SpectrumLength() values each.</param>
+    /// <param name="numberOfSpectra">Number of the spectra.</param>
+    /// <param name="features">Output array for NumberOfComponents() features of each
+    /// of the spectra, laid out spectrum after spectrum.</param>
+    /// <exception cref="NullPointerException">Thrown when either of spectra or features pointers are null</exception>
+    void Project(const DataType *spectra, unsigned numberOfSpectra, DataType *features) const
+    {
+        if (spectra == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("spectra");
+        }
+
+        if (features == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("features");
+        }
+
+        const int numberOfTiles = (int)((numberOfSpectra + PROJECTION_TILE_SIZE - 1) / PROJECTION_TILE_SIZE);
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int tile = 0; tile < numberOfTiles; tile++)
+        {
+            const unsigned begin = (unsigned)tile * PROJECTION_TILE_SIZE;
+            const unsigned end = std::min(begin + PROJECTION_TILE_SIZE, numberOfSpectra);
+            ProjectTile(spectra, begin, end, features);
+        }
+    }
+
+    /// <summary>
+    /// Projects spectra read block by block, so that at most blockSize of them
+    /// are held in memory at once.
+    /// </summary>
+    /// <param name="numberOfSpectra">Number of the spectra.</param>
+    /// <param name="readSpectra">Callable of signature (unsigned begin, unsigned end, DataType *spectra),
+    /// writing spectra [begin, end) one after another into the buffer.</param>
+    /// <param name="features">Output array for NumberOfComponents() features of each
+    /// of the spectra, laid out spectrum after spectrum.</param>
+    /// <param name="blockSize">Number of spectra read at once.</param>
+    /// <exception cref="NullPointerException">Thrown when features pointer is null</exception>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when blockSize is 0</exception>
+    template <typename SpectraReader>
+    void ProjectBlockwise(unsigned numberOfSpectra, SpectraReader readSpectra, DataType *features,
+                          unsigned blockSize = DEFAULT_PROJECTION_BLOCK_SIZE) const
+    {
+        if (features == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("features");
+        }
+
+        if (blockSize == 0)
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<unsigned>(
+                "blockSize", 1, std::numeric_limits<unsigned>::max(), blockSize);
+        }
+
+        std::vector<DataType> block((size_t)std::min(blockSize, numberOfSpectra) * m_DataSize);
+        for (unsigned begin = 0; begin < numberOfSpectra; begin += blockSize)
+        {
+            const unsigned end = std::min(begin + blockSize, numberOfSpectra);
+            readSpectra(begin, end, block.data());
+            Project(block.data(), end - begin, features + (size_t)begin * m_NumberOfComponents);
+        }
+    }
+
+private:
+    void PrecomputeWeights(const DataType *mzArray, const std::vector<GaussianComponent> &components,
+                           DataType cutoff)
+    {
+        const DataType *mzBegin = mzArray;
+        const DataType *mzEnd = mzArray + m_DataSize;
+        m_WindowBegins.resize(m_NumberOfComponents);
+        m_WindowEnds.resize(m_NumberOfComponents);
+        m_WeightOffsets.resize(m_NumberOfComponents + 1);
+        m_WeightOffsets[0] = 0;
+        for (unsigned k = 0; k < m_NumberOfComponents; k++)
+        {
+            const DataType halfWidth = cutoff * components[k].deviation;
+            m_WindowBegins[k] = (unsigned)(std::lower_bound(mzBegin, mzEnd, components[k].mean - halfWidth) - mzBegin);
+            m_WindowEnds[k] = (unsigned)(std::upper_bound(mzBegin, mzEnd, components[k].mean + halfWidth) - mzBegin);
+            m_WeightOffsets[k + 1] = m_WeightOffsets[k] + (m_WindowEnds[k] - m_WindowBegins[k]);
+        }
+
+        GaussianKernelComponents kernelComponents;
+        kernelComponents.Assign(components);
+        m_Weights.resize(m_WeightOffsets[m_NumberOfComponents]);
+        std::vector<DataType> denominators(m_DataSize, 0.0);
+        for (unsigned k = 0; k < m_NumberOfComponents; k++)
+        {
+            DataType *weights = m_Weights.data() + m_WeightOffsets[k];
+            const unsigned length = m_WindowEnds[k] - m_WindowBegins[k];
+            EvaluateGaussian(mzArray + m_WindowBegins[k], length, kernelComponents, k, weights);
+            for (unsigned i = 0; i < length; i++)
+            {
+                denominators[m_WindowBegins[k] + i] += weights[i];
+            }
+        }
+
+        for (unsigned k = 0; k < m_NumberOfComponents; k++)
+        {
+            DataType *weights = m_Weights.data() + m_WeightOffsets[k];
+            const DataType *componentDenominators = denominators.data() + m_WindowBegins[k];
+            const unsigned length = m_WindowEnds[k] - m_WindowBegins[k];
+            for (unsigned i = 0; i < length; i++)
+            {
+                weights[i] = componentDenominators[i] > 0.0 ? weights[i] / componentDenominators[i] : 0.0;
+            }
+        }
+    }
+
+    void ProjectTile(const DataType *spectra, unsigned begin, unsigned end, DataType *features) const
+    {
+        for (unsigned k = 0; k < m_NumberOfComponents; k++)
+        {
+            const DataType *weights = m_Weights.data() + m_WeightOffsets[k];
+            const unsigned length = m_WindowEnds[k] - m_WindowBegins[k];
+            for (unsigned s = begin; s < end; s++)
+            {
+                const DataType *spectrum = spectra + (size_t)s * m_DataSize + m_WindowBegins[k];
+                DataType feature = 0.0;
+                for (unsigned i = 0; i < length; i++)
+                {
+                    feature += spectrum[i] * weights[i];
+                }
+                features[(size_t)s * m_NumberOfComponents + k] = feature;
+            }
+        }
+    }
+
+    unsigned m_DataSize;
+    unsigned m_NumberOfComponents;
+    std::vector<unsigned> m_WindowBegins;
+    std::vector<unsigned> m_WindowEnds;
+    std::vector<size_t> m_WeightOffsets;
+    std::vector<DataType> m_Weights;
+};
+}
@@ -0,0 +1,183 @@
+/*
+ * FusedExpectationMaximization.h
+ * Provides implementation of Expectation Maximization algorithm
+ * used for Gaussian Mixture Modelling, which performs each iteration
+ * in a single pass over the data.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <random>
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/ConvergenceMonitor.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/FusedIterationRunner.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+
+typedef std::mt19937_64 RandomNumberGenerator;
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Counterpart of ExpectationMaximization, which does not keep the affilation
+/// matrix. Expectation step, maximization step and log likelihood calculation
+/// are carried out together by the IterationRunner.
+/// </summary>
+/// <param name="InitializationRunner">Class performing Initialization step of the em algorithm, constructed
+/// from m/z values, intensities, size, components and random number generator.</param>
+/// <param name="IterationRunner">Class performing whole iteration of the em algorithm,
+/// returning log likelihood of the components it started with.</param>
+template <typename InitializationRunner, typename IterationRunner = FusedIterationRunner>
+class FusedExpectationMaximization
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with all algorithm necessary data.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="rngEngine">Mersenne-Twister engine to be used during initialization step.</param>
+    /// <param name="numberOfComponents">Number of Gaussian components that build up the approximation.</param>
+    /// <param name="iterationRunnerArguments">Additional arguments passed to IterationRunner constructor.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    template <typename... IterationRunnerArguments>
+    FusedExpectationMaximization(DataType *mzArray, DataType *intensities, const unsigned size,
+                                 RandomNumberGenerator &rngEngine, const unsigned numberOfComponents = 2,
+                                 IterationRunnerArguments... iterationRunnerArguments)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size), m_Components(numberOfComponents)
+          , m_Convergence(), m_Report()
+          , m_Initialization(mzArray, intensities, size, m_Components, rngEngine)
+          , m_Iteration(mzArray, intensities, size, m_Components, iterationRunnerArguments...)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+    }
+
+    /// <summary>
+    /// Constructor presetting the components, which is used for warm start
+    /// with PresetInitialization, e.g. from components of a model estimated
+    /// for a previous version of the data.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="rngEngine">Mersenne-Twister engine to be used during initialization step.</param>
+    /// <param name="initialComponents">Components the algorithm starts with.</param>
+    /// <param name="iterationRunnerArguments">Additional arguments passed to IterationRunner constructor.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    template <typename... IterationRunnerArguments>
+    FusedExpectationMaximization(DataType *mzArray, DataType *intensities, const unsigned size,
+                                 RandomNumberGenerator &rngEngine,
+                                 const std::vector<GaussianComponent> &initialComponents,
+                                 IterationRunnerArguments... iterationRunnerArguments)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size), m_Components(initialComponents)
+          , m_Convergence(), m_Report()
+          , m_Initialization(mzArray, intensities, size, m_Components, rngEngine)
+          , m_Iteration(mzArray, intensities, size, m_Components, iterationRunnerArguments...)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+    }
+
+    /// <summary>
+    /// Sets conditions stopping the iterations of the next runs. By default,
+    /// iterations stop when change in log likelihood is lower than 0.00000001.
+    /// </summary>
+    /// <param name="criteria">Conditions stopping the iterations.</param>
+    void SetConvergenceCriteria(const ConvergenceCriteria &criteria)
+    {
+        m_Convergence = criteria;
+    }
+
+    /// <summary>
+    /// Gets summary of the last run.
+    /// </summary>
+    /// <returns>Summary of the last run.</returns>
+    ConvergenceReport GetConvergenceReport() const
+    {
+        return m_Report;
+    }
+
+    /// <summary>
+    /// Performs a full algorithm run. Terminates when any of the convergence
+    /// criteria is met.
+    /// </summary>
+    /// <remarks>
+    /// Log likelihood is known only for components from before the last iteration,
+    /// so the run makes a single iteration more than ExpectationMaximization would.
+    /// It is still about twice less passes over the data.
+    /// </remarks>
+    /// <returns>
+    /// Gaussian Mixture Model containing all the components with their appropriate
+    /// parameters.
+    /// </returns>
+    GaussianMixtureModel EstimateGmm()
+    {
+        Initialization();
+
+        ConvergenceMonitor monitor(m_Convergence, m_pMzArray, m_DataSize, m_Components);
+        DataType likelihood;
+        double iterationSeconds;
+        do
+        {
+            monitor.Lap();
+            likelihood = m_Iteration.Iterate();
+            iterationSeconds = monitor.Lap();
+        }
+        while (monitor.Continue(likelihood, iterationSeconds, 0.0, 0.0));
+        m_Report = monitor.Report();
+
+        return GaussianMixtureModel(
+            gsl::span<DataType>(m_pMzArray, m_DataSize),
+            gsl::span<DataType>(m_pIntensities, m_DataSize),
+            std::move(m_Components)
+        );
+    }
+
+private:
+    void Initialization()
+    {
+        m_Initialization.AssignRandomMeans();
+        m_Initialization.AssignVariances();
+        m_Initialization.AssignWeights();
+    }
+
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    std::vector<GaussianComponent> m_Components;
+    ConvergenceCriteria m_Convergence;
+    ConvergenceReport m_Report;
+
+    InitializationRunner m_Initialization;
+    IterationRunner m_Iteration;
+};
+}
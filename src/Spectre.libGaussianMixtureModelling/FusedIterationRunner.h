@@ -0,0 +1,161 @@
+/*
+ * FusedIterationRunner.h
+ * Provides implementation of a whole iteration of EM algorithm used for
+ * Gaussian Mixture Modelling, performed in a single pass over the data.
+ *
+ * Expectation step, accumulation of the sums required by maximization step
+ * and calculation of log likelihood share the evaluation of the Gaussians,
+ * hence they are fused together. Affilation of a single data point is
+ * needed only until it is accumulated, so the affilation matrix is never
+ * created. Please refer to ExpectationRunnerRef.h, MaximizationRunnerRef.h
+ * and LogLikelihoodCalculator.h for the mathematical background.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianKernel.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/SufficientStatistics.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Class performs whole iterations of Expectation Maximization algorithm,
+/// each in a single, sequential pass over m/z and intensities arrays.
+/// Memory used does not depend on the number of data points.
+/// </summary>
+class FusedIterationRunner
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with data required during iterations.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="components">Gaussian components to be updated.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    FusedIterationRunner(DataType *mzArray, DataType *intensities, unsigned size,
+                         std::vector<GaussianComponent> &components)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size),
+          m_Components(components), m_Statistics((unsigned)components.size())
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        m_TotalDataSize = 0.0;
+        for (unsigned i = 0; i < m_DataSize; i++)
+        {
+            m_TotalDataSize += m_pIntensities[i];
+        }
+    }
+
+    virtual ~FusedIterationRunner() = default;
+
+    /// <summary>
+    /// Performs expectation and maximization steps in a single pass over the data
+    /// and updates the components.
+    /// </summary>
+    /// <returns>
+    /// Log likelihood of the data given components from before the update.
+    /// </returns>
+    virtual DataType Iterate()
+    {
+        PrepareIteration(m_Statistics);
+        m_Densities.resize(m_Components.size() * KERNEL_BLOCK_SIZE);
+        Accumulate(0, m_DataSize, m_Statistics, m_Densities.data());
+        m_Statistics.Maximize(m_TotalDataSize, m_Components);
+        return m_Statistics.logLikelihood;
+    }
+
+protected:
+    /// <summary>
+    /// Resets given statistics and precomputes parameters of the Gaussians.
+    /// </summary>
+    /// <param name="statistics">Statistics to be reset.</param>
+    virtual void PrepareIteration(SufficientStatistics &statistics)
+    {
+        statistics.Reset(m_Components);
+        m_KernelComponents.Assign(m_Components);
+    }
+
+    /// <summary>
+    /// Accumulates contributions of data points [begin, end) into the statistics.
+    /// </summary>
+    /// <param name="begin">Index of the first data point.</param>
+    /// <param name="end">Index past the last data point.</param>
+    /// <param name="statistics">Statistics, which shifts were already set.</param>
+    /// <param name="densities">Buffer for KERNEL_BLOCK_SIZE weighted densities
+    /// of each of the components.</param>
+    virtual void Accumulate(unsigned begin, unsigned end, SufficientStatistics &statistics, DataType *densities) const
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        DataType denominators[KERNEL_BLOCK_SIZE];
+        for (unsigned blockBegin = begin; blockBegin < end; blockBegin += KERNEL_BLOCK_SIZE)
+        {
+            const unsigned count = blockBegin + KERNEL_BLOCK_SIZE < end ? KERNEL_BLOCK_SIZE : end - blockBegin;
+            const DataType *mzs = m_pMzArray + blockBegin;
+            std::fill(denominators, denominators + count, 0.0);
+            for (unsigned k = 0; k < numberOfComponents; k++)
+            {
+                DataType *componentDensities = densities + k * KERNEL_BLOCK_SIZE;
+                EvaluateGaussian(mzs, count, m_KernelComponents, k, componentDensities);
+                for (unsigned j = 0; j < count; j++)
+                {
+                    denominators[j] += componentDensities[j];
+                }
+            }
+
+            for (unsigned j = 0; j < count; j++)
+            {
+                const DataType intensity = m_pIntensities[blockBegin + j];
+                const DataType intensityPerDensity = intensity / denominators[j];
+                for (unsigned k = 0; k < numberOfComponents; k++)
+                {
+                    statistics.Add(k, densities[k * KERNEL_BLOCK_SIZE + j] * intensityPerDensity, mzs[j]);
+                }
+                // points of zero intensity do not contribute to the likelihood
+                if (intensity > 0.0)
+                {
+                    statistics.logLikelihood += log(denominators[j] * intensity);
+                }
+            }
+        }
+    }
+
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    DataType m_TotalDataSize;
+    std::vector<GaussianComponent> &m_Components;
+    SufficientStatistics m_Statistics;
+    GaussianKernelComponents m_KernelComponents;
+
+private:
+    std::vector<DataType> m_Densities;
+};
+}
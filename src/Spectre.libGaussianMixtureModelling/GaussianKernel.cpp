@@ -0,0 +1,543 @@
+/*
+ * GaussianKernel.cpp
+ * Provides batch evaluation of weighted Gaussian functions over blocks
+ * of m/z values, vectorized with AVX-512 or AVX2, when the processor
+ * supports it.
+ *
+ * Vectorized exponent follows the usual range reduction:
+ * exp(x) = 2^n * exp(r), where n = round(x / ln 2) and |r| <= ln 2 / 2,
+ * with exp(r) approximated by Taylor polynomial of 13th degree, which
+ * error is below the double precision rounding error in this range.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#define _USE_MATH_DEFINES // used for M_PI
+#include <math.h>
+#include <limits>
+#include "Spectre.libGaussianMixtureModelling/GaussianKernel.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define GAUSSIAN_KERNEL_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define GAUSSIAN_KERNEL_TARGET_AVX2
+#define GAUSSIAN_KERNEL_TARGET_AVX512
+// AVX-512 intrinsics are available since Visual Studio 2017 version 15.3
+#if _MSC_VER >= 1911
+#define GAUSSIAN_KERNEL_AVX512
+#endif
+#else
+#define GAUSSIAN_KERNEL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define GAUSSIAN_KERNEL_TARGET_AVX512 __attribute__((target("avx512f")))
+#define GAUSSIAN_KERNEL_AVX512
+#endif
+#endif
+
+namespace spectre::unsupervised::gmm
+{
+void GaussianKernelComponents::Assign(const std::vector<GaussianComponent> &components)
+{
+    const size_t numberOfComponents = components.size();
+    means.resize(numberOfComponents);
+    inverseDeviations.resize(numberOfComponents);
+    logNormalizers.resize(numberOfComponents);
+    for (size_t k = 0; k < numberOfComponents; k++)
+    {
+        means[k] = components[k].mean;
+        inverseDeviations[k] = 1.0 / components[k].deviation;
+        logNormalizers[k] = log(components[k].weight / (sqrt(2.0 * M_PI) * components[k].deviation));
+    }
+}
+
+void EvaluateGaussianScalar(const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                            DataType logNormalizer, DataType *densities)
+{
+    for (unsigned i = 0; i < count; i++)
+    {
+        const DataType standardized = (mzArray[i] - mean) * inverseDeviation;
+        densities[i] = exp(logNormalizer - 0.5 * standardized * standardized);
+    }
+}
+
+void EvaluateGaussianFloatScalar(const float *offsets, unsigned count, float mean, float inverseDeviation,
+                                 float logNormalizer, float *densities)
+{
+    for (unsigned i = 0; i < count; i++)
+    {
+        const float standardized = (offsets[i] - mean) * inverseDeviation;
+        densities[i] = expf(logNormalizer - 0.5f * standardized * standardized);
+    }
+}
+
+namespace
+{
+void EvaluateExponentScalar(const DataType *arguments, unsigned count, DataType *values)
+{
+    for (unsigned i = 0; i < count; i++)
+    {
+        values[i] = exp(arguments[i]);
+    }
+}
+}
+
+#ifdef GAUSSIAN_KERNEL_X86
+namespace
+{
+// Below this argument exponent is subnormal and flushed to zero,
+// above the upper one it would overflow.
+constexpr double MIN_EXPONENT_ARGUMENT = -708.0;
+constexpr double MAX_EXPONENT_ARGUMENT = 709.0;
+
+GAUSSIAN_KERNEL_TARGET_AVX2
+inline __m256d ExponentAvx2(__m256d x)
+{
+    const __m256d underflow = _mm256_cmp_pd(x, _mm256_set1_pd(MIN_EXPONENT_ARGUMENT), _CMP_LT_OQ);
+    x = _mm256_max_pd(x, _mm256_set1_pd(MIN_EXPONENT_ARGUMENT));
+    x = _mm256_min_pd(x, _mm256_set1_pd(MAX_EXPONENT_ARGUMENT));
+
+    const __m256d n = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(M_LOG2E)),
+                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    // ln 2 split into exactly representable high part and the remainder
+    __m256d r = _mm256_fnmadd_pd(n, _mm256_set1_pd(6.93145751953125E-1), x);
+    r = _mm256_fnmadd_pd(n, _mm256_set1_pd(1.42860682030941723212E-6), r);
+
+    __m256d p = _mm256_set1_pd(1.0 / 6227020800.0);
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 479001600.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 39916800.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 3628800.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 362880.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 40320.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 5040.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 720.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 120.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 24.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0 / 6.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(0.5));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0));
+
+    // 2^n built directly in the exponent bits; adding 1.5 * 2^52 moves n
+    // to the low bits of the mantissa
+    const __m256i integral = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(6755399441055744.0)));
+    const __m256i biased = _mm256_add_epi64(integral, _mm256_set1_epi64x(1023));
+    const __m256d scale = _mm256_castsi256_pd(_mm256_slli_epi64(biased, 52));
+
+    return _mm256_andnot_pd(underflow, _mm256_mul_pd(p, scale));
+}
+
+// Single precision bounds of the exponent argument, as above.
+constexpr float MIN_FLOAT_EXPONENT_ARGUMENT = -87.3f;
+constexpr float MAX_FLOAT_EXPONENT_ARGUMENT = 88.3f;
+
+GAUSSIAN_KERNEL_TARGET_AVX2
+inline __m256 ExponentAvx2(__m256 x)
+{
+    const __m256 underflow = _mm256_cmp_ps(x, _mm256_set1_ps(MIN_FLOAT_EXPONENT_ARGUMENT), _CMP_LT_OQ);
+    x = _mm256_max_ps(x, _mm256_set1_ps(MIN_FLOAT_EXPONENT_ARGUMENT));
+    x = _mm256_min_ps(x, _mm256_set1_ps(MAX_FLOAT_EXPONENT_ARGUMENT));
+
+    const __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), x);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), r);
+
+    __m256 p = _mm256_set1_ps(1.9875691500e-4f);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.3981999507e-3f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(8.3334519073e-3f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(4.1665795894e-2f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(1.6666665459e-1f));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(5.0000001201e-1f));
+    p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+
+    const __m256i biased = _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127));
+    const __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(biased, 23));
+
+    return _mm256_andnot_ps(underflow, _mm256_mul_ps(p, scale));
+}
+
+GAUSSIAN_KERNEL_TARGET_AVX2
+void EvaluateExponentAvx2(const DataType *arguments, unsigned count, DataType *values)
+{
+    unsigned i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm256_storeu_pd(values + i, ExponentAvx2(_mm256_loadu_pd(arguments + i)));
+    }
+    EvaluateExponentScalar(arguments + i, count - i, values + i);
+}
+}
+
+GAUSSIAN_KERNEL_TARGET_AVX2
+void EvaluateGaussianAvx2(const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                          DataType logNormalizer, DataType *densities)
+{
+    const __m256d means = _mm256_set1_pd(mean);
+    const __m256d inverseDeviations = _mm256_set1_pd(inverseDeviation);
+    const __m256d logNormalizers = _mm256_set1_pd(logNormalizer);
+    const __m256d minusHalf = _mm256_set1_pd(-0.5);
+    unsigned i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d standardized = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(mzArray + i), means),
+                                                   inverseDeviations);
+        const __m256d exponent = _mm256_fmadd_pd(_mm256_mul_pd(standardized, standardized), minusHalf,
+                                                 logNormalizers);
+        _mm256_storeu_pd(densities + i, ExponentAvx2(exponent));
+    }
+    EvaluateGaussianScalar(mzArray + i, count - i, mean, inverseDeviation, logNormalizer, densities + i);
+}
+
+GAUSSIAN_KERNEL_TARGET_AVX2
+void EvaluateGaussianFloatAvx2(const float *offsets, unsigned count, float mean, float inverseDeviation,
+                               float logNormalizer, float *densities)
+{
+    const __m256 means = _mm256_set1_ps(mean);
+    const __m256 inverseDeviations = _mm256_set1_ps(inverseDeviation);
+    const __m256 logNormalizers = _mm256_set1_ps(logNormalizer);
+    const __m256 minusHalf = _mm256_set1_ps(-0.5f);
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 standardized = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(offsets + i), means),
+                                                  inverseDeviations);
+        const __m256 exponent = _mm256_fmadd_ps(_mm256_mul_ps(standardized, standardized), minusHalf,
+                                                logNormalizers);
+        _mm256_storeu_ps(densities + i, ExponentAvx2(exponent));
+    }
+    EvaluateGaussianFloatScalar(offsets + i, count - i, mean, inverseDeviation, logNormalizer, densities + i);
+}
+
+bool IsAvx2Supported()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool hasFma = (info[2] & (1 << 12)) != 0;
+    const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    const bool hasAvx = (info[2] & (1 << 28)) != 0;
+    // operating system has to preserve YMM registers on context switch
+    if (!hasFma || !hasOsxsave || !hasAvx || (_xgetbv(0) & 6) != 6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#else
+namespace
+{
+void EvaluateExponentAvx2(const DataType *arguments, unsigned count, DataType *values)
+{
+    EvaluateExponentScalar(arguments, count, values);
+}
+}
+
+void EvaluateGaussianAvx2(const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                          DataType logNormalizer, DataType *densities)
+{
+    EvaluateGaussianScalar(mzArray, count, mean, inverseDeviation, logNormalizer, densities);
+}
+
+void EvaluateGaussianFloatAvx2(const float *offsets, unsigned count, float mean, float inverseDeviation,
+                               float logNormalizer, float *densities)
+{
+    EvaluateGaussianFloatScalar(offsets, count, mean, inverseDeviation, logNormalizer, densities);
+}
+
+bool IsAvx2Supported()
+{
+    return false;
+}
+#endif
+
+#if defined(GAUSSIAN_KERNEL_X86) && defined(GAUSSIAN_KERNEL_AVX512)
+namespace
+{
+// Same approximation as ExponentAvx2, with 2^n applied by scalef.
+GAUSSIAN_KERNEL_TARGET_AVX512
+inline __m512d ExponentAvx512(__m512d x)
+{
+    const __mmask8 inRange = _mm512_cmp_pd_mask(x, _mm512_set1_pd(MIN_EXPONENT_ARGUMENT), _CMP_NLT_UQ);
+    x = _mm512_max_pd(x, _mm512_set1_pd(MIN_EXPONENT_ARGUMENT));
+    x = _mm512_min_pd(x, _mm512_set1_pd(MAX_EXPONENT_ARGUMENT));
+
+    const __m512d n = _mm512_roundscale_pd(_mm512_mul_pd(x, _mm512_set1_pd(M_LOG2E)),
+                                           _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512d r = _mm512_fnmadd_pd(n, _mm512_set1_pd(6.93145751953125E-1), x);
+    r = _mm512_fnmadd_pd(n, _mm512_set1_pd(1.42860682030941723212E-6), r);
+
+    __m512d p = _mm512_set1_pd(1.0 / 6227020800.0);
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0 / 479001600.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0 / 39916800.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0 / 3628800.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0 / 362880.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0 / 40320.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0 / 5040.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0 / 720.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0 / 120.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0 / 24.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0 / 6.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(0.5));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0));
+
+    return _mm512_maskz_scalef_pd(inRange, p, n);
+}
+
+GAUSSIAN_KERNEL_TARGET_AVX512
+inline __m512 ExponentAvx512(__m512 x)
+{
+    const __mmask16 inRange = _mm512_cmp_ps_mask(x, _mm512_set1_ps(MIN_FLOAT_EXPONENT_ARGUMENT), _CMP_NLT_UQ);
+    x = _mm512_max_ps(x, _mm512_set1_ps(MIN_FLOAT_EXPONENT_ARGUMENT));
+    x = _mm512_min_ps(x, _mm512_set1_ps(MAX_FLOAT_EXPONENT_ARGUMENT));
+
+    const __m512 n = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(1.44269504088896341f)),
+                                          _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(0.693359375f), x);
+    r = _mm512_fnmadd_ps(n, _mm512_set1_ps(-2.12194440e-4f), r);
+
+    __m512 p = _mm512_set1_ps(1.9875691500e-4f);
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.3981999507e-3f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(8.3334519073e-3f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(4.1665795894e-2f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(1.6666665459e-1f));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(5.0000001201e-1f));
+    p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+
+    return _mm512_maskz_scalef_ps(inRange, p, n);
+}
+
+GAUSSIAN_KERNEL_TARGET_AVX512
+void EvaluateExponentAvx512(const DataType *arguments, unsigned count, DataType *values)
+{
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        _mm512_storeu_pd(values + i, ExponentAvx512(_mm512_loadu_pd(arguments + i)));
+    }
+    EvaluateExponentScalar(arguments + i, count - i, values + i);
+}
+}
+
+GAUSSIAN_KERNEL_TARGET_AVX512
+void EvaluateGaussianAvx512(const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                            DataType logNormalizer, DataType *densities)
+{
+    const __m512d means = _mm512_set1_pd(mean);
+    const __m512d inverseDeviations = _mm512_set1_pd(inverseDeviation);
+    const __m512d logNormalizers = _mm512_set1_pd(logNormalizer);
+    const __m512d minusHalf = _mm512_set1_pd(-0.5);
+    unsigned i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m512d standardized = _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(mzArray + i), means),
+                                                   inverseDeviations);
+        const __m512d exponent = _mm512_fmadd_pd(_mm512_mul_pd(standardized, standardized), minusHalf,
+                                                 logNormalizers);
+        _mm512_storeu_pd(densities + i, ExponentAvx512(exponent));
+    }
+    EvaluateGaussianScalar(mzArray + i, count - i, mean, inverseDeviation, logNormalizer, densities + i);
+}
+
+GAUSSIAN_KERNEL_TARGET_AVX512
+void EvaluateGaussianFloatAvx512(const float *offsets, unsigned count, float mean, float inverseDeviation,
+                                 float logNormalizer, float *densities)
+{
+    const __m512 means = _mm512_set1_ps(mean);
+    const __m512 inverseDeviations = _mm512_set1_ps(inverseDeviation);
+    const __m512 logNormalizers = _mm512_set1_ps(logNormalizer);
+    const __m512 minusHalf = _mm512_set1_ps(-0.5f);
+    unsigned i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m512 standardized = _mm512_mul_ps(_mm512_sub_ps(_mm512_loadu_ps(offsets + i), means),
+                                                  inverseDeviations);
+        const __m512 exponent = _mm512_fmadd_ps(_mm512_mul_ps(standardized, standardized), minusHalf,
+                                                logNormalizers);
+        _mm512_storeu_ps(densities + i, ExponentAvx512(exponent));
+    }
+    EvaluateGaussianFloatScalar(offsets + i, count - i, mean, inverseDeviation, logNormalizer, densities + i);
+}
+
+bool IsAvx512Supported()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    // operating system has to preserve opmask and all ZMM registers on context switch
+    if (!hasOsxsave || (_xgetbv(0) & 0xE6) != 0xE6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#endif
+}
+#else
+namespace
+{
+void EvaluateExponentAvx512(const DataType *arguments, unsigned count, DataType *values)
+{
+    EvaluateExponentAvx2(arguments, count, values);
+}
+}
+
+void EvaluateGaussianAvx512(const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                            DataType logNormalizer, DataType *densities)
+{
+    EvaluateGaussianAvx2(mzArray, count, mean, inverseDeviation, logNormalizer, densities);
+}
+
+void EvaluateGaussianFloatAvx512(const float *offsets, unsigned count, float mean, float inverseDeviation,
+                                 float logNormalizer, float *densities)
+{
+    EvaluateGaussianFloatAvx2(offsets, count, mean, inverseDeviation, logNormalizer, densities);
+}
+
+bool IsAvx512Supported()
+{
+    return false;
+}
+#endif
+
+namespace
+{
+typedef void (*GaussianKernelFunction)(const DataType*, unsigned, DataType, DataType, DataType, DataType*);
+typedef void (*FloatGaussianKernelFunction)(const float*, unsigned, float, float, float, float*);
+typedef void (*ExponentFunction)(const DataType*, unsigned, DataType*);
+
+GaussianKernelFunction SelectKernel()
+{
+    if (IsAvx512Supported())
+    {
+        return EvaluateGaussianAvx512;
+    }
+    return IsAvx2Supported() ? EvaluateGaussianAvx2 : EvaluateGaussianScalar;
+}
+
+FloatGaussianKernelFunction SelectFloatKernel()
+{
+    if (IsAvx512Supported())
+    {
+        return EvaluateGaussianFloatAvx512;
+    }
+    return IsAvx2Supported() ? EvaluateGaussianFloatAvx2 : EvaluateGaussianFloatScalar;
+}
+
+ExponentFunction SelectExponent()
+{
+    if (IsAvx512Supported())
+    {
+        return EvaluateExponentAvx512;
+    }
+    return IsAvx2Supported() ? EvaluateExponentAvx2 : EvaluateExponentScalar;
+}
+}
+
+void EvaluateGaussian(const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                      DataType logNormalizer, DataType *densities)
+{
+    static const GaussianKernelFunction kernel = SelectKernel();
+    kernel(mzArray, count, mean, inverseDeviation, logNormalizer, densities);
+}
+
+void EvaluateGaussian(const float *offsets, unsigned count, float mean, float inverseDeviation,
+                      float logNormalizer, float *densities)
+{
+    static const FloatGaussianKernelFunction kernel = SelectFloatKernel();
+    kernel(offsets, count, mean, inverseDeviation, logNormalizer, densities);
+}
+
+void EvaluateExponent(const DataType *arguments, unsigned count, DataType *values)
+{
+    static const ExponentFunction exponent = SelectExponent();
+    exponent(arguments, count, values);
+}
+
+void EvaluateLogMixture(const DataType *mzArray, unsigned count, const GaussianKernelComponents &components,
+                        DataType *affilations, DataType *logMixtureDensities)
+{
+    const unsigned numberOfComponents = components.Size();
+    DataType maxima[KERNEL_BLOCK_SIZE];
+    DataType sums[KERNEL_BLOCK_SIZE];
+    for (unsigned j = 0; j < count; j++)
+    {
+        maxima[j] = -std::numeric_limits<DataType>::infinity();
+        sums[j] = 0.0;
+    }
+
+    for (unsigned k = 0; k < numberOfComponents; k++)
+    {
+        DataType *logDensities = affilations + k * KERNEL_BLOCK_SIZE;
+        const DataType mean = components.means[k];
+        const DataType inverseDeviation = components.inverseDeviations[k];
+        const DataType logNormalizer = components.logNormalizers[k];
+        for (unsigned j = 0; j < count; j++)
+        {
+            const DataType standardized = (mzArray[j] - mean) * inverseDeviation;
+            logDensities[j] = logNormalizer - 0.5 * standardized * standardized;
+            maxima[j] = logDensities[j] > maxima[j] ? logDensities[j] : maxima[j];
+        }
+    }
+
+    // the greatest term becomes exp(0) = 1, so the sums never underflow
+    for (unsigned k = 0; k < numberOfComponents; k++)
+    {
+        DataType *terms = affilations + k * KERNEL_BLOCK_SIZE;
+        for (unsigned j = 0; j < count; j++)
+        {
+            terms[j] -= maxima[j];
+        }
+        EvaluateExponent(terms, count, terms);
+        for (unsigned j = 0; j < count; j++)
+        {
+            sums[j] += terms[j];
+        }
+    }
+
+    for (unsigned j = 0; j < count; j++)
+    {
+        logMixtureDensities[j] = maxima[j] + log(sums[j]);
+        sums[j] = 1.0 / sums[j];
+    }
+    for (unsigned k = 0; k < numberOfComponents; k++)
+    {
+        DataType *terms = affilations + k * KERNEL_BLOCK_SIZE;
+        for (unsigned j = 0; j < count; j++)
+        {
+            terms[j] *= sums[j];
+        }
+    }
+}
+}
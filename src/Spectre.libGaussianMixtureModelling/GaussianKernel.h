@@ -0,0 +1,193 @@
+/*
+ * GaussianKernel.h
+ * Provides batch evaluation of weighted Gaussian functions over blocks
+ * of m/z values, vectorized when the processor supports it.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <vector>
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Number of data points evaluated by a single kernel call in the runners,
+/// chosen so that densities of a block stay in the cache.
+/// </summary>
+constexpr unsigned KERNEL_BLOCK_SIZE = 256;
+
+/// <summary>
+/// Parameters of the Gaussian components laid out as structure of arrays,
+/// precomputed once per iteration, so the kernel does not need to divide,
+/// nor compute normalization constants.
+/// </summary>
+struct GaussianKernelComponents
+{
+    /// <summary>
+    /// Recomputes parameters from the given components.
+    /// </summary>
+    /// <param name="components">Gaussian components.</param>
+    void Assign(const std::vector<GaussianComponent> &components);
+
+    /// <summary>
+    /// Number of components.
+    /// </summary>
+    unsigned Size() const
+    {
+        return (unsigned)means.size();
+    }
+
+    /// <summary>
+    /// Means of the components.
+    /// </summary>
+    std::vector<DataType> means;
+
+    /// <summary>
+    /// Inverted standard deviations of the components.
+    /// </summary>
+    std::vector<DataType> inverseDeviations;
+
+    /// <summary>
+    /// Logarithms of weights divided by normalization constants, i.e.
+    /// log(weight / (sqrt(2 * pi) * deviation)).
+    /// </summary>
+    std::vector<DataType> logNormalizers;
+};
+
+/// <summary>
+/// Computes weighted densities of a single component,
+/// exp(logNormalizer - ((mz - mean) * inverseDeviation)^2 / 2), for a block of
+/// m/z values. Uses AVX-512 or AVX2 code, when processor supports it, scalar code
+/// otherwise.
+/// </summary>
+/// <param name="mzArray">Block of m/z values.</param>
+/// <param name="count">Number of m/z values in the block.</param>
+/// <param name="mean">Mean of the component.</param>
+/// <param name="inverseDeviation">Inverted standard deviation of the component.</param>
+/// <param name="logNormalizer">Logarithm of weight divided by normalization constant.</param>
+/// <param name="densities">Output array for count densities.</param>
+void EvaluateGaussian(const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                      DataType logNormalizer, DataType *densities);
+
+/// <summary>
+/// Computes weighted densities of k-th of given components for a block of m/z values.
+/// </summary>
+/// <param name="mzArray">Block of m/z values.</param>
+/// <param name="count">Number of m/z values in the block.</param>
+/// <param name="components">Precomputed parameters of the components.</param>
+/// <param name="k">Index of the component.</param>
+/// <param name="densities">Output array for count densities.</param>
+inline void EvaluateGaussian(const DataType *mzArray, unsigned count, const GaussianKernelComponents &components,
+                             unsigned k, DataType *densities)
+{
+    EvaluateGaussian(mzArray, count, components.means[k], components.inverseDeviations[k],
+                     components.logNormalizers[k], densities);
+}
+
+/// <summary>
+/// Single precision counterpart of EvaluateGaussian, processing twice as many
+/// values per instruction. As m/z values lose precision in single precision,
+/// they should be given as offsets from a common reference point, as should
+/// the mean. Uses AVX-512 or AVX2 code, when processor supports it, scalar code
+/// otherwise.
+/// Densities below about exp(-87), which are subnormal, are flushed to zero.
+/// </summary>
+/// <param name="offsets">Block of m/z values, relative to a reference point.</param>
+/// <param name="count">Number of m/z values in the block.</param>
+/// <param name="mean">Mean of the component, relative to the same reference point.</param>
+/// <param name="inverseDeviation">Inverted standard deviation of the component.</param>
+/// <param name="logNormalizer">Logarithm of weight divided by normalization constant.</param>
+/// <param name="densities">Output array for count densities.</param>
+void EvaluateGaussian(const float *offsets, unsigned count, float mean, float inverseDeviation,
+                      float logNormalizer, float *densities);
+
+/// <summary>
+/// Computes exponents of a block of values. Uses AVX-512 or AVX2 code, when
+/// processor supports it, scalar code otherwise. Results for arguments below -708,
+/// which are subnormal, may be flushed to zero.
+/// </summary>
+/// <param name="arguments">Block of arguments.</param>
+/// <param name="count">Number of arguments in the block.</param>
+/// <param name="values">Output array for count values, may be the same as arguments.</param>
+void EvaluateExponent(const DataType *arguments, unsigned count, DataType *values);
+
+/// <summary>
+/// Computes, for a block of m/z values, logarithms of mixture density and
+/// affilations of the points to the components, in log domain, i.e. with
+/// log-sum-exp over weighted log densities. Neither underflows for points
+/// far from all the components.
+/// </summary>
+/// <param name="mzArray">Block of m/z values.</param>
+/// <param name="count">Number of m/z values in the block, at most KERNEL_BLOCK_SIZE.</param>
+/// <param name="components">Precomputed parameters of the components.</param>
+/// <param name="affilations">Output array for KERNEL_BLOCK_SIZE affilations to each
+/// of the components, laid out component after component.</param>
+/// <param name="logMixtureDensities">Output array for count logarithms of mixture density.</param>
+void EvaluateLogMixture(const DataType *mzArray, unsigned count, const GaussianKernelComponents &components,
+                        DataType *affilations, DataType *logMixtureDensities);
+
+/// <summary>
+/// Scalar implementation of EvaluateGaussian, used as a fallback.
+/// </summary>
+void EvaluateGaussianScalar(const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                            DataType logNormalizer, DataType *densities);
+
+/// <summary>
+/// AVX2 implementation of EvaluateGaussian. May be called only when
+/// IsAvx2Supported returns true.
+/// </summary>
+void EvaluateGaussianAvx2(const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                          DataType logNormalizer, DataType *densities);
+
+/// <summary>
+/// AVX-512 implementation of EvaluateGaussian. May be called only when
+/// IsAvx512Supported returns true.
+/// </summary>
+void EvaluateGaussianAvx512(const DataType *mzArray, unsigned count, DataType mean, DataType inverseDeviation,
+                            DataType logNormalizer, DataType *densities);
+
+/// <summary>
+/// Scalar implementation of single precision EvaluateGaussian, used as a fallback.
+/// </summary>
+void EvaluateGaussianFloatScalar(const float *offsets, unsigned count, float mean, float inverseDeviation,
+                                 float logNormalizer, float *densities);
+
+/// <summary>
+/// AVX2 implementation of single precision EvaluateGaussian. May be called only when
+/// IsAvx2Supported returns true.
+/// </summary>
+void EvaluateGaussianFloatAvx2(const float *offsets, unsigned count, float mean, float inverseDeviation,
+                               float logNormalizer, float *densities);
+
+/// <summary>
+/// AVX-512 implementation of single precision EvaluateGaussian. May be called only when
+/// IsAvx512Supported returns true.
+/// </summary>
+void EvaluateGaussianFloatAvx512(const float *offsets, unsigned count, float mean, float inverseDeviation,
+                                 float logNormalizer, float *densities);
+
+/// <summary>
+/// Checks whether both processor and operating system support AVX2 and FMA instructions.
+/// </summary>
+bool IsAvx2Supported();
+
+/// <summary>
+/// Checks whether both processor and operating system support AVX-512 Foundation
+/// instructions, and the library was compiled with them.
+/// </summary>
+bool IsAvx512Supported();
+}
@@ -63,7 +63,26 @@ struct GaussianMixtureModel
         originalMzArray(mzArray.begin(), mzArray.end()),
         originalMeanSpectrum(intensities.begin(), intensities.end()),
         components(std::move(components)),
-        isMerged(), isNoiseReduced(), mzMergingThreshold() // will be used in future.
+        isMerged(), isNoiseReduced(), mzMergingThreshold()
+    { }
+
+    /// <summary>
+    /// Constructor used for models, which components were post-processed.
+    /// </summary>
+    /// <param name="mzArray">M/z data shared by all spectra.</param>
+    /// <param name="intensities">Mean intensities at each point.</param>
+    /// <param name="components">Gaussian components.</param>
+    /// <param name="mergingThreshold">M/z threshold used in components merging.</param>
+    /// <param name="merged">Whether components closer than the threshold were merged.</param>
+    /// <param name="noiseReduced">Whether negligible components were removed.</param>
+    GaussianMixtureModel(const gsl::span<double> &mzArray,
+                         const gsl::span<double> &intensities,
+                         const std::vector<GaussianComponent> &&components,
+                         double mergingThreshold, bool merged, bool noiseReduced) :
+        originalMzArray(mzArray.begin(), mzArray.end()),
+        originalMeanSpectrum(intensities.begin(), intensities.end()),
+        components(std::move(components)),
+        isMerged(merged), isNoiseReduced(noiseReduced), mzMergingThreshold(mergingThreshold)
     { }
 
     /// <summary>
@@ -0,0 +1,177 @@
+/*
+ * GaussianMixtureModelSerialization.cpp
+ * Provides saving and loading of Gaussian Mixture Models.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#include <math.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include "Spectre.libException/CorruptedDataException.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModelSerialization.h"
+
+namespace spectre::unsupervised::gmm
+{
+namespace
+{
+constexpr char BINARY_TAG[4] = { 'S', 'G', 'M', 'M' };
+
+// values are read in chunks, so corrupted length fails on the end
+// of the stream instead of allocating arbitrary amount of memory
+constexpr uint64_t READ_CHUNK_SIZE = 1 << 16;
+
+static_assert(sizeof(GaussianComponent) == 3 * sizeof(double), "Components are written as raw triples.");
+
+template <typename T>
+void Write(std::ostream &stream, const T &value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+void WriteArray(std::ostream &stream, const std::vector<T> &values)
+{
+    Write(stream, (uint64_t)values.size());
+    stream.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+template <typename T>
+T Read(std::istream &stream)
+{
+    T value;
+    if (!stream.read(reinterpret_cast<char *>(&value), sizeof(T)))
+    {
+        throw spectre::core::exception::CorruptedDataException("Unexpected end of the model stream.");
+    }
+    return value;
+}
+
+template <typename T>
+std::vector<T> ReadArray(std::istream &stream)
+{
+    const uint64_t size = Read<uint64_t>(stream);
+    std::vector<T> values;
+    for (uint64_t begin = 0; begin < size; begin += READ_CHUNK_SIZE)
+    {
+        const size_t count = (size_t)std::min(READ_CHUNK_SIZE, size - begin);
+        values.resize(values.size() + count);
+        if (!stream.read(reinterpret_cast<char *>(values.data() + begin), count * sizeof(T)))
+        {
+            throw spectre::core::exception::CorruptedDataException("Unexpected end of the model stream.");
+        }
+    }
+    return values;
+}
+
+void WriteJsonNumber(std::ostream &stream, double value)
+{
+    if (isfinite(value))
+    {
+        stream << value;
+    }
+    else
+    {
+        stream << "null";
+    }
+}
+
+void WriteJsonArray(std::ostream &stream, const std::vector<double> &values)
+{
+    stream << '[';
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        if (i > 0)
+        {
+            stream << ',';
+        }
+        WriteJsonNumber(stream, values[i]);
+    }
+    stream << ']';
+}
+}
+
+void WriteBinary(const GaussianMixtureModel &model, std::ostream &stream)
+{
+    stream.write(BINARY_TAG, sizeof(BINARY_TAG));
+    Write(stream, GMM_BINARY_FORMAT_VERSION);
+    Write(stream, (uint8_t)model.isMerged);
+    Write(stream, (uint8_t)model.isNoiseReduced);
+    Write(stream, model.mzMergingThreshold);
+    WriteArray(stream, model.originalMzArray);
+    WriteArray(stream, model.originalMeanSpectrum);
+    WriteArray(stream, model.components);
+}
+
+GaussianMixtureModel ReadBinary(std::istream &stream)
+{
+    char tag[sizeof(BINARY_TAG)];
+    if (!stream.read(tag, sizeof(tag)) || memcmp(tag, BINARY_TAG, sizeof(tag)) != 0)
+    {
+        throw spectre::core::exception::CorruptedDataException("Stream does not contain a model.");
+    }
+    const uint32_t version = Read<uint32_t>(stream);
+    if (version != GMM_BINARY_FORMAT_VERSION)
+    {
+        throw spectre::core::exception::CorruptedDataException(
+            "Unsupported model format version " + std::to_string(version) + ".");
+    }
+    const bool isMerged = Read<uint8_t>(stream) != 0;
+    const bool isNoiseReduced = Read<uint8_t>(stream) != 0;
+    const double mzMergingThreshold = Read<double>(stream);
+    std::vector<double> mzArray = ReadArray<double>(stream);
+    std::vector<double> meanSpectrum = ReadArray<double>(stream);
+    std::vector<GaussianComponent> components = ReadArray<GaussianComponent>(stream);
+    if (mzArray.size() != meanSpectrum.size())
+    {
+        throw spectre::core::exception::CorruptedDataException("Sizes of m/z values and mean spectrum differ.");
+    }
+
+    return GaussianMixtureModel(
+        gsl::span<double>(mzArray.data(), (std::ptrdiff_t)mzArray.size()),
+        gsl::span<double>(meanSpectrum.data(), (std::ptrdiff_t)meanSpectrum.size()),
+        std::move(components), mzMergingThreshold, isMerged, isNoiseReduced
+    );
+}
+
+void WriteJson(const GaussianMixtureModel &model, std::ostream &stream)
+{
+    const std::streamsize precision = stream.precision(std::numeric_limits<double>::max_digits10);
+    stream << "{\"isMerged\":" << (model.isMerged ? "true" : "false")
+        << ",\"isNoiseReduced\":" << (model.isNoiseReduced ? "true" : "false")
+        << ",\"mzMergingThreshold\":";
+    WriteJsonNumber(stream, model.mzMergingThreshold);
+    stream << ",\"components\":[";
+    for (size_t k = 0; k < model.components.size(); k++)
+    {
+        const GaussianComponent &component = model.components[k];
+        stream << (k > 0 ? ",{\"mean\":" : "{\"mean\":");
+        WriteJsonNumber(stream, component.mean);
+        stream << ",\"deviation\":";
+        WriteJsonNumber(stream, component.deviation);
+        stream << ",\"weight\":";
+        WriteJsonNumber(stream, component.weight);
+        stream << '}';
+    }
+    stream << "],\"originalMzArray\":";
+    WriteJsonArray(stream, model.originalMzArray);
+    stream << ",\"originalMeanSpectrum\":";
+    WriteJsonArray(stream, model.originalMeanSpectrum);
+    stream << '}';
+    stream.precision(precision);
+}
+}
@@ -0,0 +1,59 @@
+/*
+ * GaussianMixtureModelSerialization.h
+ * Provides saving and loading of Gaussian Mixture Models.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Version of the binary format written by WriteBinary.
+/// </summary>
+constexpr uint32_t GMM_BINARY_FORMAT_VERSION = 1;
+
+/// <summary>
+/// Writes the model in compact binary format: "SGMM" tag, format version,
+/// merging flags and threshold, followed by m/z values, mean spectrum and
+/// components, each preceded by its 64-bit length. Numbers are written in
+/// native byte order, so files are portable between little-endian machines.
+/// </summary>
+/// <param name="model">Model to be written.</param>
+/// <param name="stream">Binary output stream.</param>
+void WriteBinary(const GaussianMixtureModel &model, std::ostream &stream);
+
+/// <summary>
+/// Reads the model written by WriteBinary.
+/// </summary>
+/// <param name="stream">Binary input stream.</param>
+/// <returns>Model read from the stream.</returns>
+/// <exception cref="CorruptedDataException">Thrown when the stream ends prematurely,
+/// is not a model, or is of unsupported format version.</exception>
+GaussianMixtureModel ReadBinary(std::istream &stream);
+
+/// <summary>
+/// Writes the model as JSON object of fields named as in GaussianMixtureModel,
+/// for inspection by external tools. Numbers are written with precision
+/// sufficient to restore them exactly, non-finite ones as null.
+/// </summary>
+/// <param name="model">Model to be written.</param>
+/// <param name="stream">Text output stream.</param>
+void WriteJson(const GaussianMixtureModel &model, std::ostream &stream);
+}
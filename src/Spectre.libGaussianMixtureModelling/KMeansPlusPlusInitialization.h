@@ -0,0 +1,377 @@
+/*
+ * KMeansPlusPlusInitialization.h
+ * Provides initialization of Expectation Maximization algorithm with
+ * intensity weighted k-means++ seeding refined by Lloyd iterations.
+ *
+ * Seeding picks the first mean with probability proportional to intensity
+ * and each next one with probability proportional to intensity times
+ * squared distance to the closest mean picked so far. As in greedy k-means++,
+ * 2 + log(k) candidates are sampled at each step and the one which reduces
+ * the sum of these products the most is kept. In one dimension,
+ * points closest to each of the sorted means form a contiguous range of
+ * sorted m/z values, delimited by midpoints between the neighbouring means,
+ * so a Lloyd iteration needs only binary searches and prefix sums of
+ * intensity, first and second moments, instead of a pass over the data.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <limits>
+#include <math.h>
+#include <random>
+#include <utility>
+#include <vector>
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+
+typedef std::mt19937_64 RandomNumberGenerator;
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Default limit of Lloyd iterations refining the seeded means.
+/// </summary>
+constexpr unsigned DEFAULT_LLOYD_ITERATIONS = 10;
+
+/// <summary>
+/// Default number of seedings, of which the one of the lowest
+/// k-means objective after refinement is kept.
+/// </summary>
+constexpr unsigned DEFAULT_SEEDING_TRIALS = 5;
+
+/// <summary>
+/// Class serves the purpose of initialization of gaussian components used by
+/// Expectation Maximization algorithm with intensity weighted k-means++.
+/// Means are spread over the peaks of the spectrum, deviations and weights
+/// are estimated from the points closest to each mean.
+/// </summary>
+class KMeansPlusPlusInitialization
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with data required during initialization.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="components">Gaussian components to be initialized.</param>
+    /// <param name="rngEngine">Mersenne-Twister engine to be used during seeding.</param>
+    /// <param name="lloydIterations">Maximal number of Lloyd iterations refining the seeded means.</param>
+    /// <param name="seedingTrials">Number of seedings, of which the best one is kept.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    KMeansPlusPlusInitialization(DataType *mzArray, DataType *intensities, unsigned size,
+                                 std::vector<GaussianComponent> &components, RandomNumberGenerator &rngEngine,
+                                 unsigned lloydIterations = DEFAULT_LLOYD_ITERATIONS,
+                                 unsigned seedingTrials = DEFAULT_SEEDING_TRIALS)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size), m_Components(components)
+          , m_RandomNumberGenerator(rngEngine), m_LloydIterations(lloydIterations)
+          , m_SeedingTrials(seedingTrials)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+    }
+
+    /// <summary>
+    /// Assigns means to gaussian components with k-means++ seeding followed
+    /// by Lloyd iterations, repeated a few times, as Lloyd iterations cannot
+    /// move a mean across a peak. Means of the lowest sum of intensity weighted
+    /// squared distances are kept. Components are ordered by their means afterwards.
+    /// </summary>
+    void AssignRandomMeans()
+    {
+        SortData();
+        ComputePrefixSums();
+
+        std::vector<GaussianComponent> best;
+        DataType lowestObjective = std::numeric_limits<DataType>::infinity();
+        for (unsigned trial = 0; trial == 0 || trial < m_SeedingTrials; trial++)
+        {
+            SeedMeans();
+            RefineMeans();
+            const DataType objective = Objective();
+            if (trial == 0 || objective < lowestObjective)
+            {
+                lowestObjective = objective;
+                best = m_Components;
+            }
+        }
+        m_Components = best;
+        AssignClusters();
+    }
+
+    /// <summary>
+    /// Assigns to each component intensity weighted deviation of the points
+    /// closest to its mean, but not less than the mean spacing of m/z values.
+    /// </summary>
+    void AssignVariances()
+    {
+        const DataType minimalDeviation = m_DataSize > 1
+            ? (m_pSortedMz[m_DataSize - 1] - m_pSortedMz[0]) / (m_DataSize - 1)
+            : 1.0;
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            const unsigned begin = m_Boundaries[k];
+            const unsigned end = m_Boundaries[k + 1];
+            const DataType mass = m_MassSums[end] - m_MassSums[begin];
+            DataType variance = 0.0;
+            if (mass > 0.0)
+            {
+                // second moment about the mean, from moments about the shift
+                const DataType mean = m_Components[k].mean - m_Shift;
+                const DataType firstMoment = (m_FirstMomentSums[end] - m_FirstMomentSums[begin]) / mass;
+                const DataType secondMoment = (m_SecondMomentSums[end] - m_SecondMomentSums[begin]) / mass;
+                variance = secondMoment - 2.0 * mean * firstMoment + mean * mean;
+            }
+            m_Components[k].deviation = std::max(sqrt(std::max(variance, 0.0)), minimalDeviation);
+        }
+    }
+
+    /// <summary>
+    /// Assigns to each component the fraction of total intensity of the points
+    /// closest to its mean. Components without such points get the weight of
+    /// a single point of mean intensity.
+    /// </summary>
+    void AssignWeights()
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        const DataType totalMass = m_MassSums[m_DataSize];
+        if (!(totalMass > 0.0))
+        {
+            for (unsigned k = 0; k < numberOfComponents; k++)
+            {
+                m_Components[k].weight = 1.0 / numberOfComponents;
+            }
+            return;
+        }
+
+        const DataType minimalMass = totalMass / m_DataSize;
+        DataType sum = 0.0;
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            const DataType mass = m_MassSums[m_Boundaries[k + 1]] - m_MassSums[m_Boundaries[k]];
+            m_Components[k].weight = std::max(mass, minimalMass);
+            sum += m_Components[k].weight;
+        }
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            m_Components[k].weight /= sum;
+        }
+    }
+
+private:
+    void SortData()
+    {
+        m_pSortedMz = m_pMzArray;
+        m_pSortedIntensities = m_pIntensities;
+        if (std::is_sorted(m_pMzArray, m_pMzArray + m_DataSize))
+        {
+            return;
+        }
+
+        std::vector<std::pair<DataType, DataType>> points(m_DataSize);
+        for (unsigned i = 0; i < m_DataSize; i++)
+        {
+            points[i] = { m_pMzArray[i], m_pIntensities[i] };
+        }
+        std::sort(points.begin(), points.end());
+        m_SortedMz.resize(m_DataSize);
+        m_SortedIntensities.resize(m_DataSize);
+        for (unsigned i = 0; i < m_DataSize; i++)
+        {
+            m_SortedMz[i] = points[i].first;
+            m_SortedIntensities[i] = points[i].second;
+        }
+        m_pSortedMz = m_SortedMz.data();
+        m_pSortedIntensities = m_SortedIntensities.data();
+    }
+
+    void ComputePrefixSums()
+    {
+        // moments are taken about the median m/z, so that their differences
+        // do not lose precision for m/z far from zero
+        m_Shift = m_pSortedMz[m_DataSize / 2];
+        m_MassSums.resize(m_DataSize + 1);
+        m_FirstMomentSums.resize(m_DataSize + 1);
+        m_SecondMomentSums.resize(m_DataSize + 1);
+        m_MassSums[0] = m_FirstMomentSums[0] = m_SecondMomentSums[0] = 0.0;
+        for (unsigned i = 0; i < m_DataSize; i++)
+        {
+            const DataType mass = std::max(m_pSortedIntensities[i], 0.0);
+            const DataType shifted = m_pSortedMz[i] - m_Shift;
+            m_MassSums[i + 1] = m_MassSums[i] + mass;
+            m_FirstMomentSums[i + 1] = m_FirstMomentSums[i] + mass * shifted;
+            m_SecondMomentSums[i + 1] = m_SecondMomentSums[i] + mass * shifted * shifted;
+        }
+    }
+
+    void SeedMeans()
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        const unsigned numberOfCandidates = 2 + (unsigned)log((DataType)numberOfComponents);
+        std::vector<DataType> distances(m_DataSize, std::numeric_limits<DataType>::infinity());
+        std::vector<DataType> cumulative(m_DataSize);
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            DataType total = 0.0;
+            for (unsigned i = 0; i < m_DataSize; i++)
+            {
+                const DataType mass = std::max(m_pSortedIntensities[i], 0.0);
+                total += k == 0 ? mass : mass * distances[i];
+                cumulative[i] = total;
+            }
+
+            // greedy variant: of a few sampled candidates, the one reducing
+            // intensity weighted squared distances the most is picked
+            unsigned chosen = 0;
+            DataType lowestPotential = std::numeric_limits<DataType>::infinity();
+            const unsigned candidates = k == 0 ? 1 : numberOfCandidates;
+            for (unsigned candidate = 0; candidate < candidates; candidate++)
+            {
+                const unsigned index = SampleIndex(cumulative, total);
+                const DataType potential = Potential(distances, m_pSortedMz[index]);
+                if (potential < lowestPotential)
+                {
+                    lowestPotential = potential;
+                    chosen = index;
+                }
+            }
+
+            const DataType mean = m_pSortedMz[chosen];
+            m_Components[k].mean = mean;
+            for (unsigned i = 0; i < m_DataSize; i++)
+            {
+                const DataType distance = m_pSortedMz[i] - mean;
+                distances[i] = std::min(distances[i], distance * distance);
+            }
+        }
+    }
+
+    unsigned SampleIndex(const std::vector<DataType> &cumulative, DataType total)
+    {
+        if (!(total > 0.0 && total < std::numeric_limits<DataType>::infinity()))
+        {
+            // all the points of positive intensity are already picked
+            return (unsigned)(m_RandomNumberGenerator() % m_DataSize);
+        }
+        const DataType threshold = std::uniform_real_distribution<DataType>(0.0, total)(m_RandomNumberGenerator);
+        const unsigned index = (unsigned)(std::upper_bound(cumulative.begin(), cumulative.end(), threshold)
+                                          - cumulative.begin());
+        return std::min(index, m_DataSize - 1);
+    }
+
+    DataType Potential(const std::vector<DataType> &distances, DataType mean) const
+    {
+        DataType potential = 0.0;
+        for (unsigned i = 0; i < m_DataSize; i++)
+        {
+            const DataType distance = m_pSortedMz[i] - mean;
+            potential += std::max(m_pSortedIntensities[i], 0.0) * std::min(distances[i], distance * distance);
+        }
+        return potential;
+    }
+
+    void RefineMeans()
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        for (unsigned iteration = 0; iteration < m_LloydIterations; iteration++)
+        {
+            AssignClusters();
+            bool changed = false;
+            for (unsigned k = 0; k < numberOfComponents; k++)
+            {
+                const unsigned begin = m_Boundaries[k];
+                const unsigned end = m_Boundaries[k + 1];
+                const DataType mass = m_MassSums[end] - m_MassSums[begin];
+                if (mass > 0.0)
+                {
+                    const DataType mean = m_Shift + (m_FirstMomentSums[end] - m_FirstMomentSums[begin]) / mass;
+                    changed = changed || mean != m_Components[k].mean;
+                    m_Components[k].mean = mean;
+                }
+            }
+            if (!changed)
+            {
+                break;
+            }
+        }
+        AssignClusters();
+    }
+
+    DataType Objective() const
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        DataType objective = 0.0;
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            const unsigned begin = m_Boundaries[k];
+            const unsigned end = m_Boundaries[k + 1];
+            const DataType mean = m_Components[k].mean - m_Shift;
+            objective += (m_SecondMomentSums[end] - m_SecondMomentSums[begin])
+                - 2.0 * mean * (m_FirstMomentSums[end] - m_FirstMomentSums[begin])
+                + mean * mean * (m_MassSums[end] - m_MassSums[begin]);
+        }
+        return objective;
+    }
+
+    void AssignClusters()
+    {
+        std::sort(m_Components.begin(), m_Components.end(),
+                  [](const GaussianComponent &first, const GaussianComponent &second)
+                  {
+                      return first.mean < second.mean;
+                  });
+
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        m_Boundaries.resize(numberOfComponents + 1);
+        m_Boundaries[0] = 0;
+        m_Boundaries[numberOfComponents] = m_DataSize;
+        for (unsigned k = 1; k < numberOfComponents; k++)
+        {
+            const DataType midpoint = 0.5 * (m_Components[k - 1].mean + m_Components[k].mean);
+            m_Boundaries[k] = (unsigned)(std::lower_bound(m_pSortedMz, m_pSortedMz + m_DataSize, midpoint) - m_pSortedMz);
+        }
+    }
+
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    std::vector<GaussianComponent> &m_Components;
+    RandomNumberGenerator &m_RandomNumberGenerator;
+    unsigned m_LloydIterations;
+    unsigned m_SeedingTrials;
+
+    const DataType *m_pSortedMz;
+    const DataType *m_pSortedIntensities;
+    std::vector<DataType> m_SortedMz;
+    std::vector<DataType> m_SortedIntensities;
+
+    DataType m_Shift;
+    std::vector<DataType> m_MassSums;
+    std::vector<DataType> m_FirstMomentSums;
+    std::vector<DataType> m_SecondMomentSums;
+    std::vector<unsigned> m_Boundaries;
+};
+}
@@ -0,0 +1,110 @@
+/*
+ * LogLikelihoodCalculatorLog.h
+ * Provides numerically stable implementation of log likelihood
+ * calculation used for Gaussian Mixture Modelling.
+ *
+ * Logarithm of mixture density is computed with log-sum-exp trick,
+ * as described in ExpectationRunnerLog.h, so the result stays finite
+ * for points far from all the components, where reference calculator
+ * takes logarithm of zero.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <math.h>
+#include <vector>
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/BlockwiseReduction.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianKernel.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Class serves the purpose of calculation of log likelihood for the gaussian
+/// mixture modelling in log domain. Data points are processed in parallel,
+/// while the result remains independent of the number of threads. Points
+/// of non-positive intensity are skipped.
+/// </summary>
+class LogLikelihoodCalculatorLog
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with data required for calculation of
+    /// log likelihood.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="components">Gaussian components.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    LogLikelihoodCalculatorLog(DataType *mzArray, DataType *intensities,
+                               unsigned size, const std::vector<GaussianComponent> &components)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size),
+          m_Components(components)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+    }
+
+    /// <summary>
+    /// Calculates the log likelihood of the data given current components.
+    /// </summary>
+    /// <returns>
+    /// Value of log likelihood.
+    /// </returns>
+    DataType CalculateLikelihood()
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        m_KernelComponents.Assign(m_Components);
+        m_Scratch.Reserve(numberOfComponents * KERNEL_BLOCK_SIZE);
+
+        return ReduceBlockwise(m_DataSize, 1,
+            [this](unsigned begin, unsigned end, DataType *sums)
+            {
+                DataType *affilations = m_Scratch.Get();
+                DataType logMixtureDensities[KERNEL_BLOCK_SIZE];
+                for (unsigned blockBegin = begin; blockBegin < end; blockBegin += KERNEL_BLOCK_SIZE)
+                {
+                    const unsigned count = blockBegin + KERNEL_BLOCK_SIZE < end ? KERNEL_BLOCK_SIZE : end - blockBegin;
+                    EvaluateLogMixture(m_pMzArray + blockBegin, count, m_KernelComponents,
+                                       affilations, logMixtureDensities);
+                    for (unsigned j = 0; j < count; j++)
+                    {
+                        const DataType intensity = m_pIntensities[blockBegin + j];
+                        // logarithm of non-positive intensity is not finite
+                        sums[0] += intensity > 0.0 ? logMixtureDensities[j] + log(intensity) : 0.0;
+                    }
+                }
+            })[0];
+    }
+
+private:
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    const std::vector<GaussianComponent> &m_Components;
+    GaussianKernelComponents m_KernelComponents;
+    ThreadScratch m_Scratch;
+};
+}
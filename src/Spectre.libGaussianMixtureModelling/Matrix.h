@@ -1,7 +1,8 @@
 /*
  * Matrix.h
- * Provides temporary implementation of matrix class that stores
- * its contents contiguously in the memory.
+ * Provides implementation of matrix class that stores its contents
+ * contiguously and aligned in the memory, in either row-major
+ * or column-major layout.
  *
 Copyright 2017 Michal Gallus
 
@@ -18,55 +19,195 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span.h>
 #include "Spectre.libGaussianMixtureModelling/DataType.h"
 
 namespace spectre::unsupervised::gmm
 {
 /// <summary>
-/// Struct serves as a temporary matrix representation.
-/// It stores its data contigiuously in the memory.
+/// Alignment of the matrix data and of each of its rows or columns, in bytes.
+/// Equal to the size of cache line.
 /// </summary>
-struct Matrix
+constexpr size_t MATRIX_ALIGNMENT = 64;
+
+/// <summary>
+/// Orders, in which elements of a matrix are laid out in the memory.
+/// </summary>
+enum class MatrixLayout
+{
+    /// <summary>
+    /// Elements of each row are contiguous.
+    /// </summary>
+    RowMajor,
+
+    /// <summary>
+    /// Elements of each column are contiguous.
+    /// </summary>
+    ColumnMajor
+};
+
+/// <summary>
+/// Class serves as a dense matrix representation. It owns its data and may
+/// be moved, but not copied. Each contiguous row or column starts at
+/// MATRIX_ALIGNMENT boundary, so consecutive ones are padded if needed.
+/// Affilation matrices are height of number of components and width
+/// of number of data points.
+/// </summary>
+class Matrix
 {
+public:
+    /// <summary>
+    /// Constructor allocating uninitialized data of given dimensions.
+    /// </summary>
+    /// <param name="height">Number of rows.</param>
+    /// <param name="width">Number of columns.</param>
+    /// <param name="layout">Order of the elements in the memory.</param>
+    Matrix(unsigned height, unsigned width, MatrixLayout layout = MatrixLayout::ColumnMajor)
+        : m_Height(height), m_Width(width), m_Layout(layout)
+    {
+        constexpr size_t elementsPerAlignment = MATRIX_ALIGNMENT / sizeof(DataType);
+        const size_t lineLength = layout == MatrixLayout::RowMajor ? width : height;
+        const size_t numberOfLines = layout == MatrixLayout::RowMajor ? height : width;
+        m_Stride = (lineLength + elementsPerAlignment - 1) / elementsPerAlignment * elementsPerAlignment;
+        m_Storage.reset(new DataType[m_Stride * numberOfLines + elementsPerAlignment]);
+        const uintptr_t address = reinterpret_cast<uintptr_t>(m_Storage.get());
+        const uintptr_t aligned = (address + MATRIX_ALIGNMENT - 1) / MATRIX_ALIGNMENT * MATRIX_ALIGNMENT;
+        m_pData = m_Storage.get() + (aligned - address) / sizeof(DataType);
+    }
+
+    Matrix(const Matrix &) = delete;
+    Matrix &operator=(const Matrix &) = delete;
+
+    /// <summary>
+    /// Move constructor taking over the data of other matrix, which is left empty.
+    /// </summary>
+    /// <param name="other">Matrix to take the data from.</param>
+    Matrix(Matrix &&other) noexcept
+        : m_Height(other.m_Height), m_Width(other.m_Width), m_Layout(other.m_Layout), m_Stride(other.m_Stride),
+          m_Storage(std::move(other.m_Storage)), m_pData(other.m_pData)
+    {
+        other.Release();
+    }
+
     /// <summary>
-    /// Constructor initializing the data based on given dimensions.
+    /// Move assignment taking over the data of other matrix, which is left empty.
     /// </summary>
-    /// <param name="height">Height of the array.</param>
-    /// <param name="width">Width of the array.</param>
-    Matrix(unsigned height, unsigned width)
+    /// <param name="other">Matrix to take the data from.</param>
+    /// <returns>This matrix.</returns>
+    Matrix &operator=(Matrix &&other) noexcept
     {
-        data = new DataType*[width];
-        if (width > 0)
+        if (this != &other)
         {
-            data[0] = new DataType[height * width]; // allocate data once
-            for (unsigned i = 1; i < width; ++i)
-                data[i] = data[0] + i * height; // assign pointers with
-        } // appropriate interval
-    } // to previously allocated
-    // data
+            m_Height = other.m_Height;
+            m_Width = other.m_Width;
+            m_Layout = other.m_Layout;
+            m_Stride = other.m_Stride;
+            m_Storage = std::move(other.m_Storage);
+            m_pData = other.m_pData;
+            other.Release();
+        }
+        return *this;
+    }
+
+    /// <summary>
+    /// Number of rows.
+    /// </summary>
+    unsigned Height() const
+    {
+        return m_Height;
+    }
+
+    /// <summary>
+    /// Number of columns.
+    /// </summary>
+    unsigned Width() const
+    {
+        return m_Width;
+    }
+
+    /// <summary>
+    /// Order of the elements in the memory.
+    /// </summary>
+    MatrixLayout Layout() const
+    {
+        return m_Layout;
+    }
+
+    /// <summary>
+    /// Returns element in given row and column.
+    /// </summary>
+    /// <param name="row">Index of the row.</param>
+    /// <param name="column">Index of the column.</param>
+    /// <returns>Reference to the element.</returns>
+    DataType &operator()(unsigned row, unsigned column)
+    {
+        return m_Layout == MatrixLayout::RowMajor ? At<MatrixLayout::RowMajor>(row, column)
+                                                  : At<MatrixLayout::ColumnMajor>(row, column);
+    }
+
+    /// <summary>
+    /// Returns element in given row and column.
+    /// </summary>
+    /// <param name="row">Index of the row.</param>
+    /// <param name="column">Index of the column.</param>
+    /// <returns>Reference to the element.</returns>
+    const DataType &operator()(unsigned row, unsigned column) const
+    {
+        return const_cast<Matrix &>(*this)(row, column);
+    }
 
     /// <summary>
-    /// Deallocate data and pointers created using constructor.
+    /// Returns element in given row and column without checking the layout
+    /// at runtime, so loops over elements may be vectorized. Layout is required
+    /// to be the one of the matrix.
     /// </summary>
-    ~Matrix()
+    /// <param name="row">Index of the row.</param>
+    /// <param name="column">Index of the column.</param>
+    /// <returns>Reference to the element.</returns>
+    template <MatrixLayout Layout>
+    DataType &At(unsigned row, unsigned column)
     {
-        delete[] data[0]; // delete allocated data
-        delete[] data; // delete allocated pointers
+        return Layout == MatrixLayout::RowMajor ? m_pData[row * m_Stride + column]
+                                                : m_pData[column * m_Stride + row];
     }
 
     /// <summary>
-    /// Returns a row indicated by passed index.
+    /// Returns contiguous row. Layout of the matrix is required to be row-major.
     /// </summary>
-    /// <param name="index">Index of the row.</param>
-    /// <returns>Row indicated by passed index.</returns>
-    DataType* operator[](unsigned index)
+    /// <param name="row">Index of the row.</param>
+    /// <returns>Elements of the row.</returns>
+    gsl::span<DataType> Row(unsigned row)
     {
-        return data[index];
+        return gsl::span<DataType>(m_pData + row * m_Stride, m_Width);
     }
 
     /// <summary>
-    /// Matrix data in a form of 2-dimensional array.
+    /// Returns contiguous column. Layout of the matrix is required to be column-major.
     /// </summary>
-    DataType **data;
+    /// <param name="column">Index of the column.</param>
+    /// <returns>Elements of the column.</returns>
+    gsl::span<DataType> Column(unsigned column)
+    {
+        return gsl::span<DataType>(m_pData + column * m_Stride, m_Height);
+    }
+
+private:
+    void Release()
+    {
+        m_Height = 0;
+        m_Width = 0;
+        m_Stride = 0;
+        m_pData = nullptr;
+    }
+
+    unsigned m_Height;
+    unsigned m_Width;
+    MatrixLayout m_Layout;
+    size_t m_Stride;
+    std::unique_ptr<DataType[]> m_Storage;
+    DataType *m_pData;
 };
 }
@@ -0,0 +1,224 @@
+/*
+ * MaximizationRunnerOpt.h
+ * Provides optimized, parallel implementation of maximization part
+ * of EM algorithm used for Gaussian Mixture Modelling.
+ *
+ * For the mathematical background please refer to MaximizationRunnerRef.h,
+ * which this class is numerically equivalent to, up to the rounding errors.
+ * All the sums over data points are computed by ReduceBlockwise, hence
+ * the results do not depend on the number of threads used.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <math.h>
+#include <vector>
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/BlockwiseReduction.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/Matrix.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Class serves the purpose of maximization step of Expectation Maximization algorithm.
+/// Each update walks the affilation matrix once, row by row, accumulating the sums
+/// of all the components at the same time.
+/// </summary>
+class MaximizationRunnerOpt
+{
+public:
+    /// <summary>
+    /// Layout of affilation matrix, in which affilations to each component are read contiguously.
+    /// </summary>
+    static constexpr MatrixLayout AFFILATION_LAYOUT = MatrixLayout::RowMajor;
+
+    /// <summary>
+    /// Constructor initializing the class with data required during maximization step.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="affilationMatrix">Matrix symbolising the probability of affilation
+    /// of each sample to a certain gaussian component.</param>
+    /// <param name="components">Gaussian components to be updated</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    MaximizationRunnerOpt(DataType *mzArray, DataType *intensities, unsigned size,
+                          Matrix &affilationMatrix, std::vector<GaussianComponent> &components)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size),
+          m_AffilationMatrix(affilationMatrix), m_Components(components)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        const DataType *pIntensities = m_pIntensities;
+        m_TotalDataSize = ReduceBlockwise(m_DataSize, 1,
+            [pIntensities](unsigned begin, unsigned end, DataType *sums)
+            {
+                for (unsigned i = begin; i < end; i++)
+                {
+                    sums[0] += pIntensities[i];
+                }
+            })[0];
+    }
+
+    /// <summary>
+    /// Updates weights in gaussian components, based on affilation (gamma) matrix.
+    /// </summary>
+    void UpdateWeights()
+    {
+        if (m_AffilationMatrix.Layout() == MatrixLayout::RowMajor)
+        {
+            UpdateWeights<MatrixLayout::RowMajor>();
+        }
+        else
+        {
+            UpdateWeights<MatrixLayout::ColumnMajor>();
+        }
+    }
+
+    /// <summary>
+    /// Updates means in gaussian components, based on affilation (gamma) matrix.
+    /// </summary>
+    void UpdateMeans()
+    {
+        if (m_AffilationMatrix.Layout() == MatrixLayout::RowMajor)
+        {
+            UpdateMeans<MatrixLayout::RowMajor>();
+        }
+        else
+        {
+            UpdateMeans<MatrixLayout::ColumnMajor>();
+        }
+    }
+
+    /// <summary>
+    /// Updates standard deviations in gaussian components, based on affilation
+    /// (gamma) matrix.
+    /// </summary>
+    void UpdateStdDeviations()
+    {
+        if (m_AffilationMatrix.Layout() == MatrixLayout::RowMajor)
+        {
+            UpdateStdDeviations<MatrixLayout::RowMajor>();
+        }
+        else
+        {
+            UpdateStdDeviations<MatrixLayout::ColumnMajor>();
+        }
+    }
+
+private:
+    template <MatrixLayout Layout>
+    void UpdateWeights()
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        const std::vector<DataType> weights = ReduceBlockwise(m_DataSize, numberOfComponents,
+            [this, numberOfComponents](unsigned begin, unsigned end, DataType *sums)
+            {
+                for (unsigned k = 0; k < numberOfComponents; k++)
+                {
+                    for (unsigned i = begin; i < end; i++)
+                    {
+                        sums[k] += m_AffilationMatrix.At<Layout>(k, i) * m_pIntensities[i];
+                    }
+                }
+            });
+
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            m_Components[k].weight = weights[k] / m_TotalDataSize;
+        }
+    }
+
+    template <MatrixLayout Layout>
+    void UpdateMeans()
+    {
+        // Sums are laid out as [denominators of all components, numerators of all components].
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        const std::vector<DataType> sums = ReduceBlockwise(m_DataSize, 2 * numberOfComponents,
+            [this, numberOfComponents](unsigned begin, unsigned end, DataType *blockSums)
+            {
+                DataType *denominators = blockSums;
+                DataType *numerators = blockSums + numberOfComponents;
+                for (unsigned k = 0; k < numberOfComponents; k++)
+                {
+                    for (unsigned i = begin; i < end; i++)
+                    {
+                        const DataType weightedAffilation = m_AffilationMatrix.At<Layout>(k, i) * m_pIntensities[i];
+                        denominators[k] += weightedAffilation;
+                        numerators[k] += weightedAffilation * m_pMzArray[i];
+                    }
+                }
+            });
+
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            m_Components[k].mean = sums[numberOfComponents + k] / sums[k];
+        }
+    }
+
+    template <MatrixLayout Layout>
+    void UpdateStdDeviations()
+    {
+        // Sums are laid out as [denominators of all components, numerators of all components].
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        m_Means.resize(numberOfComponents);
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            m_Means[k] = m_Components[k].mean;
+        }
+
+        const std::vector<DataType> sums = ReduceBlockwise(m_DataSize, 2 * numberOfComponents,
+            [this, numberOfComponents](unsigned begin, unsigned end, DataType *blockSums)
+            {
+                DataType *denominators = blockSums;
+                DataType *numerators = blockSums + numberOfComponents;
+                for (unsigned k = 0; k < numberOfComponents; k++)
+                {
+                    const DataType mean = m_Means[k];
+                    for (unsigned i = begin; i < end; i++)
+                    {
+                        const DataType weightedAffilation = m_AffilationMatrix.At<Layout>(k, i) * m_pIntensities[i];
+                        const DataType distance = m_pMzArray[i] - mean;
+                        denominators[k] += weightedAffilation;
+                        numerators[k] += weightedAffilation * distance * distance;
+                    }
+                }
+            });
+
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            m_Components[k].deviation = sqrt(sums[numberOfComponents + k] / sums[k]);
+        }
+    }
+
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    DataType m_TotalDataSize;
+    Matrix &m_AffilationMatrix;
+    std::vector<GaussianComponent> &m_Components;
+    std::vector<DataType> m_Means;
+};
+}
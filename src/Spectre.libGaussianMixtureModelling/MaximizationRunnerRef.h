@@ -55,6 +55,11 @@ namespace spectre::unsupervised::gmm
 class MaximizationRunnerRef
 {
 public:
+    /// <summary>
+    /// Layout of affilation matrix, in which affilations to each component are read contiguously.
+    /// </summary>
+    static constexpr MatrixLayout AFFILATION_LAYOUT = MatrixLayout::RowMajor;
+
     /// <summary>
     /// Constructor initializing the class with data required during maximization step.
     /// </summary>
@@ -102,7 +107,7 @@ public:
             DataType weight = 0.0;
             for (unsigned i = 0; i < m_DataSize; i++)
             {
-                weight += m_AffilationMatrix[i][k] * m_pIntensities[i];
+                weight += m_AffilationMatrix(k, i) * m_pIntensities[i];
             }
             m_Components[k].weight = weight / totalDataSize;
         }
@@ -124,8 +129,8 @@ public:
             DataType numerator = 0.0;
             for (unsigned i = 0; i < m_DataSize; i++)
             {
-                denominator += m_AffilationMatrix[i][k] * m_pIntensities[i];
-                numerator += m_AffilationMatrix[i][k] * m_pMzArray[i] * m_pIntensities[i];
+                denominator += m_AffilationMatrix(k, i) * m_pIntensities[i];
+                numerator += m_AffilationMatrix(k, i) * m_pMzArray[i] * m_pIntensities[i];
             }
             m_Components[k].mean = numerator / denominator;
         }
@@ -153,8 +158,8 @@ public:
             DataType numerator = 0.0;
             for (unsigned i = 0; i < m_DataSize; i++)
             {
-                denominator += m_AffilationMatrix[i][k] * m_pIntensities[i];
-                numerator += m_AffilationMatrix[i][k] * pow(m_pMzArray[i] - m_Components[k].mean, 2) * m_pIntensities[i];
+                denominator += m_AffilationMatrix(k, i) * m_pIntensities[i];
+                numerator += m_AffilationMatrix(k, i) * pow(m_pMzArray[i] - m_Components[k].mean, 2) * m_pIntensities[i];
             }
             m_Components[k].deviation = sqrt(numerator / denominator);
         }
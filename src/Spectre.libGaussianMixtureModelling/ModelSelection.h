@@ -0,0 +1,323 @@
+/*
+ * ModelSelection.h
+ * Provides selection of number of components of Gaussian Mixture Model
+ * with information criteria.
+ *
+ * Models of each number of components from the given range are fitted
+ * and scored with either Bayesian Information Criterion,
+ * BIC = p * log(n) - 2 * log(L), or Akaike Information Criterion,
+ * AIC = 2 * p - 2 * log(L), where p = 3 * K - 1 is the number of free
+ * parameters of K components and n is the number of data points.
+ * Model of the lowest score is selected.
+ *
+ * Iterations stop on relative change of log likelihood instead of the
+ * absolute one used by ExpectationMaximization. Models of more components
+ * than the data supports may need hundreds of thousands of iterations to
+ * meet the latter, while their score is settled far earlier. Fitting stops
+ * on log likelihood, which is not finite, as well, and models of score,
+ * which is not finite, are not selected.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <math.h>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/ConvergenceMonitor.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/FusedIterationRunner.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/KMeansPlusPlusInitialization.h"
+#include "Spectre.libGaussianMixtureModelling/RandomSeeds.h"
+#include "Spectre.libGaussianMixtureModelling/WeightedLogLikelihoodCalculator.h"
+
+typedef std::mt19937_64 RandomNumberGenerator;
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Default relative change of log likelihood, below which fitting of a model stops.
+/// </summary>
+constexpr DataType DEFAULT_SELECTION_TOLERANCE = 1e-6;
+
+/// <summary>
+/// Default maximal number of iterations of fitting of a single model.
+/// </summary>
+constexpr unsigned DEFAULT_SELECTION_MAX_ITERATIONS = 1000;
+
+/// <summary>
+/// Information criteria available for model selection.
+/// </summary>
+enum class InformationCriterion
+{
+    Bayesian,
+    Akaike
+};
+
+/// <summary>
+/// Score of a model of a single number of components.
+/// </summary>
+struct ModelScore
+{
+    /// <summary>
+    /// Number of components of the model.
+    /// </summary>
+    unsigned numberOfComponents;
+
+    /// <summary>
+    /// Log likelihood of the model.
+    /// </summary>
+    DataType logLikelihood;
+
+    /// <summary>
+    /// Value of the information criterion, the lower the better.
+    /// </summary>
+    DataType score;
+};
+
+/// <summary>
+/// Result of model selection.
+/// </summary>
+struct ModelSelectionResult
+{
+    /// <summary>
+    /// Model of the lowest score.
+    /// </summary>
+    GaussianMixtureModel model;
+
+    /// <summary>
+    /// Scores of the models of all the numbers of components, in increasing order of them.
+    /// </summary>
+    std::vector<ModelScore> scores;
+};
+
+/// <summary>
+/// Class fits Gaussian Mixture Models of a range of numbers of components
+/// and selects the one of the lowest information criterion.
+///
+/// The range is split into consecutive chains fitted in parallel. Within
+/// a chain, the first model is fitted from the initialization step, while
+/// each next one starts from the previous solution with its widest
+/// component split in two. Seed of the initialization of a chain is derived
+/// from the seed and the number of components it starts with, so the same
+/// cold fit is obtained for any range, but the result does depend on the
+/// number of chains.
+/// </summary>
+/// <param name="InitializationRunner">Class performing Initialization step of the em algorithm.</param>
+/// <param name="IterationRunner">Class performing whole iteration of the em algorithm,
+/// returning log likelihood of the components it started with.</param>
+/// <param name="LogLikelihoodCalculator">Class calculating log likelihood used in scores.</param>
+template <typename InitializationRunner = KMeansPlusPlusInitialization,
+          typename IterationRunner = FusedIterationRunner,
+          typename LogLikelihoodCalculator = WeightedLogLikelihoodCalculator>
+class ModelSelection
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with all algorithm necessary data.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="criterion">Information criterion scoring the models.</param>
+    /// <param name="numberOfChains">Number of chains of warm started fits, run in parallel.
+    /// 0 means number of hardware threads. Each chain starts with a cold fit.</param>
+    /// <param name="tolerance">Relative change of log likelihood, below which fitting of a model stops.</param>
+    /// <param name="maxIterations">Number of iterations, after which fitting of a model stops
+    /// regardless of the change of log likelihood. 0 means no limit.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    ModelSelection(DataType *mzArray, DataType *intensities, const unsigned size,
+                   InformationCriterion criterion = InformationCriterion::Bayesian, unsigned numberOfChains = 0,
+                   DataType tolerance = DEFAULT_SELECTION_TOLERANCE,
+                   unsigned maxIterations = DEFAULT_SELECTION_MAX_ITERATIONS)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size), m_Criterion(criterion)
+          , m_NumberOfChains(numberOfChains != 0 ? numberOfChains : std::max(std::thread::hardware_concurrency(), 1u))
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        m_Convergence.absoluteTolerance = 0.0;
+        m_Convergence.relativeTolerance = tolerance;
+        m_Convergence.maxIterations = maxIterations;
+    }
+
+    /// <summary>
+    /// Fits models of all the numbers of components from the given range
+    /// and selects the one of the lowest score. Random number generator of each
+    /// cold fit is seeded from the given seed and its number of components.
+    /// </summary>
+    /// <param name="minComponents">Lowest number of components, at least 1.</param>
+    /// <param name="maxComponents">Highest number of components, at least minComponents.</param>
+    /// <param name="seed">Seed from which seeds of the fits are derived.</param>
+    /// <returns>
+    /// Model of the lowest score, along with scores of all the models.
+    /// </returns>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when the range is empty,
+    /// or contains zero</exception>
+    ModelSelectionResult SelectModel(unsigned minComponents, unsigned maxComponents, uint64_t seed)
+    {
+        if (minComponents == 0)
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<unsigned>(
+                "minComponents", 1, std::numeric_limits<unsigned>::max(), minComponents);
+        }
+
+        if (maxComponents < minComponents)
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<unsigned>(
+                "maxComponents", minComponents, std::numeric_limits<unsigned>::max(), maxComponents);
+        }
+
+        const unsigned numberOfModels = maxComponents - minComponents + 1;
+        const unsigned numberOfChains = std::min(m_NumberOfChains, numberOfModels);
+        std::vector<std::vector<GaussianComponent>> components(numberOfModels);
+        std::vector<ModelScore> scores(numberOfModels);
+        std::vector<std::exception_ptr> errors(numberOfChains);
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int chain = 0; chain < (int)numberOfChains; chain++)
+        {
+            // models [first, last) are split evenly among the chains
+            const unsigned first = (unsigned)((uint64_t)numberOfModels * chain / numberOfChains);
+            const unsigned last = (unsigned)((uint64_t)numberOfModels * (chain + 1) / numberOfChains);
+            try
+            {
+                for (unsigned model = first; model < last; model++)
+                {
+                    if (model == first)
+                    {
+                        components[model].resize(minComponents + model);
+                        RandomNumberGenerator rngEngine(DeriveSeed(seed, minComponents + model));
+                        InitializationRunner initialization(m_pMzArray, m_pIntensities, m_DataSize,
+                                                            components[model], rngEngine);
+                        initialization.AssignRandomMeans();
+                        initialization.AssignVariances();
+                        initialization.AssignWeights();
+                    }
+                    else
+                    {
+                        components[model] = SplitWidestComponent(components[model - 1]);
+                    }
+                    Fit(components[model]);
+                    scores[model] = Score(components[model]);
+                }
+            }
+            catch (...)
+            {
+                errors[chain] = std::current_exception();
+            }
+        }
+
+        for (const std::exception_ptr &error : errors)
+        {
+            if (error != nullptr)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // score, which is not finite, never wins, unless all of them are such
+        unsigned best = 0;
+        for (unsigned model = 1; model < numberOfModels; model++)
+        {
+            if (scores[model].score < scores[best].score || !isfinite(scores[best].score))
+            {
+                best = model;
+            }
+        }
+
+        return ModelSelectionResult {
+            GaussianMixtureModel(
+                gsl::span<DataType>(m_pMzArray, m_DataSize),
+                gsl::span<DataType>(m_pIntensities, m_DataSize),
+                std::move(components[best])
+            ),
+            std::move(scores)
+        };
+    }
+
+    /// <summary>
+    /// Splits the component of the highest weight times deviation into two
+    /// of half the weight, preserving the mean and variance of the mixture.
+    /// </summary>
+    /// <param name="components">Components of the mixture.</param>
+    /// <returns>Components of the mixture with a single one more component.</returns>
+    static std::vector<GaussianComponent> SplitWidestComponent(const std::vector<GaussianComponent> &components)
+    {
+        std::vector<GaussianComponent> split(components);
+        const auto widest = std::max_element(split.begin(), split.end(),
+            [](const GaussianComponent &first, const GaussianComponent &second)
+            {
+                return first.weight * first.deviation < second.weight * second.deviation;
+            });
+        // two components at mean -+ deviation / 2, each of deviation * sqrt(3) / 2
+        const GaussianComponent original = *widest;
+        const GaussianComponent left = { original.mean - 0.5 * original.deviation,
+                                         0.5 * sqrt(3.0) * original.deviation, 0.5 * original.weight };
+        const GaussianComponent right = { original.mean + 0.5 * original.deviation,
+                                          0.5 * sqrt(3.0) * original.deviation, 0.5 * original.weight };
+        *widest = left;
+        split.insert(widest + 1, right);
+        return split;
+    }
+
+private:
+    void Fit(std::vector<GaussianComponent> &components) const
+    {
+        IterationRunner iteration(m_pMzArray, m_pIntensities, m_DataSize, components);
+        ConvergenceMonitor monitor(m_Convergence, m_pMzArray, m_DataSize, components);
+        DataType likelihood;
+        do
+        {
+            likelihood = iteration.Iterate();
+        }
+        while (monitor.Continue(likelihood, 0.0, 0.0, 0.0));
+    }
+
+    ModelScore Score(const std::vector<GaussianComponent> &components) const
+    {
+        const unsigned numberOfComponents = (unsigned)components.size();
+        const DataType logLikelihood =
+            LogLikelihoodCalculator(m_pMzArray, m_pIntensities, m_DataSize, components).CalculateLikelihood();
+        const DataType numberOfParameters = 3.0 * numberOfComponents - 1.0;
+        const DataType penalty = m_Criterion == InformationCriterion::Bayesian
+            ? numberOfParameters * log((DataType)m_DataSize)
+            : 2.0 * numberOfParameters;
+        return { numberOfComponents, logLikelihood, penalty - 2.0 * logLikelihood };
+    }
+
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    InformationCriterion m_Criterion;
+    unsigned m_NumberOfChains;
+    ConvergenceCriteria m_Convergence;
+};
+}
@@ -0,0 +1,199 @@
+/*
+ * MultiStartExpectationMaximization.h
+ * Provides implementation of Expectation Maximization algorithm restarted
+ * multiple times from random initializations, which keeps the best
+ * of the estimated models.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <vector>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/FusedExpectationMaximization.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/LogLikelihoodCalculatorLog.h"
+#include "Spectre.libGaussianMixtureModelling/RandomInitializationRef.h"
+#include "Spectre.libGaussianMixtureModelling/RandomSeeds.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Outcome of a single restart of the algorithm.
+/// </summary>
+struct RestartDiagnostics
+{
+    /// <summary>
+    /// Seed of the random number generator used by the restart. Running the
+    /// algorithm with RandomNumberGenerator(seed) reproduces the restart.
+    /// </summary>
+    uint64_t seed;
+
+    /// <summary>
+    /// Log likelihood of the model estimated by the restart.
+    /// </summary>
+    DataType logLikelihood;
+};
+
+/// <summary>
+/// Result of multiple restarts of the algorithm.
+/// </summary>
+struct MultiStartResult
+{
+    /// <summary>
+    /// Model of the highest log likelihood.
+    /// </summary>
+    GaussianMixtureModel model;
+
+    /// <summary>
+    /// Index of the restart that estimated the model.
+    /// </summary>
+    unsigned bestRestart;
+
+    /// <summary>
+    /// Outcomes of all the restarts, in order of their indices.
+    /// </summary>
+    std::vector<RestartDiagnostics> restarts;
+};
+
+/// <summary>
+/// Class runs independent instances of Expectation Maximization algorithm
+/// concurrently, each from a different random initialization, and picks
+/// the model of the highest log likelihood. All the instances share the
+/// same m/z and intensities arrays.
+/// </summary>
+/// <param name="ExpectationMaximizationAlgorithm">Class performing a single run of the algorithm,
+/// constructible like ExpectationMaximization. As many of them are run at once, the ones
+/// without affilation matrix are advisable.</param>
+/// <param name="LogLikelihoodCalculator">Class used to compare the estimated models.</param>
+template <typename ExpectationMaximizationAlgorithm = FusedExpectationMaximization<RandomInitializationRef>,
+          typename LogLikelihoodCalculator = LogLikelihoodCalculatorLog>
+class MultiStartExpectationMaximization
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with all algorithm necessary data.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="numberOfComponents">Number of Gaussian components that build up the approximation.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    MultiStartExpectationMaximization(DataType *mzArray, DataType *intensities, const unsigned size,
+                                      const unsigned numberOfComponents = 2)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size)
+          , m_NumberOfComponents(numberOfComponents)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+    }
+
+    /// <summary>
+    /// Performs given number of full algorithm runs in parallel. Seeds of the
+    /// runs are derived from the given one, so the result does not depend on
+    /// the number of threads, nor on the order in which the runs finish.
+    /// </summary>
+    /// <param name="restarts">Number of runs of the algorithm.</param>
+    /// <param name="seed">Seed from which seeds of the runs are derived.</param>
+    /// <returns>
+    /// Gaussian Mixture Model of the highest log likelihood, along with
+    /// outcomes of all the runs.
+    /// </returns>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when restarts is 0</exception>
+    MultiStartResult EstimateGmmMultiStart(unsigned restarts, uint64_t seed)
+    {
+        if (restarts == 0)
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<unsigned>(
+                "restarts", 1, std::numeric_limits<unsigned>::max(), restarts);
+        }
+
+        const std::vector<uint64_t> seeds = DeriveSeeds(seed, restarts);
+        std::vector<RestartDiagnostics> diagnostics(restarts);
+        for (unsigned restart = 0; restart < restarts; restart++)
+        {
+            diagnostics[restart] = { seeds[restart], std::numeric_limits<DataType>::quiet_NaN() };
+        }
+        std::vector<std::vector<GaussianComponent>> components(restarts);
+        std::vector<std::exception_ptr> errors(restarts);
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int restart = 0; restart < (int)restarts; restart++)
+        {
+            try
+            {
+                RandomNumberGenerator rngEngine(seeds[restart]);
+                ExpectationMaximizationAlgorithm algorithm(m_pMzArray, m_pIntensities, m_DataSize,
+                                                           rngEngine, m_NumberOfComponents);
+                components[restart] = algorithm.EstimateGmm().components;
+                diagnostics[restart].logLikelihood = LogLikelihoodCalculator(
+                    m_pMzArray, m_pIntensities, m_DataSize, components[restart]).CalculateLikelihood();
+            }
+            catch (...)
+            {
+                errors[restart] = std::current_exception();
+            }
+        }
+
+        for (const std::exception_ptr &error : errors)
+        {
+            if (error != nullptr)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        // NaN likelihood never wins, unless all of them are NaN
+        unsigned bestRestart = 0;
+        for (unsigned restart = 1; restart < restarts; restart++)
+        {
+            if (diagnostics[restart].logLikelihood > diagnostics[bestRestart].logLikelihood
+                || std::isnan(diagnostics[bestRestart].logLikelihood))
+            {
+                bestRestart = restart;
+            }
+        }
+
+        return MultiStartResult {
+            GaussianMixtureModel(
+                gsl::span<DataType>(m_pMzArray, m_DataSize),
+                gsl::span<DataType>(m_pIntensities, m_DataSize),
+                std::move(components[bestRestart])
+            ),
+            bestRestart,
+            std::move(diagnostics)
+        };
+    }
+
+private:
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    unsigned m_NumberOfComponents;
+};
+}
@@ -0,0 +1,324 @@
+/*
+ * OnlineExpectationMaximization.h
+ * Provides online (mini-batch) variant of Expectation Maximization
+ * algorithm used for Gaussian Mixture Modelling.
+ *
+ * Following O. Cappe and E. Moulines, "On-line expectation-maximization
+ * algorithm for latent data models", each step computes sufficient
+ * statistics of a mini-batch of data points, normalized by its total
+ * intensity, and blends them into the running statistics with step size
+ * gamma(t) = (t + 2)^(-stepExponent), for t counted from 0, so that even
+ * the first step keeps a part of the initialization for components the
+ * batch does not reach. Running statistics taken around
+ * the means of the components are exactly (weight, 0, weight * variance),
+ * so they are not stored apart from the components themselves.
+ *
+ * The updates assume each batch to be representative of the whole data.
+ * Hence a batch takes every n-th data point, spanning the whole m/z range,
+ * rather than a range of consecutive points, which would pull all the
+ * weight towards the peaks it contains.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/BlockwiseReduction.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianKernel.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/KMeansPlusPlusInitialization.h"
+#include "Spectre.libGaussianMixtureModelling/SufficientStatistics.h"
+
+typedef std::mt19937_64 RandomNumberGenerator;
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Default number of data points in a mini-batch.
+/// </summary>
+constexpr unsigned DEFAULT_ONLINE_BATCH_SIZE = 4096;
+
+/// <summary>
+/// Default exponent of decay of the step size, from range (0.5, 1].
+/// </summary>
+constexpr DataType DEFAULT_STEP_EXPONENT = 0.6;
+
+/// <summary>
+/// Orders, in which mini-batches are visited during a pass over the data.
+/// </summary>
+enum class BatchOrder
+{
+    /// <summary>
+    /// Random order, different in each pass.
+    /// </summary>
+    Random,
+
+    /// <summary>
+    /// The same order in each pass, i.e. by the index of the first data point.
+    /// </summary>
+    Sequential
+};
+
+/// <summary>
+/// Class fits Gaussian Mixture Model with online Expectation Maximization
+/// algorithm. Each step visits only a mini-batch of data points, so a single
+/// pass over the data updates the components many times. Model can be
+/// further refined with batches of data arriving later.
+/// </summary>
+/// <param name="InitializationRunner">Class performing Initialization step of the em algorithm, constructed
+/// from m/z values, intensities, size, components and random number generator.</param>
+template <typename InitializationRunner = KMeansPlusPlusInitialization>
+class OnlineExpectationMaximization
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with all algorithm necessary data.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="rngEngine">Mersenne-Twister engine to be used during initialization and batching.</param>
+    /// <param name="numberOfComponents">Number of Gaussian components that build up the approximation.</param>
+    /// <param name="batchSize">Number of data points in a mini-batch.</param>
+    /// <param name="stepExponent">Exponent of decay of the step size, from range (0.5, 1].</param>
+    /// <param name="order">Order, in which mini-batches are visited.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when batchSize is 0, or stepExponent
+    /// is out of range (0.5, 1]</exception>
+    OnlineExpectationMaximization(DataType *mzArray, DataType *intensities, const unsigned size,
+                                  RandomNumberGenerator &rngEngine, const unsigned numberOfComponents = 2,
+                                  unsigned batchSize = DEFAULT_ONLINE_BATCH_SIZE,
+                                  DataType stepExponent = DEFAULT_STEP_EXPONENT,
+                                  BatchOrder order = BatchOrder::Random)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size), m_RngEngine(rngEngine)
+          , m_Components(numberOfComponents), m_BatchSize(batchSize), m_StepExponent(stepExponent)
+          , m_Order(order), m_Steps(0), m_IsInitialized(false)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        if (batchSize == 0)
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<unsigned>(
+                "batchSize", 1, std::numeric_limits<unsigned>::max(), batchSize);
+        }
+
+        if (!(stepExponent > 0.5 && stepExponent <= 1.0))
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<DataType>(
+                "stepExponent", 0.5, 1.0, stepExponent);
+        }
+    }
+
+    /// <summary>
+    /// Initializes the components from the data given on construction and
+    /// performs the given number of passes over it, batch after batch.
+    /// </summary>
+    /// <param name="passes">Number of passes over the data.</param>
+    /// <returns>
+    /// Gaussian Mixture Model containing all the components with their appropriate
+    /// parameters.
+    /// </returns>
+    GaussianMixtureModel EstimateGmm(unsigned passes = 1)
+    {
+        Initialization();
+
+        const unsigned numberOfBatches = (m_DataSize + m_BatchSize - 1) / m_BatchSize;
+        std::vector<unsigned> batches(numberOfBatches);
+        std::iota(batches.begin(), batches.end(), 0u);
+        std::vector<DataType> mzs(m_BatchSize);
+        std::vector<DataType> intensities(m_BatchSize);
+        for (unsigned pass = 0; pass < passes; pass++)
+        {
+            if (m_Order == BatchOrder::Random)
+            {
+                std::shuffle(batches.begin(), batches.end(), m_RngEngine);
+            }
+            for (unsigned batch : batches)
+            {
+                unsigned count = 0;
+                for (unsigned i = batch; i < m_DataSize; i += numberOfBatches)
+                {
+                    mzs[count] = m_pMzArray[i];
+                    intensities[count] = m_pIntensities[i];
+                    count++;
+                }
+                Step(mzs.data(), intensities.data(), count);
+            }
+        }
+
+        return GaussianMixtureModel(
+            gsl::span<DataType>(m_pMzArray, m_DataSize),
+            gsl::span<DataType>(m_pIntensities, m_DataSize),
+            std::vector<GaussianComponent>(m_Components)
+        );
+    }
+
+    /// <summary>
+    /// Refines the components with a batch of new data, continuing the
+    /// decay of the step size. Initializes the components from the data
+    /// given on construction, if not initialized yet. The batch should
+    /// span the whole m/z range, e.g. be a spectrum of the next pixel.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values of the batch.</param>
+    /// <param name="intensities">Set of corresponding intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    void Update(const DataType *mzArray, const DataType *intensities, unsigned size)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        if (!m_IsInitialized)
+        {
+            Initialization();
+        }
+        Step(mzArray, intensities, size);
+    }
+
+    /// <summary>
+    /// Gets current components.
+    /// </summary>
+    /// <returns>Current components.</returns>
+    const std::vector<GaussianComponent> &GetComponents() const
+    {
+        return m_Components;
+    }
+
+    /// <summary>
+    /// Gets number of steps performed since initialization.
+    /// </summary>
+    /// <returns>Number of steps.</returns>
+    unsigned GetNumberOfSteps() const
+    {
+        return m_Steps;
+    }
+
+private:
+    void Initialization()
+    {
+        InitializationRunner initialization(m_pMzArray, m_pIntensities, m_DataSize, m_Components, m_RngEngine);
+        initialization.AssignRandomMeans();
+        initialization.AssignVariances();
+        initialization.AssignWeights();
+        m_Steps = 0;
+        m_IsInitialized = true;
+    }
+
+    void Step(const DataType *mzArray, const DataType *intensities, unsigned size)
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        GaussianKernelComponents kernelComponents;
+        kernelComponents.Assign(m_Components);
+
+        m_Densities.Reserve((size_t)numberOfComponents * KERNEL_BLOCK_SIZE);
+        // sums laid out as total intensity, then responsibilities, first and second moments of each component
+        const std::vector<DataType> sums = ReduceBlockwise(size, 1 + 3 * numberOfComponents,
+            [&](unsigned begin, unsigned end, DataType *blockSums)
+            {
+                DataType *densities = m_Densities.Get();
+                DataType denominators[KERNEL_BLOCK_SIZE];
+                for (unsigned blockBegin = begin; blockBegin < end; blockBegin += KERNEL_BLOCK_SIZE)
+                {
+                    const unsigned count = std::min(KERNEL_BLOCK_SIZE, end - blockBegin);
+                    const DataType *mzs = mzArray + blockBegin;
+                    std::fill(denominators, denominators + count, 0.0);
+                    for (unsigned k = 0; k < numberOfComponents; k++)
+                    {
+                        DataType *componentDensities = densities + k * KERNEL_BLOCK_SIZE;
+                        EvaluateGaussian(mzs, count, kernelComponents, k, componentDensities);
+                        for (unsigned j = 0; j < count; j++)
+                        {
+                            denominators[j] += componentDensities[j];
+                        }
+                    }
+
+                    for (unsigned j = 0; j < count; j++)
+                    {
+                        const DataType intensity = intensities[blockBegin + j];
+                        blockSums[0] += intensity;
+                        if (!(denominators[j] > 0.0))
+                        {
+                            continue;
+                        }
+                        const DataType intensityPerDensity = intensity / denominators[j];
+                        for (unsigned k = 0; k < numberOfComponents; k++)
+                        {
+                            const DataType weightedAffilation = densities[k * KERNEL_BLOCK_SIZE + j] * intensityPerDensity;
+                            const DataType distance = mzs[j] - m_Components[k].mean;
+                            blockSums[1 + k] += weightedAffilation;
+                            blockSums[1 + numberOfComponents + k] += weightedAffilation * distance;
+                            blockSums[1 + 2 * numberOfComponents + k] += weightedAffilation * distance * distance;
+                        }
+                    }
+                }
+            });
+
+        const DataType totalIntensity = sums[0];
+        if (!(totalIntensity > 0.0))
+        {
+            return;
+        }
+
+        const DataType step = pow((DataType)(m_Steps + 2), -m_StepExponent);
+        SufficientStatistics statistics(numberOfComponents);
+        statistics.Reset(m_Components);
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            const GaussianComponent &component = m_Components[k];
+            statistics.responsibilities[k] = (1.0 - step) * component.weight
+                + step * sums[1 + k] / totalIntensity;
+            statistics.firstMoments[k] = step * sums[1 + numberOfComponents + k] / totalIntensity;
+            statistics.secondMoments[k] = (1.0 - step) * component.weight * component.deviation * component.deviation
+                + step * sums[1 + 2 * numberOfComponents + k] / totalIntensity;
+        }
+        statistics.Maximize(1.0, m_Components);
+        m_Steps++;
+    }
+
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    RandomNumberGenerator &m_RngEngine;
+    std::vector<GaussianComponent> m_Components;
+    unsigned m_BatchSize;
+    DataType m_StepExponent;
+    BatchOrder m_Order;
+    unsigned m_Steps;
+    bool m_IsInitialized;
+    ThreadScratch m_Densities;
+};
+}
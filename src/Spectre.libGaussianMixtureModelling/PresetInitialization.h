@@ -0,0 +1,122 @@
+/*
+ * PresetInitialization.h
+ * Provides initialization of Expectation Maximization algorithm
+ * with components of a previously estimated model.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <math.h>
+#include <limits>
+#include <random>
+#include <vector>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+
+typedef std::mt19937_64 RandomNumberGenerator;
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Class serves the purpose of warm start of Expectation Maximization algorithm.
+/// Components are expected to be preset, e.g. with components of a model read
+/// by ReadBinary, which ExpectationMaximization and FusedExpectationMaximization
+/// do when constructed from initial components. Means and deviations are kept and weights are only
+/// normalized, so the algorithm resumes from the preset model and converges
+/// in a few iterations, when the data changed slightly.
+/// </summary>
+class PresetInitialization
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with data required during initialization.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="components">Preset gaussian components.</param>
+    /// <param name="rngEngine">Mersenne-Twister engine, not used.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when any of the components has non-positive
+    /// deviation or negative weight, which is also the case for components not preset at all.</exception>
+    PresetInitialization(DataType *mzArray, DataType *intensities, unsigned /*size*/,
+                         std::vector<GaussianComponent> &components, RandomNumberGenerator & /*rngEngine*/)
+        : m_Components(components)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        for (const GaussianComponent &component : components)
+        {
+            if (!(component.deviation > 0.0 && isfinite(component.deviation)))
+            {
+                throw spectre::core::exception::ArgumentOutOfRangeException<DataType>(
+                    "deviation", std::numeric_limits<DataType>::min(), std::numeric_limits<DataType>::max(),
+                    component.deviation);
+            }
+            if (!(component.weight >= 0.0 && isfinite(component.weight)))
+            {
+                throw spectre::core::exception::ArgumentOutOfRangeException<DataType>(
+                    "weight", 0.0, std::numeric_limits<DataType>::max(), component.weight);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Keeps preset means.
+    /// </summary>
+    void AssignRandomMeans()
+    {
+    }
+
+    /// <summary>
+    /// Keeps preset deviations.
+    /// </summary>
+    void AssignVariances()
+    {
+    }
+
+    /// <summary>
+    /// Normalizes preset weights to sum up to 1, as they may not,
+    /// when some of the estimated components were removed.
+    /// </summary>
+    void AssignWeights()
+    {
+        DataType totalWeight = 0.0;
+        for (const GaussianComponent &component : m_Components)
+        {
+            totalWeight += component.weight;
+        }
+        for (GaussianComponent &component : m_Components)
+        {
+            component.weight = totalWeight > 0.0 ? component.weight / totalWeight
+                                                 : 1.0 / (DataType)m_Components.size();
+        }
+    }
+
+private:
+    std::vector<GaussianComponent> &m_Components;
+};
+}
@@ -67,6 +67,22 @@ public:
         }
     }
 
+    /// <summary>
+    /// Constructor used by ExpectationMaximization, which provides intensities
+    /// to all the initialization runners. Intensities are not used.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values, ignored.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="components">Gaussian components to be initialized.</param>
+    /// <param name="rngEngine">Mersenne-Twister engine to be used during initialization step.</param>
+    /// <exception cref="ArgumentNullException">Thrown when mzArray pointer is null</exception>
+    RandomInitializationRef(DataType *mzArray, DataType * /*intensities*/, unsigned size,
+                            std::vector<GaussianComponent> &components, RandomNumberGenerator &rngEngine) :
+        RandomInitializationRef(mzArray, size, components, rngEngine)
+    {
+    }
+
     /// <summary>
     /// Assigns means to gaussian components, by choosing random samples from the dataset.
     /// </summary>
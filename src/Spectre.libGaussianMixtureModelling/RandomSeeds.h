@@ -0,0 +1,65 @@
+/*
+ * RandomSeeds.h
+ * Provides derivation of seeds of independent random number generators
+ * from a single seed.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Derives seeds for given number of random number generators from a single
+/// seed, so that generators used by parallel tasks are independent and
+/// results do not depend on the order in which the tasks run.
+/// </summary>
+/// <param name="seed">Seed from which the seeds are derived.</param>
+/// <param name="count">Number of seeds to derive.</param>
+/// <returns>Derived seeds.</returns>
+inline std::vector<uint64_t> DeriveSeeds(uint64_t seed, unsigned count)
+{
+    std::seed_seq sequence { (uint32_t)seed, (uint32_t)(seed >> 32) };
+    std::vector<uint32_t> words(2 * count);
+    sequence.generate(words.begin(), words.end());
+
+    std::vector<uint64_t> seeds(count);
+    for (unsigned i = 0; i < count; i++)
+    {
+        seeds[i] = ((uint64_t)words[2 * i] << 32) | words[2 * i + 1];
+    }
+    return seeds;
+}
+
+/// <summary>
+/// Derives seed of a random number generator identified by a key from
+/// a single seed. Unlike DeriveSeeds, the result depends only on the seed
+/// and the key, not on how many other generators are seeded.
+/// </summary>
+/// <param name="seed">Seed from which the seed is derived.</param>
+/// <param name="key">Identifier of the generator.</param>
+/// <returns>Derived seed.</returns>
+inline uint64_t DeriveSeed(uint64_t seed, uint64_t key)
+{
+    std::seed_seq sequence { (uint32_t)seed, (uint32_t)(seed >> 32), (uint32_t)key, (uint32_t)(key >> 32) };
+    uint32_t words[2];
+    sequence.generate(words, words + 2);
+    return ((uint64_t)words[0] << 32) | words[1];
+}
+}
@@ -0,0 +1,319 @@
+/*
+ * SegmentedDecomposition.h
+ * Provides decomposition of long spectra into Gaussian Mixture Model
+ * segment by segment.
+ *
+ * The m/z axis is split at the lowest intensities found around every
+ * segmentLength points. Each segment is fitted by its own instance of
+ * Expectation Maximization algorithm, over the segment extended on both
+ * sides by between overlap and twice overlap points, up to the lowest
+ * intensity within that window, so that peaks close to the boundary are
+ * modelled together with their neighbours. Of the fitted components,
+ * only the ones of means within the segment itself are kept, hence each
+ * peak at a boundary is taken from a single segment.
+ *
+ * Number of components of a segment is the number of local maxima of
+ * intensity inside its extended range, higher than minPeakHeight times
+ * the highest intensity there. Noisy spectra should be denoised beforehand.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <vector>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/FusedExpectationMaximization.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/KMeansPlusPlusInitialization.h"
+#include "Spectre.libGaussianMixtureModelling/RandomSeeds.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Default number of points between consecutive splits of the spectrum.
+/// </summary>
+constexpr unsigned DEFAULT_SEGMENT_LENGTH = 2048;
+
+/// <summary>
+/// Default minimal number of points by which segments are extended on both sides.
+/// </summary>
+constexpr unsigned DEFAULT_SEGMENT_OVERLAP = 128;
+
+/// <summary>
+/// Default fraction of the highest intensity of a segment, below which local maxima are not counted as peaks.
+/// </summary>
+constexpr DataType DEFAULT_MIN_PEAK_HEIGHT = 0.01;
+
+/// <summary>
+/// Range of points of the spectrum modelled by a single instance of the algorithm.
+/// </summary>
+struct SpectrumSegment
+{
+    /// <summary>
+    /// Index of the first point of the segment.
+    /// </summary>
+    unsigned begin;
+
+    /// <summary>
+    /// Index past the last point of the segment.
+    /// </summary>
+    unsigned end;
+
+    /// <summary>
+    /// Index of the first point the segment is fitted over.
+    /// </summary>
+    unsigned fitBegin;
+
+    /// <summary>
+    /// Index past the last point the segment is fitted over.
+    /// </summary>
+    unsigned fitEnd;
+
+    /// <summary>
+    /// Number of components fitted to the segment.
+    /// </summary>
+    unsigned numberOfComponents;
+};
+
+/// <summary>
+/// Class decomposes a spectrum into Gaussian Mixture Model by fitting
+/// overlapping segments of the spectrum independently, in parallel.
+/// Working set of each fit is limited to its segment, which keeps it
+/// in the cache, and the cost of an iteration grows with squared
+/// segment length instead of squared spectrum length.
+/// </summary>
+/// <param name="ExpectationMaximizationAlgorithm">Class performing a single run of the algorithm,
+/// constructible like ExpectationMaximization.</param>
+template <typename ExpectationMaximizationAlgorithm = FusedExpectationMaximization<KMeansPlusPlusInitialization>>
+class SegmentedDecomposition
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with all algorithm necessary data.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values, sorted in ascending order.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="segmentLength">Approximate number of points of a segment.</param>
+    /// <param name="overlap">Minimal number of points by which segments are extended on both sides.</param>
+    /// <param name="minPeakHeight">Fraction of the highest intensity of a segment, below which
+    /// local maxima are not counted as peaks.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when segmentLength is 0</exception>
+    SegmentedDecomposition(DataType *mzArray, DataType *intensities, const unsigned size,
+                           unsigned segmentLength = DEFAULT_SEGMENT_LENGTH,
+                           unsigned overlap = DEFAULT_SEGMENT_OVERLAP,
+                           DataType minPeakHeight = DEFAULT_MIN_PEAK_HEIGHT)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size)
+          , m_SegmentLength(segmentLength), m_Overlap(overlap), m_MinPeakHeight(minPeakHeight)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        if (segmentLength == 0)
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<unsigned>(
+                "segmentLength", 1, std::numeric_limits<unsigned>::max(), segmentLength);
+        }
+    }
+
+    /// <summary>
+    /// Splits the spectrum into segments. Each split is placed at the point
+    /// of the lowest intensity within half of segment length around the
+    /// multiple of segment length following the previous split.
+    /// </summary>
+    /// <returns>Consecutive segments covering the whole spectrum.</returns>
+    std::vector<SpectrumSegment> FindSegments() const
+    {
+        std::vector<SpectrumSegment> segments;
+        unsigned begin = 0;
+        while (begin < m_DataSize)
+        {
+            unsigned end = m_DataSize;
+            const unsigned target = begin + m_SegmentLength;
+            if (target + m_SegmentLength / 2 < m_DataSize)
+            {
+                end = FindMinimum(std::max(target - m_SegmentLength / 2, begin + 1),
+                                  target + m_SegmentLength / 2 + 1);
+            }
+
+            SpectrumSegment segment;
+            segment.begin = begin;
+            segment.end = end;
+            segment.fitBegin = begin > m_Overlap
+                ? FindMinimum(begin > 2 * m_Overlap ? begin - 2 * m_Overlap : 0, begin - m_Overlap + 1)
+                : 0;
+            segment.fitEnd = end + m_Overlap < m_DataSize
+                ? FindMinimum(end + m_Overlap - 1, std::min(end + 2 * m_Overlap, m_DataSize)) + 1
+                : m_DataSize;
+            segment.numberOfComponents = CountPeaks(segment.fitBegin, segment.fitEnd);
+            segments.push_back(segment);
+            begin = end;
+        }
+        return segments;
+    }
+
+    /// <summary>
+    /// Fits all the segments in parallel and gathers their components into
+    /// a single model. Weight of each component is scaled by the fraction of
+    /// total intensity covered by its segment.
+    /// </summary>
+    /// <param name="seed">Seed from which seeds of the segments are derived.</param>
+    /// <returns>
+    /// Gaussian Mixture Model of the whole spectrum, with components ordered by mean.
+    /// </returns>
+    GaussianMixtureModel EstimateGmm(uint64_t seed)
+    {
+        const std::vector<SpectrumSegment> segments = FindSegments();
+        const unsigned numberOfSegments = (unsigned)segments.size();
+        const std::vector<uint64_t> seeds = DeriveSeeds(seed, numberOfSegments);
+        std::vector<std::vector<GaussianComponent>> segmentComponents(numberOfSegments);
+        std::vector<std::exception_ptr> errors(numberOfSegments);
+
+        DataType totalIntensity = 0.0;
+        for (unsigned i = 0; i < m_DataSize; i++)
+        {
+            totalIntensity += m_pIntensities[i];
+        }
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int s = 0; s < (int)numberOfSegments; s++)
+        {
+            try
+            {
+                segmentComponents[s] = FitSegment(segments[s], seeds[s], totalIntensity);
+            }
+            catch (...)
+            {
+                errors[s] = std::current_exception();
+            }
+        }
+
+        for (const std::exception_ptr &error : errors)
+        {
+            if (error != nullptr)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        std::vector<GaussianComponent> components;
+        DataType totalWeight = 0.0;
+        for (const std::vector<GaussianComponent> &fitted : segmentComponents)
+        {
+            for (const GaussianComponent &component : fitted)
+            {
+                components.push_back(component);
+                totalWeight += component.weight;
+            }
+        }
+        for (GaussianComponent &component : components)
+        {
+            component.weight /= totalWeight;
+        }
+        std::sort(components.begin(), components.end(),
+                  [](const GaussianComponent &first, const GaussianComponent &second)
+                  {
+                      return first.mean < second.mean;
+                  });
+
+        return GaussianMixtureModel(
+            gsl::span<DataType>(m_pMzArray, m_DataSize),
+            gsl::span<DataType>(m_pIntensities, m_DataSize),
+            std::move(components)
+        );
+    }
+
+private:
+    unsigned FindMinimum(unsigned begin, unsigned end) const
+    {
+        return (unsigned)(std::min_element(m_pIntensities + begin, m_pIntensities + end) - m_pIntensities);
+    }
+
+    unsigned CountPeaks(unsigned begin, unsigned end) const
+    {
+        const DataType threshold = m_MinPeakHeight * *std::max_element(m_pIntensities + begin, m_pIntensities + end);
+        // maxima at the ends belong to peaks centred outside of the range,
+        // while plateaus count once, at their first point
+        unsigned peaks = 0;
+        for (unsigned i = begin + 1; i + 1 < end; i++)
+        {
+            if (m_pIntensities[i] > threshold
+                && m_pIntensities[i] > m_pIntensities[i - 1] && m_pIntensities[i] >= m_pIntensities[i + 1])
+            {
+                peaks++;
+            }
+        }
+        return std::max(peaks, 1u);
+    }
+
+    std::vector<GaussianComponent> FitSegment(const SpectrumSegment &segment, uint64_t seed,
+                                              DataType totalIntensity)
+    {
+        const unsigned fitSize = segment.fitEnd - segment.fitBegin;
+        DataType segmentIntensity = 0.0;
+        for (unsigned i = segment.fitBegin; i < segment.fitEnd; i++)
+        {
+            segmentIntensity += m_pIntensities[i];
+        }
+        if (!(segmentIntensity > 0.0))
+        {
+            return std::vector<GaussianComponent>();
+        }
+
+        RandomNumberGenerator rngEngine(seed);
+        ExpectationMaximizationAlgorithm algorithm(m_pMzArray + segment.fitBegin, m_pIntensities + segment.fitBegin,
+                                                   fitSize, rngEngine, segment.numberOfComponents);
+        const GaussianMixtureModel model = algorithm.EstimateGmm();
+
+        // the last segment keeps components right of the spectrum as well
+        const DataType lowerBound = m_pMzArray[segment.begin];
+        const DataType upperBound = segment.end < m_DataSize
+            ? m_pMzArray[segment.end]
+            : std::numeric_limits<DataType>::infinity();
+        const bool isFirst = segment.begin == 0;
+        std::vector<GaussianComponent> kept;
+        for (const GaussianComponent &component : model.components)
+        {
+            if ((isFirst || component.mean >= lowerBound) && component.mean < upperBound)
+            {
+                kept.push_back({ component.mean, component.deviation,
+                                 component.weight * segmentIntensity / totalIntensity });
+            }
+        }
+        return kept;
+    }
+
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    unsigned m_SegmentLength;
+    unsigned m_Overlap;
+    DataType m_MinPeakHeight;
+};
+}
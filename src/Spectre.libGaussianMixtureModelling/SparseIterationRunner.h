@@ -0,0 +1,253 @@
+/*
+ * SparseIterationRunner.h
+ * Provides implementation of a whole iteration of EM algorithm used for
+ * Gaussian Mixture Modelling, which evaluates each component only within
+ * its truncated support.
+ *
+ * Gaussian density more than a few standard deviations away from the mean
+ * is negligible (below exp(-32) of its peak value at 8 deviations), hence
+ * in sorted m/z array each component is evaluated only in the window of
+ * indices found with binary search. For spectra decomposed into many narrow
+ * components this lowers the cost of iteration from O(N * K) to O(N * k),
+ * where k is the number of components overlapping at a single point.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianKernel.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/StreamingIterationRunner.h"
+#include "Spectre.libGaussianMixtureModelling/SufficientStatistics.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Default half-width of the component support, in standard deviations.
+/// </summary>
+constexpr DataType DEFAULT_SUPPORT_CUTOFF = 8.0;
+
+/// <summary>
+/// Class performs whole iterations of Expectation Maximization algorithm
+/// like StreamingIterationRunner does, but evaluates each component only
+/// within cutoff standard deviations from its mean. Requires m/z values
+/// to be sorted in ascending order. Points lying outside of support of all
+/// the components are affiliated only to the components with closest means.
+/// </summary>
+class SparseIterationRunner : public StreamingIterationRunner
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with data required during iterations.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values, sorted in ascending order.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="components">Gaussian components to be updated.</param>
+    /// <param name="cutoff">Half-width of the component support, in standard deviations.</param>
+    /// <param name="numberOfChunks">Number of chunks data is split into. Defaults
+    /// to number of hardware threads.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when cutoff is not positive</exception>
+    SparseIterationRunner(DataType *mzArray, DataType *intensities, unsigned size,
+                          std::vector<GaussianComponent> &components,
+                          DataType cutoff = DEFAULT_SUPPORT_CUTOFF, unsigned numberOfChunks = 0)
+        : StreamingIterationRunner(mzArray, intensities, size, components, numberOfChunks), m_Cutoff(cutoff)
+    {
+        if (!(cutoff > 0.0))
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<DataType>(
+                "cutoff", 0.0, std::numeric_limits<DataType>::max(), cutoff);
+        }
+    }
+
+protected:
+    /// <summary>
+    /// Resets given statistics, precomputes parameters of the Gaussians,
+    /// finds windows of their support and orders them by means.
+    /// </summary>
+    /// <param name="statistics">Statistics to be reset.</param>
+    void PrepareIteration(SufficientStatistics &statistics) override
+    {
+        FusedIterationRunner::PrepareIteration(statistics);
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        const DataType *mzBegin = m_pMzArray;
+        const DataType *mzEnd = m_pMzArray + m_DataSize;
+        m_WindowBegins.resize(numberOfComponents);
+        m_WindowEnds.resize(numberOfComponents);
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            const DataType halfWidth = m_Cutoff * m_Components[k].deviation;
+            m_WindowBegins[k] = (unsigned)(std::lower_bound(mzBegin, mzEnd, m_Components[k].mean - halfWidth) - mzBegin);
+            m_WindowEnds[k] = (unsigned)(std::upper_bound(mzBegin, mzEnd, m_Components[k].mean + halfWidth) - mzBegin);
+        }
+
+        m_MeanOrder.resize(numberOfComponents);
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            m_MeanOrder[k] = k;
+        }
+        std::sort(m_MeanOrder.begin(), m_MeanOrder.end(),
+                  [this](unsigned first, unsigned second) { return m_Components[first].mean < m_Components[second].mean; });
+        m_SortedMeans.resize(numberOfComponents);
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            m_SortedMeans[k] = m_Components[m_MeanOrder[k]].mean;
+        }
+    }
+
+    /// <summary>
+    /// Accumulates contributions of data points [begin, end) into the statistics,
+    /// evaluating only components, which support covers them.
+    /// </summary>
+    /// <param name="begin">Index of the first data point.</param>
+    /// <param name="end">Index past the last data point.</param>
+    /// <param name="statistics">Statistics, which shifts were already set.</param>
+    /// <param name="densities">Buffer for KERNEL_BLOCK_SIZE weighted densities
+    /// of each of the components.</param>
+    void Accumulate(unsigned begin, unsigned end, SufficientStatistics &statistics, DataType *densities) const override
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        DataType denominators[KERNEL_BLOCK_SIZE];
+        DataType intensitiesPerDensity[KERNEL_BLOCK_SIZE];
+        for (unsigned blockBegin = begin; blockBegin < end; blockBegin += KERNEL_BLOCK_SIZE)
+        {
+            const unsigned count = blockBegin + KERNEL_BLOCK_SIZE < end ? KERNEL_BLOCK_SIZE : end - blockBegin;
+            const unsigned blockEnd = blockBegin + count;
+            const DataType *mzs = m_pMzArray + blockBegin;
+
+            std::fill(denominators, denominators + count, 0.0);
+            for (unsigned k = 0; k < numberOfComponents; k++)
+            {
+                if (CoversBlock(k, blockBegin, blockEnd))
+                {
+                    const unsigned from = std::max(m_WindowBegins[k], blockBegin) - blockBegin;
+                    const unsigned to = std::min(m_WindowEnds[k], blockEnd) - blockBegin;
+                    DataType *componentDensities = densities + k * KERNEL_BLOCK_SIZE;
+                    EvaluateGaussian(mzs + from, to - from, m_KernelComponents, k, componentDensities + from);
+                    for (unsigned j = from; j < to; j++)
+                    {
+                        denominators[j] += componentDensities[j];
+                    }
+                }
+            }
+
+            for (unsigned j = 0; j < count; j++)
+            {
+                const DataType intensity = m_pIntensities[blockBegin + j];
+                if (denominators[j] > 0.0)
+                {
+                    intensitiesPerDensity[j] = intensity / denominators[j];
+                    // points of zero intensity do not contribute to the likelihood
+                    if (intensity > 0.0)
+                    {
+                        statistics.logLikelihood += log(denominators[j] * intensity);
+                    }
+                }
+                else
+                {
+                    // out of support of all the components
+                    intensitiesPerDensity[j] = 0.0;
+                    if (intensity > 0.0)
+                    {
+                        AccumulateFromNeighbours(mzs[j], intensity, statistics);
+                    }
+                }
+            }
+
+            for (unsigned k = 0; k < numberOfComponents; k++)
+            {
+                if (CoversBlock(k, blockBegin, blockEnd))
+                {
+                    const unsigned from = std::max(m_WindowBegins[k], blockBegin) - blockBegin;
+                    const unsigned to = std::min(m_WindowEnds[k], blockEnd) - blockBegin;
+                    const DataType *componentDensities = densities + k * KERNEL_BLOCK_SIZE;
+                    for (unsigned j = from; j < to; j++)
+                    {
+                        statistics.Add(k, componentDensities[j] * intensitiesPerDensity[j], mzs[j]);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    /// <summary>
+    /// Checks whether support of k-th component intersects the block of data points.
+    /// </summary>
+    bool CoversBlock(unsigned k, unsigned blockBegin, unsigned blockEnd) const
+    {
+        return m_WindowBegins[k] < blockEnd && m_WindowEnds[k] > blockBegin
+            && m_WindowBegins[k] < m_WindowEnds[k];
+    }
+
+    /// <summary>
+    /// Accumulates contribution of a single data point lying out of support
+    /// of all the components. The point is affiliated only to the components
+    /// with closest means on its both sides, with affilations computed in log
+    /// domain, so they do not underflow however far the point is.
+    /// </summary>
+    /// <param name="mz">M/z value of the data point.</param>
+    /// <param name="intensity">Intensity of the data point.</param>
+    /// <param name="statistics">Statistics, which shifts were already set.</param>
+    void AccumulateFromNeighbours(DataType mz, DataType intensity, SufficientStatistics &statistics) const
+    {
+        const unsigned numberOfComponents = (unsigned)m_SortedMeans.size();
+        const unsigned position = (unsigned)(std::upper_bound(m_SortedMeans.begin(), m_SortedMeans.end(), mz)
+                                             - m_SortedMeans.begin());
+        unsigned neighbours[2];
+        DataType logDensities[2];
+        unsigned numberOfNeighbours = 0;
+        if (position > 0)
+        {
+            neighbours[numberOfNeighbours++] = m_MeanOrder[position - 1];
+        }
+        if (position < numberOfComponents)
+        {
+            neighbours[numberOfNeighbours++] = m_MeanOrder[position];
+        }
+        DataType maximum = -std::numeric_limits<DataType>::infinity();
+        for (unsigned n = 0; n < numberOfNeighbours; n++)
+        {
+            const unsigned k = neighbours[n];
+            const DataType distance = (mz - m_KernelComponents.means[k]) * m_KernelComponents.inverseDeviations[k];
+            logDensities[n] = m_KernelComponents.logNormalizers[k] - 0.5 * distance * distance;
+            maximum = std::max(maximum, logDensities[n]);
+        }
+        DataType sum = 0.0;
+        for (unsigned n = 0; n < numberOfNeighbours; n++)
+        {
+            sum += exp(logDensities[n] - maximum);
+        }
+        const DataType logDensity = maximum + log(sum);
+        for (unsigned n = 0; n < numberOfNeighbours; n++)
+        {
+            statistics.Add(neighbours[n], exp(logDensities[n] - logDensity) * intensity, mz);
+        }
+        statistics.logLikelihood += logDensity + log(intensity);
+    }
+
+    DataType m_Cutoff;
+    std::vector<unsigned> m_WindowBegins;
+    std::vector<unsigned> m_WindowEnds;
+    std::vector<unsigned> m_MeanOrder;
+    std::vector<DataType> m_SortedMeans;
+};
+}
@@ -0,0 +1,246 @@
+/*
+ * SpecializedIterationRunner.h
+ * Provides fused iteration of Expectation Maximization algorithm
+ * specialized for scalar type of the densities and, optionally,
+ * for the number of components known at compile time.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <math.h>
+#include <type_traits>
+#include <vector>
+#include "Spectre.libException/ArgumentOutOfRangeException.h"
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianKernel.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/SufficientStatistics.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Number of components denoting, that it is known only at runtime.
+/// </summary>
+constexpr unsigned DYNAMIC_NUMBER_OF_COMPONENTS = 0;
+
+/// <summary>
+/// Greatest number of components, which may be fixed at compile time.
+/// </summary>
+constexpr unsigned MAX_STATIC_NUMBER_OF_COMPONENTS = 16;
+
+/// <summary>
+/// Counterpart of FusedIterationRunner evaluating densities in the given
+/// scalar type. Single precision evaluates twice as many densities per
+/// instruction, while moments, log likelihood and m/z values themselves are
+/// kept in double precision. Densities of each block are computed for m/z
+/// values relative to the first one in the block, so no precision is lost
+/// to the magnitude of m/z. Points, at which all the single precision
+/// densities underflow, are evaluated again in double precision.
+/// When the number of components is fixed at compile time, loops over
+/// the components have constant trip count and are unrolled by the compiler.
+/// </summary>
+/// <param name="Scalar">Type of the densities, either float or double.</param>
+/// <param name="NumberOfComponents">Number of components, or DYNAMIC_NUMBER_OF_COMPONENTS
+/// when known only at runtime.</param>
+template <typename Scalar = DataType, unsigned NumberOfComponents = DYNAMIC_NUMBER_OF_COMPONENTS>
+class SpecializedIterationRunner
+{
+    static_assert(std::is_same<Scalar, float>::value || std::is_same<Scalar, double>::value,
+                  "Scalar has to be either float or double.");
+    static_assert(NumberOfComponents <= MAX_STATIC_NUMBER_OF_COMPONENTS,
+                  "Number of components fixed at compile time may not exceed MAX_STATIC_NUMBER_OF_COMPONENTS.");
+
+public:
+    /// <summary>
+    /// Constructor initializing the class with data required during iterations.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="components">Gaussian components to be updated.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    /// <exception cref="ArgumentOutOfRangeException">Thrown when number of components differs
+    /// from the one fixed at compile time.</exception>
+    SpecializedIterationRunner(DataType *mzArray, DataType *intensities, unsigned size,
+                               std::vector<GaussianComponent> &components)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size),
+          m_Components(components), m_Statistics((unsigned)components.size())
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+
+        if (NumberOfComponents != DYNAMIC_NUMBER_OF_COMPONENTS && components.size() != NumberOfComponents)
+        {
+            throw spectre::core::exception::ArgumentOutOfRangeException<unsigned>(
+                "components", NumberOfComponents, NumberOfComponents, (unsigned)components.size());
+        }
+
+        m_TotalDataSize = 0.0;
+        for (unsigned i = 0; i < m_DataSize; i++)
+        {
+            m_TotalDataSize += m_pIntensities[i];
+        }
+    }
+
+    /// <summary>
+    /// Performs expectation and maximization steps in a single pass over the data
+    /// and updates the components.
+    /// </summary>
+    /// <returns>
+    /// Log likelihood of the data given components from before the update.
+    /// </returns>
+    DataType Iterate()
+    {
+        const unsigned numberOfComponents = Count();
+        m_Statistics.Reset(m_Components);
+        m_KernelComponents.Assign(m_Components);
+        m_InverseDeviations.resize(numberOfComponents);
+        m_LogNormalizers.resize(numberOfComponents);
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            m_InverseDeviations[k] = static_cast<Scalar>(m_KernelComponents.inverseDeviations[k]);
+            m_LogNormalizers[k] = static_cast<Scalar>(m_KernelComponents.logNormalizers[k]);
+        }
+        m_Densities.resize(numberOfComponents * KERNEL_BLOCK_SIZE);
+
+        for (unsigned blockBegin = 0; blockBegin < m_DataSize; blockBegin += KERNEL_BLOCK_SIZE)
+        {
+            const unsigned count = blockBegin + KERNEL_BLOCK_SIZE < m_DataSize ? KERNEL_BLOCK_SIZE
+                                                                              : m_DataSize - blockBegin;
+            AccumulateBlock(blockBegin, count);
+        }
+
+        m_Statistics.Maximize(m_TotalDataSize, m_Components);
+        return m_Statistics.logLikelihood;
+    }
+
+private:
+    unsigned Count() const
+    {
+        return NumberOfComponents != DYNAMIC_NUMBER_OF_COMPONENTS ? NumberOfComponents
+                                                                  : (unsigned)m_Components.size();
+    }
+
+    void AccumulateBlock(unsigned blockBegin, unsigned count)
+    {
+        const unsigned numberOfComponents = Count();
+        const DataType *mzs = m_pMzArray + blockBegin;
+        const DataType *intensities = m_pIntensities + blockBegin;
+        const DataType reference = mzs[0];
+        Scalar offsets[KERNEL_BLOCK_SIZE];
+        Scalar denominators[KERNEL_BLOCK_SIZE];
+        for (unsigned j = 0; j < count; j++)
+        {
+            offsets[j] = static_cast<Scalar>(mzs[j] - reference);
+            denominators[j] = 0;
+        }
+
+        Scalar *densities = m_Densities.data();
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            Scalar *componentDensities = densities + k * KERNEL_BLOCK_SIZE;
+            EvaluateGaussian(offsets, count, static_cast<Scalar>(m_KernelComponents.means[k] - reference),
+                             m_InverseDeviations[k], m_LogNormalizers[k], componentDensities);
+            for (unsigned j = 0; j < count; j++)
+            {
+                denominators[j] += componentDensities[j];
+            }
+        }
+
+        DataType intensitiesPerDensity[KERNEL_BLOCK_SIZE];
+        DataType logLikelihood = 0.0;
+        for (unsigned j = 0; j < count; j++)
+        {
+            const DataType denominator = denominators[j];
+            if (denominator > 0.0)
+            {
+                intensitiesPerDensity[j] = intensities[j] / denominator;
+                // points of zero intensity do not contribute to the likelihood
+                logLikelihood += intensities[j] > 0.0 ? log(denominator * intensities[j]) : 0.0;
+            }
+            else
+            {
+                intensitiesPerDensity[j] = 0.0;
+                AccumulatePrecisely(mzs[j], intensities[j]);
+            }
+        }
+        m_Statistics.logLikelihood += logLikelihood;
+
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            const Scalar *componentDensities = densities + k * KERNEL_BLOCK_SIZE;
+            const DataType shift = m_Statistics.shifts[k];
+            DataType responsibility = 0.0;
+            DataType firstMoment = 0.0;
+            DataType secondMoment = 0.0;
+            for (unsigned j = 0; j < count; j++)
+            {
+                const DataType weightedAffilation = componentDensities[j] * intensitiesPerDensity[j];
+                const DataType distance = mzs[j] - shift;
+                const DataType weightedDistance = weightedAffilation * distance;
+                responsibility += weightedAffilation;
+                firstMoment += weightedDistance;
+                secondMoment += weightedDistance * distance;
+            }
+            m_Statistics.responsibilities[k] += responsibility;
+            m_Statistics.firstMoments[k] += firstMoment;
+            m_Statistics.secondMoments[k] += secondMoment;
+        }
+    }
+
+    void AccumulatePrecisely(DataType mz, DataType intensity)
+    {
+        if (!(intensity > 0.0))
+        {
+            return;
+        }
+        const unsigned numberOfComponents = Count();
+        m_PointDensities.resize(numberOfComponents);
+        DataType *densities = m_PointDensities.data();
+        DataType denominator = 0.0;
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            EvaluateGaussian(&mz, 1, m_KernelComponents, k, densities + k);
+            denominator += densities[k];
+        }
+        const DataType intensityPerDensity = intensity / denominator;
+        for (unsigned k = 0; k < numberOfComponents; k++)
+        {
+            m_Statistics.Add(k, densities[k] * intensityPerDensity, mz);
+        }
+        m_Statistics.logLikelihood += log(denominator * intensity);
+    }
+
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    DataType m_TotalDataSize;
+    std::vector<GaussianComponent> &m_Components;
+    SufficientStatistics m_Statistics;
+    GaussianKernelComponents m_KernelComponents;
+    std::vector<Scalar> m_InverseDeviations;
+    std::vector<Scalar> m_LogNormalizers;
+    std::vector<Scalar> m_Densities;
+    std::vector<DataType> m_PointDensities;
+};
+}
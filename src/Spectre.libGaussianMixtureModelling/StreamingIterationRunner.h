@@ -0,0 +1,101 @@
+/*
+ * StreamingIterationRunner.h
+ * Provides parallel implementation of a whole iteration of EM algorithm
+ * used for Gaussian Mixture Modelling, which memory usage does not depend
+ * on the number of data points.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <thread>
+#include <vector>
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/FusedIterationRunner.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+#include "Spectre.libGaussianMixtureModelling/SufficientStatistics.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Class performs whole iterations of Expectation Maximization algorithm
+/// like FusedIterationRunner does, but with data split into a fixed number
+/// of contiguous chunks processed concurrently. Each chunk accumulates its
+/// own statistics, which are merged in order of chunks afterwards, so memory
+/// used is proportional to number of chunks times number of components.
+/// </summary>
+class StreamingIterationRunner : public FusedIterationRunner
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with data required during iterations.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="components">Gaussian components to be updated.</param>
+    /// <param name="numberOfChunks">Number of chunks data is split into. Defaults
+    /// to number of hardware threads.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    StreamingIterationRunner(DataType *mzArray, DataType *intensities, unsigned size,
+                             std::vector<GaussianComponent> &components, unsigned numberOfChunks = 0)
+        : FusedIterationRunner(mzArray, intensities, size, components)
+    {
+        if (numberOfChunks == 0)
+        {
+            numberOfChunks = std::thread::hardware_concurrency();
+        }
+        if (numberOfChunks == 0 || numberOfChunks > size)
+        {
+            numberOfChunks = size > 0 ? size : 1;
+        }
+        m_ChunkStatistics.resize(numberOfChunks);
+        m_ChunkDensities.resize(numberOfChunks);
+    }
+
+    /// <summary>
+    /// Performs expectation and maximization steps in a single, parallel pass
+    /// over the data and updates the components.
+    /// </summary>
+    /// <returns>
+    /// Log likelihood of the data given components from before the update.
+    /// </returns>
+    DataType Iterate() override
+    {
+        const int numberOfChunks = static_cast<int>(m_ChunkStatistics.size());
+        PrepareIteration(m_Statistics);
+
+        #pragma omp parallel for schedule(static)
+        for (int chunk = 0; chunk < numberOfChunks; chunk++)
+        {
+            const unsigned begin = static_cast<unsigned>((unsigned long long)m_DataSize * chunk / numberOfChunks);
+            const unsigned end = static_cast<unsigned>((unsigned long long)m_DataSize * (chunk + 1) / numberOfChunks);
+            m_ChunkStatistics[chunk].Reset(m_Components);
+            m_ChunkDensities[chunk].resize(m_Components.size() * KERNEL_BLOCK_SIZE);
+            Accumulate(begin, end, m_ChunkStatistics[chunk], m_ChunkDensities[chunk].data());
+        }
+
+        for (int chunk = 0; chunk < numberOfChunks; chunk++)
+        {
+            m_Statistics.Merge(m_ChunkStatistics[chunk]);
+        }
+        m_Statistics.Maximize(m_TotalDataSize, m_Components);
+        return m_Statistics.logLikelihood;
+    }
+
+private:
+    std::vector<SufficientStatistics> m_ChunkStatistics;
+    std::vector<std::vector<DataType>> m_ChunkDensities;
+};
+}
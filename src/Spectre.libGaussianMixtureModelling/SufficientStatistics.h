@@ -0,0 +1,139 @@
+/*
+ * SufficientStatistics.h
+ * Provides per-component sufficient statistics of Gaussian Mixture Model,
+ * which are sufficient to perform maximization step of EM algorithm
+ * without storing the affilation matrix.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <math.h>
+#include <vector>
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Intensity weighted moments of affilation (gamma) of data points to each
+/// of the components. Moments are taken around shifts - the means of the components
+/// at the moment of accumulation - as otherwise the variance computed from raw
+/// moments would suffer from cancellation for m/z values far from zero.
+/// </summary>
+struct SufficientStatistics
+{
+    /// <summary>
+    /// Constructor initializing zeroed statistics for given number of components.
+    /// </summary>
+    /// <param name="numberOfComponents">Number of Gaussian components.</param>
+    explicit SufficientStatistics(unsigned numberOfComponents = 0)
+        : shifts(numberOfComponents, 0.0), responsibilities(numberOfComponents, 0.0),
+          firstMoments(numberOfComponents, 0.0), secondMoments(numberOfComponents, 0.0),
+          logLikelihood(0.0)
+    { }
+
+    /// <summary>
+    /// Zeroes all the accumulators and sets shifts to the means of given components.
+    /// </summary>
+    /// <param name="components">Components, around which the moments will be accumulated.</param>
+    void Reset(const std::vector<GaussianComponent> &components)
+    {
+        const size_t numberOfComponents = components.size();
+        shifts.resize(numberOfComponents);
+        responsibilities.assign(numberOfComponents, 0.0);
+        firstMoments.assign(numberOfComponents, 0.0);
+        secondMoments.assign(numberOfComponents, 0.0);
+        logLikelihood = 0.0;
+        for (size_t k = 0; k < numberOfComponents; k++)
+        {
+            shifts[k] = components[k].mean;
+        }
+    }
+
+    /// <summary>
+    /// Accumulates contribution of a single data point to the k-th component.
+    /// </summary>
+    /// <param name="k">Index of the component.</param>
+    /// <param name="weightedAffilation">Affilation of the point multiplied by its intensity.</param>
+    /// <param name="mz">M/z value of the point.</param>
+    void Add(size_t k, DataType weightedAffilation, DataType mz)
+    {
+        const DataType distance = mz - shifts[k];
+        const DataType weightedDistance = weightedAffilation * distance;
+        responsibilities[k] += weightedAffilation;
+        firstMoments[k] += weightedDistance;
+        secondMoments[k] += weightedDistance * distance;
+    }
+
+    /// <summary>
+    /// Adds statistics accumulated over another, disjoint subset of data points.
+    /// Both instances are required to share the shifts.
+    /// </summary>
+    /// <param name="other">Statistics to merge into this instance.</param>
+    void Merge(const SufficientStatistics &other)
+    {
+        for (size_t k = 0; k < responsibilities.size(); k++)
+        {
+            responsibilities[k] += other.responsibilities[k];
+            firstMoments[k] += other.firstMoments[k];
+            secondMoments[k] += other.secondMoments[k];
+        }
+        logLikelihood += other.logLikelihood;
+    }
+
+    /// <summary>
+    /// Updates weights, means and standard deviations of the components,
+    /// as maximization step of EM algorithm does.
+    /// </summary>
+    /// <param name="totalDataSize">Sum of intensities of all data points.</param>
+    /// <param name="components">Components to be updated.</param>
+    void Maximize(DataType totalDataSize, std::vector<GaussianComponent> &components) const
+    {
+        for (size_t k = 0; k < components.size(); k++)
+        {
+            const DataType meanDistance = firstMoments[k] / responsibilities[k];
+            const DataType variance = secondMoments[k] / responsibilities[k] - meanDistance * meanDistance;
+            components[k].weight = responsibilities[k] / totalDataSize;
+            components[k].mean = shifts[k] + meanDistance;
+            components[k].deviation = sqrt(variance > 0.0 ? variance : 0.0);
+        }
+    }
+
+    /// <summary>
+    /// Points around which the moments are accumulated.
+    /// </summary>
+    std::vector<DataType> shifts;
+
+    /// <summary>
+    /// Sums of affilations multiplied by intensities.
+    /// </summary>
+    std::vector<DataType> responsibilities;
+
+    /// <summary>
+    /// Sums of affilations multiplied by intensities and distances from the shifts.
+    /// </summary>
+    std::vector<DataType> firstMoments;
+
+    /// <summary>
+    /// Sums of affilations multiplied by intensities and squared distances from the shifts.
+    /// </summary>
+    std::vector<DataType> secondMoments;
+
+    /// <summary>
+    /// Log likelihood of the data given components used during accumulation.
+    /// </summary>
+    DataType logLikelihood;
+};
+}
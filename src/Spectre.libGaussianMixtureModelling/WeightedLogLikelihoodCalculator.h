@@ -0,0 +1,112 @@
+/*
+ * WeightedLogLikelihoodCalculator.h
+ * Provides calculation of intensity weighted log likelihood of Gaussian
+ * Mixture Model, suitable for comparison of models with information criteria.
+ *
+ * Spectrum is treated as a sample, in which each m/z value occurs
+ * proportionally to its intensity, i.e. the log likelihood equals
+ * sum_i(c_i * log(sum_k(w_k * N(x_i | mu_k, sigma_k)))), with the counts
+ * c_i proportional to intensities and summing up to the number of points.
+ * Unlike the log likelihood monitored by Expectation Maximization, it does
+ * not grow with components covering m/z ranges of negligible intensity.
+ *
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "Spectre.libException/NullPointerException.h"
+#include "Spectre.libGaussianMixtureModelling/BlockwiseReduction.h"
+#include "Spectre.libGaussianMixtureModelling/DataType.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianKernel.h"
+#include "Spectre.libGaussianMixtureModelling/GaussianMixtureModel.h"
+
+namespace spectre::unsupervised::gmm
+{
+/// <summary>
+/// Class serves the purpose of calculation of intensity weighted log likelihood
+/// of the gaussian mixture model. Negative intensities are treated as zero.
+/// </summary>
+class WeightedLogLikelihoodCalculator
+{
+public:
+    /// <summary>
+    /// Constructor initializing the class with data required for calculation of
+    /// log likelihood.
+    /// </summary>
+    /// <param name="mzArray">Array of m/z values.</param>
+    /// <param name="intensities">Set of corresponding mean intensities values.</param>
+    /// <param name="size">Size of the mzArray and itensities arrays.</param>
+    /// <param name="components">Gaussian components.</param>
+    /// <exception cref="NullPointerException">Thrown when either of mzArray or intensities pointers are null</exception>
+    WeightedLogLikelihoodCalculator(DataType *mzArray, DataType *intensities,
+                                    unsigned size, const std::vector<GaussianComponent> &components)
+        : m_pMzArray(mzArray), m_pIntensities(intensities), m_DataSize(size),
+          m_Components(components)
+    {
+        if (mzArray == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("mzArray");
+        }
+
+        if (intensities == nullptr)
+        {
+            throw spectre::core::exception::NullPointerException("intensities");
+        }
+    }
+
+    /// <summary>
+    /// Calculates the log likelihood of the data given current components.
+    /// </summary>
+    /// <returns>
+    /// Value of log likelihood.
+    /// </returns>
+    DataType CalculateLikelihood()
+    {
+        const unsigned numberOfComponents = (unsigned)m_Components.size();
+        m_KernelComponents.Assign(m_Components);
+        m_Scratch.Reserve(numberOfComponents * KERNEL_BLOCK_SIZE);
+
+        const std::vector<DataType> totals = ReduceBlockwise(m_DataSize, 2,
+            [this](unsigned begin, unsigned end, DataType *sums)
+            {
+                DataType *affilations = m_Scratch.Get();
+                DataType logMixtureDensities[KERNEL_BLOCK_SIZE];
+                for (unsigned blockBegin = begin; blockBegin < end; blockBegin += KERNEL_BLOCK_SIZE)
+                {
+                    const unsigned count = blockBegin + KERNEL_BLOCK_SIZE < end ? KERNEL_BLOCK_SIZE : end - blockBegin;
+                    EvaluateLogMixture(m_pMzArray + blockBegin, count, m_KernelComponents,
+                                       affilations, logMixtureDensities);
+                    for (unsigned j = 0; j < count; j++)
+                    {
+                        const DataType intensity = std::max(m_pIntensities[blockBegin + j], 0.0);
+                        // points of zero intensity do not contribute, even when density underflows
+                        sums[0] += intensity > 0.0 ? intensity * logMixtureDensities[j] : 0.0;
+                        sums[1] += intensity;
+                    }
+                }
+            });
+        return totals[1] > 0.0 ? m_DataSize * totals[0] / totals[1] : 0.0;
+    }
+
+private:
+    DataType *m_pMzArray;
+    DataType *m_pIntensities;
+    unsigned m_DataSize;
+    const std::vector<GaussianComponent> &m_Components;
+    GaussianKernelComponents m_KernelComponents;
+    ThreadScratch m_Scratch;
+};
+}
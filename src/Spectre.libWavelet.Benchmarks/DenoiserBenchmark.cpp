@@ -0,0 +1,119 @@
+/*
+* DenoiserBenchmark.cpp
+* Measures throughput of wavelet denoising of single spectra and of
+* whole datasets processed in parallel. Throughput is reported as
+* spectra per second (items per second). Run with --benchmark_out=<file>
+* --benchmark_out_format=json to keep the results for comparison.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+#include <random>
+#include <benchmark/benchmark.h>
+#include "DaubechiesFiltersDenoiser.h"
+#include "DenoiserWorkspace.h"
+
+namespace
+{
+using namespace spectre::algorithm::wavelet;
+
+// Spectra of given length, stored row after row. Each one is a few peaks
+// over a baseline with additive Gaussian noise, always the same for given sizes.
+Signal Spectra(size_t signalLength, size_t numberOfSignals)
+{
+    Signal spectra(signalLength * numberOfSignals);
+    std::mt19937_64 rngEngine(0);
+    std::normal_distribution<DataType> noise(0.0, 0.5);
+    for (size_t s = 0; s < numberOfSignals; s++)
+    {
+        for (size_t i = 0; i < signalLength; i++)
+        {
+            DataType value = 1.0;
+            for (size_t peak = 1; peak < 8; peak++)
+            {
+                const DataType distance = (i - (peak * signalLength) / 8.0) / (signalLength / 200.0);
+                value += 10.0 * std::exp(-distance * distance);
+            }
+            spectra[s * signalLength + i] = value + noise(rngEngine);
+        }
+    }
+    return spectra;
+}
+
+void BM_Denoise(benchmark::State &state)
+{
+    const auto signalLength = (size_t)state.range(0);
+    const Signal spectrum = Spectra(signalLength, 1);
+    DaubechiesFiltersDenoiser denoiser;
+    while (state.KeepRunning())
+    {
+        Signal signal = spectrum;
+        benchmark::DoNotOptimize(denoiser.Denoise(signal));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_DenoiseWithWorkspace(benchmark::State &state)
+{
+    const auto signalLength = (size_t)state.range(0);
+    const Signal spectrum = Spectra(signalLength, 1);
+    Signal denoised(signalLength);
+    DaubechiesFiltersDenoiser denoiser;
+    DenoiserWorkspace workspace(signalLength);
+    while (state.KeepRunning())
+    {
+        denoiser.Denoise(gsl::as_span(spectrum), gsl::as_span(denoised), workspace);
+        benchmark::DoNotOptimize(denoised.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Arguments are length of spectra, their number and number of threads.
+void BM_DenoiseBatch(benchmark::State &state)
+{
+    const auto signalLength = (size_t)state.range(0);
+    const auto numberOfSignals = (size_t)state.range(1);
+    const auto numberOfThreads = (unsigned)state.range(2);
+    const Signal spectra = Spectra(signalLength, numberOfSignals);
+    Signal denoised(spectra.size());
+    DaubechiesFiltersDenoiser denoiser;
+    while (state.KeepRunning())
+    {
+        denoiser.DenoiseBatch(gsl::as_span(spectra), gsl::as_span(denoised), signalLength, numberOfThreads);
+        benchmark::DoNotOptimize(denoised.data());
+    }
+    state.SetItemsProcessed(state.iterations() * numberOfSignals);
+}
+
+void SignalLengths(benchmark::internal::Benchmark *benchmark)
+{
+    benchmark->Arg(1 << 14)->Arg(100000)->Arg(1000000);
+}
+
+// Scaling with the cores is seen in wall time, hence real time is measured.
+void BatchSizes(benchmark::internal::Benchmark *benchmark)
+{
+    for (int threads : { 1, 2, 4, 8, 16 })
+    {
+        benchmark->Args({ 1 << 14, 64, threads });
+    }
+    benchmark->UseRealTime();
+}
+}
+
+BENCHMARK(BM_Denoise)->Apply(SignalLengths)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DenoiseWithWorkspace)->Apply(SignalLengths)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DenoiseBatch)->Apply(BatchSizes)->Unit(benchmark::kMillisecond);
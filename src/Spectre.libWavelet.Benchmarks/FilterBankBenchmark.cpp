@@ -0,0 +1,93 @@
+/*
+* FilterBankBenchmark.cpp
+* Compares filtering of the signal by the filter bank and by separate
+* convolutions.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <random>
+#include <benchmark/benchmark.h>
+#include "Convolution.h"
+#include "FilterBank.h"
+#include "PrecomputedDaubechiesCoefficients.h"
+
+namespace
+{
+using namespace spectre::algorithm::wavelet;
+using namespace spectre::algorithm::wavelet::precomputed;
+
+Signal Noise(size_t signalLength)
+{
+    Signal signal(signalLength);
+    std::mt19937_64 rngEngine(0);
+    std::normal_distribution<DataType> noise(0.0, 1.0);
+    for (DataType &sample : signal)
+    {
+        sample = noise(rngEngine);
+    }
+    return signal;
+}
+
+void BM_SplitWithConvolution(benchmark::State &state)
+{
+    const Signal signal = Noise((size_t)state.range(0));
+    Signal lowPassed(signal.size());
+    Signal highPassed(signal.size());
+    Convolution convolution;
+    while (state.KeepRunning())
+    {
+        convolution.Convolve(DecompositionLowPassFilter, gsl::as_span(signal), gsl::as_span(lowPassed));
+        convolution.Convolve(DecompositionHighPassFilter, gsl::as_span(signal), gsl::as_span(highPassed));
+        benchmark::DoNotOptimize(lowPassed.data());
+        benchmark::DoNotOptimize(highPassed.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_SplitWithFilterBank(benchmark::State &state)
+{
+    const Signal signal = Noise((size_t)state.range(0));
+    Signal lowPassed(signal.size());
+    Signal highPassed(signal.size());
+    DaubechiesFilterBank filters(DecompositionLowPassFilter, DecompositionHighPassFilter);
+    while (state.KeepRunning())
+    {
+        filters.Split(gsl::as_span(signal), gsl::as_span(lowPassed), gsl::as_span(highPassed));
+        benchmark::DoNotOptimize(lowPassed.data());
+        benchmark::DoNotOptimize(highPassed.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_MergeWithFilterBank(benchmark::State &state)
+{
+    const Signal lowFrequency = Noise((size_t)state.range(0));
+    const Signal highFrequency = Noise((size_t)state.range(0));
+    Signal merged(lowFrequency.size());
+    DaubechiesFilterBank filters(ReconstructionLowPassFilter, ReconstructionHighPassFilter, 0.5);
+    while (state.KeepRunning())
+    {
+        filters.Merge(gsl::as_span(lowFrequency), gsl::as_span(highFrequency), gsl::as_span(merged));
+        benchmark::DoNotOptimize(merged.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}
+
+// Short blocks are typical of the deepest levels of the decomposition.
+BENCHMARK(BM_SplitWithConvolution)->Arg(64)->Arg(1 << 14)->Arg(1000000);
+BENCHMARK(BM_SplitWithFilterBank)->Arg(64)->Arg(1 << 14)->Arg(1000000);
+BENCHMARK(BM_MergeWithFilterBank)->Arg(64)->Arg(1 << 14)->Arg(1000000);
@@ -0,0 +1,148 @@
+/*
+* DenoiserWorkspaceAllocationTest.cpp
+* Tests that wavelet denoising with sufficient workspace does not allocate.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <gtest/gtest.h>
+#include "Spectre.libWavelet\DaubechiesFiltersDenoiser.h"
+#include "Spectre.libWavelet\DenoiserWorkspace.h"
+
+// Allocations of the whole test binary are counted, so that they can be checked
+// around a call. That is why this test is built separately from the rest of
+// the library tests.
+namespace
+{
+    std::atomic<size_t> numberOfAllocations(0);
+
+    void* TryCountedAllocate(size_t size) noexcept
+    {
+        numberOfAllocations++;
+        return std::malloc(size != 0 ? size : 1);
+    }
+
+    void* CountedAllocate(size_t size)
+    {
+        if (void* memory = TryCountedAllocate(size))
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+#ifdef __cpp_aligned_new
+    // Over-aligned blocks are preceded by address of the underlying block.
+    void* TryCountedAllocateAligned(size_t size, std::align_val_t alignment) noexcept
+    {
+        numberOfAllocations++;
+        const size_t align = std::max(static_cast<size_t>(alignment), alignof(std::max_align_t));
+        char* block = static_cast<char*>(std::malloc(size + align + sizeof(void*)));
+        if (block == nullptr)
+        {
+            return nullptr;
+        }
+        const uintptr_t first = reinterpret_cast<uintptr_t>(block) + sizeof(void*);
+        char* aligned = reinterpret_cast<char*>((first + align - 1) / align * align);
+        reinterpret_cast<char**>(aligned)[-1] = block;
+        return aligned;
+    }
+
+    void* CountedAllocateAligned(size_t size, std::align_val_t alignment)
+    {
+        if (void* memory = TryCountedAllocateAligned(size, alignment))
+        {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+
+    void DeallocateAligned(void* memory) noexcept
+    {
+        if (memory != nullptr)
+        {
+            std::free(reinterpret_cast<char**>(memory)[-1]);
+        }
+    }
+#endif
+}
+
+void* operator new(size_t size) { return CountedAllocate(size); }
+void* operator new[](size_t size) { return CountedAllocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return TryCountedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return TryCountedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+#ifdef __cpp_aligned_new
+void* operator new(size_t size, std::align_val_t alignment) { return CountedAllocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return CountedAllocateAligned(size, alignment); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return TryCountedAllocateAligned(size, alignment);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return TryCountedAllocateAligned(size, alignment);
+}
+void operator delete(void* memory, std::align_val_t) noexcept { DeallocateAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { DeallocateAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { DeallocateAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { DeallocateAligned(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { DeallocateAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { DeallocateAligned(memory); }
+#endif
+
+namespace
+{
+    using namespace spectre::algorithm::wavelet;
+
+    Signal NoisySignal(size_t length, double phase)
+    {
+        Signal signal(length);
+        for (size_t i = 0; i < length; i++)
+        {
+            const double peak = (i - length / 3.0) / (length / 50.0);
+            signal[i] = 10.0 * std::exp(-peak * peak) + std::sin(0.9 * i + phase);
+        }
+        return signal;
+    }
+
+    TEST(DenoiserWorkspaceAllocationTest, does_not_allocate_with_sufficient_workspace)
+    {
+        DaubechiesFiltersDenoiser denoiser;
+        Signal signal = NoisySignal(5000, 0.0);
+        Signal shorterSignal = NoisySignal(4000, 1.0);
+        Signal denoised(signal.size());
+        DenoiserWorkspace workspace(signal.size());
+
+        const size_t allocationsBefore = numberOfAllocations;
+        denoiser.Denoise(gsl::as_span(signal), gsl::as_span(denoised), workspace);
+        denoiser.Denoise(gsl::as_span(shorterSignal), gsl::as_span(denoised).first(4000), workspace);
+        const size_t allocationsAfter = numberOfAllocations;
+
+        EXPECT_EQ(allocationsBefore, allocationsAfter);
+    }
+}
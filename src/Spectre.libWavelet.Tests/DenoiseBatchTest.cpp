@@ -0,0 +1,102 @@
+/*
+* DenoiseBatchTest.cpp
+* Tests parallel wavelet denoising of many signals at once.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include "Spectre.libDataset\Dataset.h"
+#include "Spectre.libException\InconsistentArgumentSizesException.h"
+#include "Spectre.libWavelet\DaubechiesFiltersDenoiser.h"
+
+namespace
+{
+    using namespace spectre::algorithm::wavelet;
+    using SignalDataset = spectre::core::dataset::Dataset<Signal, int, int>;
+
+    class DenoiseBatchTest : public ::testing::Test
+    {
+    public:
+        DenoiseBatchTest()
+        {
+            signals.resize(numberOfSignals);
+            for (unsigned s = 0; s < numberOfSignals; s++)
+            {
+                signals[s].resize(signalLength);
+                for (unsigned i = 0; i < signalLength; i++)
+                {
+                    const double peak = (i - 10.0 * (s + 1)) / 5.0;
+                    signals[s][i] = 10.0 * std::exp(-peak * peak) + std::sin(0.7 * i * (s + 1));
+                }
+                matrix.insert(matrix.end(), signals[s].begin(), signals[s].end());
+                Signal copy = signals[s];
+                Signal denoised = denoiser.Denoise(copy);
+                expected.insert(expected.end(), denoised.begin(), denoised.end());
+            }
+        }
+    protected:
+        static constexpr unsigned numberOfSignals = 13;
+        static constexpr unsigned signalLength = 300;
+        DaubechiesFiltersDenoiser denoiser;
+        std::vector<Signal> signals;
+        Signal matrix;
+        Signal expected;
+    };
+
+    TEST_F(DenoiseBatchTest, denoises_matrix_like_single_signals)
+    {
+        Signal denoised(matrix.size());
+
+        denoiser.DenoiseBatch(gsl::as_span(matrix), gsl::as_span(denoised), signalLength, 4);
+
+        EXPECT_EQ(expected, denoised);
+    }
+
+    TEST_F(DenoiseBatchTest, denoises_matrix_in_place)
+    {
+        denoiser.DenoiseBatch(gsl::as_span(matrix), gsl::as_span(matrix), signalLength);
+
+        EXPECT_EQ(expected, matrix);
+    }
+
+    TEST_F(DenoiseBatchTest, denoises_dataset_like_single_signals)
+    {
+        std::vector<int> metadata(numberOfSignals);
+        SignalDataset dataset(signals, metadata, 0);
+        Signal denoised(matrix.size());
+
+        denoiser.DenoiseBatch(dataset, gsl::as_span(denoised), 3);
+
+        EXPECT_EQ(expected, denoised);
+    }
+
+    TEST_F(DenoiseBatchTest, throws_on_inconsistent_sizes)
+    {
+        using spectre::core::exception::InconsistentArgumentSizesException;
+        std::vector<int> metadata(numberOfSignals);
+        Signal tooShort(matrix.size() - 1);
+        EXPECT_THROW(denoiser.DenoiseBatch(gsl::as_span(matrix), gsl::as_span(tooShort), signalLength),
+            InconsistentArgumentSizesException);
+        EXPECT_THROW(denoiser.DenoiseBatch(gsl::as_span(matrix), gsl::as_span(matrix), signalLength + 1),
+            InconsistentArgumentSizesException);
+        EXPECT_THROW(denoiser.DenoiseBatch(SignalDataset(signals, metadata, 0),
+            gsl::as_span(tooShort)), InconsistentArgumentSizesException);
+        signals.back().pop_back();
+        EXPECT_THROW(denoiser.DenoiseBatch(SignalDataset(signals, metadata, 0),
+            gsl::as_span(matrix)), InconsistentArgumentSizesException);
+    }
+}
@@ -0,0 +1,100 @@
+/*
+* DenoiserWorkspaceTest.cpp
+* Tests wavelet denoising with storage reused between the runs.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include "Spectre.libException\InconsistentArgumentSizesException.h"
+#include "Spectre.libWavelet\DaubechiesFiltersDenoiser.h"
+#include "Spectre.libWavelet\DenoiserWorkspace.h"
+
+namespace
+{
+    using namespace spectre::algorithm::wavelet;
+
+    Signal NoisySignal(size_t length, double phase)
+    {
+        Signal signal(length);
+        for (size_t i = 0; i < length; i++)
+        {
+            const double peak = (i - length / 3.0) / (length / 50.0);
+            signal[i] = 10.0 * std::exp(-peak * peak) + std::sin(0.9 * i + phase);
+        }
+        return signal;
+    }
+
+    TEST(DenoiserWorkspaceInitialization, initializes)
+    {
+        EXPECT_NO_THROW(DenoiserWorkspace());
+        EXPECT_NO_THROW(DenoiserWorkspace(1000));
+    }
+
+    TEST(DenoiserWorkspaceInitialization, reserves_storage_only_when_growing)
+    {
+        DenoiserWorkspace workspace(1000);
+        EXPECT_EQ(workspace.Capacity(), 1000u);
+        workspace.Reserve(500);
+        EXPECT_EQ(workspace.Capacity(), 1000u);
+        workspace.Reserve(2000);
+        EXPECT_EQ(workspace.Capacity(), 2000u);
+    }
+
+    class DenoiserWorkspaceTest : public ::testing::Test
+    {
+    protected:
+        DaubechiesFiltersDenoiser denoiser;
+    };
+
+    TEST_F(DenoiserWorkspaceTest, reused_workspace_yields_the_same_result)
+    {
+        Signal longSignal = NoisySignal(3000, 0.0);
+        Signal shortSignal = NoisySignal(1111, 1.0);
+        const Signal expectedLong = denoiser.Denoise(longSignal);
+        const Signal expectedShort = denoiser.Denoise(shortSignal);
+        DenoiserWorkspace workspace;
+        Signal denoisedLong(longSignal.size());
+        Signal denoisedShort(shortSignal.size());
+
+        denoiser.Denoise(gsl::as_span(longSignal), gsl::as_span(denoisedLong), workspace);
+        denoiser.Denoise(gsl::as_span(shortSignal), gsl::as_span(denoisedShort), workspace);
+
+        EXPECT_EQ(expectedLong, denoisedLong);
+        EXPECT_EQ(expectedShort, denoisedShort);
+    }
+
+    TEST_F(DenoiserWorkspaceTest, denoises_in_place)
+    {
+        Signal signal = NoisySignal(2000, 0.0);
+        const Signal expected = denoiser.Denoise(signal);
+        DenoiserWorkspace workspace(signal.size());
+
+        denoiser.Denoise(gsl::as_span(signal), gsl::as_span(signal), workspace);
+
+        EXPECT_EQ(expected, signal);
+    }
+
+    TEST_F(DenoiserWorkspaceTest, throws_on_inconsistent_sizes)
+    {
+        Signal signal = NoisySignal(100, 0.0);
+        Signal denoised(99);
+        DenoiserWorkspace workspace;
+
+        EXPECT_THROW(denoiser.Denoise(gsl::as_span(signal), gsl::as_span(denoised), workspace),
+            spectre::core::exception::InconsistentArgumentSizesException);
+    }
+}
@@ -0,0 +1,175 @@
+/*
+* FilterBankTest.cpp
+* Tests whether the filter bank filters the signal the same way,
+* as the convolution does.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <random>
+#include <gtest/gtest.h>
+#include "Spectre.libWavelet\Convolution.h"
+#include "Spectre.libWavelet\FilterBank.h"
+#include "Spectre.libWavelet\PrecomputedDaubechiesCoefficients.h"
+#include "FloatingPointVectorMatcher.h"
+
+namespace
+{
+    using namespace spectre::algorithm::wavelet;
+    using namespace spectre::algorithm::wavelet::precomputed;
+
+    class FilterBankTest : public ::testing::Test
+    {
+    protected:
+        Signal RandomSignal(size_t length, unsigned seed) const
+        {
+            std::mt19937 rngEngine(seed);
+            std::uniform_real_distribution<DataType> distribution(-100.0, 100.0);
+            Signal signal(length);
+            for (DataType& sample : signal)
+            {
+                sample = distribution(rngEngine);
+            }
+            return signal;
+        }
+
+        Signal Convolve(const Kernel& kernel, const Signal& signal, DataType gain = 1.0) const
+        {
+            Signal convolved = convolution.Convolve(kernel, signal);
+            for (DataType& sample : convolved)
+            {
+                sample *= gain;
+            }
+            return convolved;
+        }
+
+        Convolution convolution;
+        const std::vector<size_t> lengths = { 0, 1, 5, 7, 8, 11, 16, 37, 1000 };
+    };
+
+    TEST_F(FilterBankTest, splits_the_signal_like_convolution)
+    {
+        DaubechiesFilterBank filters(DecompositionLowPassFilter, DecompositionHighPassFilter);
+        for (size_t length : lengths)
+        {
+            Signal signal = RandomSignal(length, 0);
+            Signal lowPassed(length);
+            Signal highPassed(length);
+
+            filters.Split(gsl::as_span(signal), gsl::as_span(lowPassed), gsl::as_span(highPassed));
+
+            auto doubleNear = double_near(1e-12);
+            EXPECT_THAT(lowPassed, testing::Pointwise(doubleNear,
+                Convolve(DecompositionLowPassFilter, signal))) << "length " << length;
+            EXPECT_THAT(highPassed, testing::Pointwise(doubleNear,
+                Convolve(DecompositionHighPassFilter, signal))) << "length " << length;
+        }
+    }
+
+    TEST_F(FilterBankTest, merges_the_signals_like_averaged_convolutions)
+    {
+        DaubechiesFilterBank filters(ReconstructionLowPassFilter, ReconstructionHighPassFilter, 0.5);
+        for (size_t length : lengths)
+        {
+            Signal lowFrequency = RandomSignal(length, 1);
+            Signal highFrequency = RandomSignal(length, 2);
+            Signal merged(length);
+
+            filters.Merge(gsl::as_span(lowFrequency), gsl::as_span(highFrequency), gsl::as_span(merged));
+
+            Signal expected = Convolve(ReconstructionLowPassFilter, lowFrequency, 0.5);
+            Signal highPassed = Convolve(ReconstructionHighPassFilter, highFrequency, 0.5);
+            for (size_t i = 0; i < length; i++)
+            {
+                expected[i] += highPassed[i];
+            }
+            EXPECT_THAT(merged, testing::Pointwise(double_near(1e-12), expected)) << "length " << length;
+        }
+    }
+
+    TEST_F(FilterBankTest, filters_only_as_many_samples_as_fit_into_the_output)
+    {
+        DaubechiesFilterBank filters(DecompositionLowPassFilter, DecompositionHighPassFilter);
+        Signal signal = RandomSignal(40, 3);
+        Signal lowPassed(40, -1.0);
+        Signal highPassed(40, -1.0);
+
+        filters.Split(gsl::as_span(signal), gsl::as_span(lowPassed.data(), 21),
+            gsl::as_span(highPassed.data(), 21));
+
+        Signal expected = Convolve(DecompositionLowPassFilter, signal);
+        for (size_t i = 0; i < 21; i++)
+        {
+            EXPECT_NEAR(expected[i], lowPassed[i], 1e-12);
+        }
+        for (size_t i = 21; i < 40; i++)
+        {
+            EXPECT_EQ(-1.0, lowPassed[i]);
+            EXPECT_EQ(-1.0, highPassed[i]);
+        }
+    }
+
+    class FilterBankKernelTest : public FilterBankTest
+    {
+    protected:
+        typedef void (*SplitKernel)(const DataType*, const DataType*, const DataType*, size_t, size_t,
+            DataType*, DataType*);
+        typedef void (*MergeKernel)(const DataType*, const DataType*, const DataType*, const DataType*, size_t,
+            size_t, DataType*);
+
+        void ExpectSplitLikeScalar(SplitKernel split) const
+        {
+            Signal signal = RandomSignal(103, 4);
+            Signal low(signal.size(), 0.0);
+            Signal high(signal.size(), 0.0);
+            Signal expectedLow(signal.size(), 0.0);
+            Signal expectedHigh(signal.size(), 0.0);
+            // odd bounds exercise remainders of the vectorized loops
+            split(DecompositionLowPassFilter.data(), DecompositionHighPassFilter.data(), signal.data(), 9, 102,
+                low.data(), high.data());
+            SplitInterior<9>(Padded(DecompositionLowPassFilter).data(), Padded(DecompositionHighPassFilter).data(),
+                signal.data(), 9, 102, expectedLow.data(), expectedHigh.data());
+            EXPECT_THAT(low, testing::Pointwise(double_near(1e-12), expectedLow));
+            EXPECT_THAT(high, testing::Pointwise(double_near(1e-12), expectedHigh));
+        }
+
+        void ExpectMergeLikeScalar(MergeKernel merge) const
+        {
+            Signal lowFrequency = RandomSignal(103, 5);
+            Signal highFrequency = RandomSignal(103, 6);
+            Signal merged(lowFrequency.size(), 0.0);
+            Signal expected(lowFrequency.size(), 0.0);
+            merge(ReconstructionLowPassFilter.data(), ReconstructionHighPassFilter.data(), lowFrequency.data(),
+                highFrequency.data(), 9, 102, merged.data());
+            MergeInterior<9>(Padded(ReconstructionLowPassFilter).data(), Padded(ReconstructionHighPassFilter).data(),
+                lowFrequency.data(), highFrequency.data(), 9, 102, expected.data());
+            EXPECT_THAT(merged, testing::Pointwise(double_near(1e-12), expected));
+        }
+
+        // Generic scalar code is used as reference, with filter extended by a zero tap.
+        static std::array<DataType, 9> Padded(const Kernel& filter)
+        {
+            std::array<DataType, 9> result = {};
+            std::copy(filter.begin(), filter.end(), result.begin());
+            return result;
+        }
+    };
+
+    TEST_F(FilterBankKernelTest, dispatched_kernels_match_scalar_code)
+    {
+        ExpectSplitLikeScalar(SplitInterior<8>);
+        ExpectMergeLikeScalar(MergeInterior<8>);
+    }
+}
@@ -129,6 +129,12 @@ namespace
             };
         }
     protected:
+        static Signal List(const WaveletCoefficients& coefficients, unsigned level, size_t index)
+        {
+            gsl::span<const DataType> list = coefficients.List(level, index);
+            return Signal(list.begin(), list.end());
+        }
+
         WaveletDecomposerRef decomposer;
         std::vector<DataType> lastRowLastHighFrequencyResult;
         std::vector<DataType> firstRowLastHighFrequencyResult;
@@ -147,8 +153,8 @@ namespace
 
         // Extract coefficients necessary for noise estimator
         Signal highFreqCoefficients(signalLength);
-        highFreqCoefficients.assign(coefficients.data[0][0].begin(),
-            coefficients.data[0][0].begin() + signalLength);
+        Signal firstList = List(coefficients, 0, 0);
+        highFreqCoefficients.assign(firstList.begin(), firstList.begin() + signalLength);
 
         // Estimate tresholder's treshold value based on extracted coefficients
         MedianAbsoluteDeviationNoiseEstimator noiseEstimator;
@@ -161,15 +167,15 @@ namespace
 
         // Check if the coefficients have appropriate values
         auto doubleNear = double_near(0.001);
-        EXPECT_THAT(coefficients.data[0][0],
+        EXPECT_THAT(List(coefficients, 0, 0),
             testing::Pointwise(doubleNear, firstHighFrequencyResult));
-        EXPECT_THAT(coefficients.data[WAVELET_LEVELS - 1][0],
+        EXPECT_THAT(List(coefficients, WAVELET_LEVELS - 1, 0),
             testing::Pointwise(doubleNear, firstRowLastHighFrequencyResult));
-        EXPECT_THAT(coefficients.data[WAVELET_LEVELS - 1][(1 << (WAVELET_LEVELS - 1)) - 1],
+        EXPECT_THAT(List(coefficients, WAVELET_LEVELS - 1, (1 << (WAVELET_LEVELS - 1)) - 1),
             testing::Pointwise(doubleNear, lastRowLastHighFrequencyResult));
-        EXPECT_THAT(coefficients.data[WAVELET_LEVELS][0],
+        EXPECT_THAT(List(coefficients, WAVELET_LEVELS, 0),
             testing::Pointwise(doubleNear, firstLowFrequencyResult));
-        EXPECT_THAT(coefficients.data[WAVELET_LEVELS][(1 << (WAVELET_LEVELS - 1)) - 1],
+        EXPECT_THAT(List(coefficients, WAVELET_LEVELS, (1 << (WAVELET_LEVELS - 1)) - 1),
             testing::Pointwise(doubleNear, lastLowFrequencyResult));
     }
 }
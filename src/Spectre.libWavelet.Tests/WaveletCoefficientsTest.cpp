@@ -0,0 +1,94 @@
+/*
+* WaveletCoefficientsTest.cpp
+* Tests layout of the wavelet coefficients in their storage.
+*
+Copyright 2018 Spectre Team
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <gtest/gtest.h>
+#include "Spectre.libException\InconsistentArgumentSizesException.h"
+#include "Spectre.libFunctional\Range.h"
+#include "Spectre.libWavelet\WaveletCoefficients.h"
+#include "Spectre.libWavelet\WaveletDecomposerRef.h"
+#include "Spectre.libWavelet\WaveletReconstructorRef.h"
+
+namespace
+{
+    using namespace spectre::algorithm::wavelet;
+
+    TEST(WaveletCoefficientsInitialization, initializes)
+    {
+        EXPECT_NO_THROW(WaveletCoefficients());
+        EXPECT_NO_THROW(WaveletCoefficients(100));
+    }
+
+    TEST(WaveletCoefficientsTest, doubles_number_of_lists_with_each_level)
+    {
+        WaveletCoefficients coefficients(10);
+
+        EXPECT_EQ(10u, coefficients.SignalLength());
+        EXPECT_EQ(1u, coefficients.NumberOfLists(0));
+        EXPECT_EQ(17u, coefficients.ListLength(0));
+        for (unsigned level = 1; level < WAVELET_LEVELS; level++)
+        {
+            EXPECT_EQ(size_t(1) << level, coefficients.NumberOfLists(level));
+        }
+        EXPECT_EQ(coefficients.NumberOfLists(WAVELET_LEVELS - 1), coefficients.NumberOfLists(WAVELET_LEVELS));
+        EXPECT_EQ(coefficients.ListLength(WAVELET_LEVELS - 1), coefficients.ListLength(WAVELET_LEVELS));
+    }
+
+    TEST(WaveletCoefficientsTest, stores_all_the_lists_one_after_another)
+    {
+        WaveletCoefficients coefficients(1000);
+        const DataType* expected = coefficients.Data().data();
+        size_t total = 0;
+
+        for (unsigned level = 0; level <= WAVELET_LEVELS; level++)
+        {
+            const size_t length = coefficients.ListLength(level);
+            EXPECT_EQ(expected, coefficients.Level(level).data());
+            for (size_t i = 0; i < coefficients.NumberOfLists(level); i++)
+            {
+                EXPECT_EQ(expected, coefficients.List(level, i).data());
+                EXPECT_EQ(length, static_cast<size_t>(coefficients.List(level, i).size()));
+                expected += length;
+                total += length;
+            }
+        }
+        EXPECT_EQ(total, static_cast<size_t>(coefficients.Data().size()));
+        EXPECT_EQ(coefficients.Level(WAVELET_LEVELS).data(), coefficients.LowFrequency(0).data());
+    }
+
+    TEST(WaveletCoefficientsTest, keeps_storage_when_resized_to_shorter_signal)
+    {
+        WaveletCoefficients coefficients(1000);
+        const DataType* storage = coefficients.Data().data();
+
+        coefficients.Resize(10);
+        coefficients.Resize(1000);
+
+        EXPECT_EQ(storage, coefficients.Data().data());
+    }
+
+    TEST(WaveletCoefficientsTest, reconstruction_throws_on_signal_of_other_length)
+    {
+        WaveletDecomposerRef decomposer;
+        WaveletReconstructorRef reconstructor;
+        WaveletCoefficients coefficients = decomposer.Decompose(spectre::core::functional::range<DataType>(10));
+
+        EXPECT_THROW(reconstructor.Reconstruct(std::move(coefficients), 11),
+            spectre::core::exception::InconsistentArgumentSizesException);
+    }
+}
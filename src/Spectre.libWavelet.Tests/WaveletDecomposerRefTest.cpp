@@ -127,6 +127,12 @@ public:
     }
 
 protected:
+    static Signal List(const WaveletCoefficients& coefficients, unsigned level, size_t index)
+    {
+        gsl::span<const DataType> list = coefficients.List(level, index);
+        return Signal(list.begin(), list.end());
+    }
+
     WaveletDecomposerRef decomposer;
     std::vector<DataType> lastRowLastHighFrequencyResult;
     std::vector<DataType> firstRowLastHighFrequencyResult;
@@ -142,15 +148,61 @@ TEST_F(WaveletDecomposerRefTest, decomposes_the_signal)
 
     // Due to high amount of coefficients generated, only a few sets will be compared
     auto doubleNear = double_near(0.001);
-    EXPECT_THAT(coefficients.data[0][0],
+    EXPECT_THAT(List(coefficients, 0, 0),
         testing::Pointwise(doubleNear, firstHighFrequencyResult));
-    EXPECT_THAT(coefficients.data[WAVELET_LEVELS - 1][0],
+    EXPECT_THAT(List(coefficients, WAVELET_LEVELS - 1, 0),
         testing::Pointwise(doubleNear, firstRowLastHighFrequencyResult));
-    EXPECT_THAT(coefficients.data[WAVELET_LEVELS - 1][(1 << (WAVELET_LEVELS - 1)) - 1],
+    EXPECT_THAT(List(coefficients, WAVELET_LEVELS - 1, (1 << (WAVELET_LEVELS - 1)) - 1),
         testing::Pointwise(doubleNear, lastRowLastHighFrequencyResult));
-    EXPECT_THAT(coefficients.data[WAVELET_LEVELS][0],
+    EXPECT_THAT(List(coefficients, WAVELET_LEVELS, 0),
         testing::Pointwise(doubleNear, firstLowFrequencyResult));
-    EXPECT_THAT(coefficients.data[WAVELET_LEVELS][(1 << (WAVELET_LEVELS - 1)) - 1],
+    EXPECT_THAT(List(coefficients, WAVELET_LEVELS, (1 << (WAVELET_LEVELS - 1)) - 1),
         testing::Pointwise(doubleNear, lastLowFrequencyResult));
 }
+
+TEST_F(WaveletDecomposerRefTest, passes_each_list_to_callback_in_order_of_levels)
+{
+    Signal signal = spectre::core::functional::range<DataType>(10);
+    WaveletCoefficients coefficients;
+    Signal buffer;
+    std::vector<unsigned> levels;
+    std::vector<const DataType*> lists;
+
+    decomposer.Decompose(gsl::as_span(signal), coefficients, buffer,
+        [&levels, &lists](unsigned level, gsl::span<DataType> list)
+    {
+        levels.push_back(level);
+        lists.push_back(list.data());
+    });
+
+    size_t position = 0;
+    for (unsigned level = 0; level <= WAVELET_LEVELS; level++)
+    {
+        for (size_t i = 0; i < coefficients.NumberOfLists(level); i++, position++)
+        {
+            ASSERT_LT(position, levels.size());
+            EXPECT_EQ(level, levels[position]);
+            EXPECT_EQ(coefficients.List(level, i).data(), lists[position]);
+        }
+    }
+    EXPECT_EQ(position, levels.size());
+}
+
+TEST_F(WaveletDecomposerRefTest, callback_modifies_stored_coefficients)
+{
+    Signal signal = spectre::core::functional::range<DataType>(10);
+    WaveletCoefficients coefficients;
+    Signal buffer;
+
+    decomposer.Decompose(gsl::as_span(signal), coefficients, buffer,
+        [](unsigned, gsl::span<DataType> list)
+    {
+        std::fill(list.begin(), list.end(), 1.0);
+    });
+
+    for (DataType coefficient : coefficients.Data())
+    {
+        EXPECT_EQ(1.0, coefficient);
+    }
+}
 }
@@ -32,16 +32,25 @@ Signal Convolution::Convolve(const Kernel& kernel, const Signal &signal) const
 Signal Convolution::Convolve(const Kernel& kernel, const Signal &signal, size_t length) const
 {
     std::vector<DataType> convolved(length);
+    Convolve(kernel, gsl::as_span(signal), gsl::as_span(convolved));
+    return convolved;
+}
+
+void Convolution::Convolve(const Kernel& kernel, gsl::span<const DataType> signal,
+    gsl::span<DataType> convolved) const
+{
+    const size_t length = static_cast<size_t>(convolved.size());
+    const DataType* input = signal.data();
+    DataType* output = convolved.data();
     for (unsigned n = 0u; n < length; ++n)
     {
         size_t limit = kernel.size() < (n + 1) ? kernel.size() : (n + 1);
         DataType result = 0.0f; // @sand3r-: speeds the computations up on vc++
         for (unsigned i = 0u; i < limit; ++i)
         {
-            result += kernel[i] * signal[n - i];
+            result += kernel[i] * input[n - i];
         }
-        convolved[n] = result;
+        output[n] = result;
     }
-    return convolved;
 }
 }
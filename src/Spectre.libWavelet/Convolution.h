@@ -52,5 +52,13 @@ public:
     /// <param name="length">Length of signal to consider.</param>
     /// <returns>Filtered signal.</returns>
     Signal Convolve(const Kernel& kernel, const Signal& signal, size_t length) const;
+    /// <summary>
+    /// Convolves the signal using provided kernel into preallocated output.
+    /// As many samples are filtered, as fit into the output.
+    /// </summary>
+    /// <param name="kernel">Kernel to be used.</param>
+    /// <param name="signal">Signal to be convolved, not shorter than output.</param>
+    /// <param name="convolved">Output for filtered signal, must not overlap the input.</param>
+    void Convolve(const Kernel& kernel, gsl::span<const DataType> signal, gsl::span<DataType> convolved) const;
 };
 }
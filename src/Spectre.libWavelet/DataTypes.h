@@ -23,6 +23,4 @@ namespace spectre::algorithm::wavelet
 {
 using DataType = double;
 using Signal = std::vector<DataType>;
-using CoefficientList = std::vector<DataType>;
-using CoefficientsPerLevel = std::vector<CoefficientList>;
 }
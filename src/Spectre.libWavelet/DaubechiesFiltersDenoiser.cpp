@@ -16,6 +16,11 @@
    See the License for the specific language governing permissions and
    limitations under the License.
 */
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "Spectre.libException/InconsistentArgumentSizesException.h"
 #include "DaubechiesFiltersDenoiser.h"
 #include "SoftThresholder.h"
 
@@ -25,48 +30,103 @@ DaubechiesFiltersDenoiser::DaubechiesFiltersDenoiser()
 {
 }
 
-static inline void ExtractCoefficientsForNoiseEstimation(Signal& highFrequencyCoeffs,
-    WaveletCoefficients& coefficients)
+Signal DaubechiesFiltersDenoiser::Denoise(Signal& signal) const
 {
-    CoefficientList& noiseEstimationCoefficients = coefficients.data[0][0];
-    auto chunkStart = noiseEstimationCoefficients.begin();
-    auto chunkEnd = chunkStart + highFrequencyCoeffs.size();
-    highFrequencyCoeffs.assign(chunkStart, chunkEnd);
-}
+    Signal denoisedSignal(signal.size());
+    DenoiserWorkspace workspace(signal.size());
+    Denoise(gsl::as_span(signal), gsl::as_span(denoisedSignal), workspace);
 
-static inline WaveletCoefficients TresholdSignal(const NoiseEstimator& noiseEstimator,
-    WaveletCoefficients& coefficients, size_t signalLength)
-{
-    Signal highFreqCoefficients(signalLength);
-    ExtractCoefficientsForNoiseEstimation(highFreqCoefficients, coefficients);
-    DataType noiseTreshold = noiseEstimator.Estimate(highFreqCoefficients);
-    SoftThresholder tresholder(noiseTreshold);
-    return tresholder(std::move(coefficients));
+    return denoisedSignal;
 }
 
-static inline WaveletCoefficients Decompose(const WaveletDecomposerRef& decomposer,
-    Signal& signal)
+void DaubechiesFiltersDenoiser::Denoise(gsl::span<const DataType> signal, gsl::span<DataType> denoised,
+    DenoiserWorkspace& workspace) const
 {
-    return decomposer.Decompose(std::move(signal));
-}
+    if (signal.size() != denoised.size())
+    {
+        throw spectre::core::exception::InconsistentArgumentSizesException(
+            "signal", static_cast<size_t>(signal.size()), "denoised", static_cast<size_t>(denoised.size()));
+    }
 
-static inline Signal Reconstruct(const WaveletReconstructorRef& reconstructor,
-    WaveletCoefficients& coefficients, size_t signalLength)
-{
-    return reconstructor.Reconstruct(std::move(coefficients), signalLength);
+    const size_t signalLength = static_cast<size_t>(signal.size());
+
+    if (signalLength < 2)
+    {
+        std::copy(signal.begin(), signal.end(), denoised.begin());
+        return;
+    }
+
+    workspace.Reserve(signalLength);
+    // Coefficients are thresholded as soon as they are computed, instead of in another pass
+    // over all of them. Noise is estimated from the first list, which is computed first.
+    // Captures are kept small, so that the callback is stored without memory allocation.
+    m_Decomposer.Decompose(signal, workspace.m_Coefficients, workspace.m_FilterBuffer,
+        [this, &workspace](unsigned level, gsl::span<DataType> coefficients)
+    {
+        if (level == 0)
+        {
+            gsl::span<const DataType> highFreqCoefficients(coefficients.data(),
+                static_cast<std::ptrdiff_t>(workspace.m_Coefficients.SignalLength()));
+            workspace.m_Threshold = m_NoiseEstimator.Estimate(highFreqCoefficients,
+                workspace.m_NoiseEstimationBuffer);
+        }
+        SoftThresholder(workspace.m_Threshold)(coefficients);
+    });
+    m_Reconstructor.Reconstruct(workspace.m_Coefficients, denoised, workspace.m_FilterBuffer);
 }
 
-Signal DaubechiesFiltersDenoiser::Denoise(Signal& signal) const
+void DaubechiesFiltersDenoiser::DenoiseBatch(gsl::span<const DataType> signals, gsl::span<DataType> denoised,
+    size_t signalLength, unsigned numberOfThreads) const
 {
-    const size_t signalLength = signal.size();
+    const size_t size = static_cast<size_t>(signals.size());
+    if (size != static_cast<size_t>(denoised.size()))
+    {
+        throw spectre::core::exception::InconsistentArgumentSizesException(
+            "signals", size, "denoised", static_cast<size_t>(denoised.size()));
+    }
+    if (signalLength == 0 ? size != 0 : size % signalLength != 0)
+    {
+        throw spectre::core::exception::InconsistentArgumentSizesException(
+            "signals", size, "signalLength", signalLength);
+    }
 
-    if (signalLength < 2)
-        return signal;
+    const size_t numberOfSignals = signalLength == 0 ? 0 : size / signalLength;
+    std::vector<const DataType*> rows(numberOfSignals);
+    for (size_t i = 0; i < numberOfSignals; i++)
+    {
+        rows[i] = signals.data() + i * signalLength;
+    }
+    DenoiseRows(rows, denoised, signalLength, numberOfThreads);
+}
 
-    WaveletCoefficients coefficients = Decompose(m_Decomposer, signal);
-    coefficients = TresholdSignal(m_NoiseEstimator, coefficients, signalLength);
-    Signal denoisedSignal = Reconstruct(m_Reconstructor, coefficients, signalLength);
+void DaubechiesFiltersDenoiser::DenoiseRows(const std::vector<const DataType*>& signals,
+    gsl::span<DataType> denoised, size_t signalLength, unsigned numberOfThreads) const
+{
+    const size_t size = signals.size() * signalLength;
+    if (size != static_cast<size_t>(denoised.size()))
+    {
+        throw spectre::core::exception::InconsistentArgumentSizesException(
+            "signals", size, "denoised", static_cast<size_t>(denoised.size()));
+    }
 
-    return denoisedSignal;
+#ifdef _OPENMP
+    const int threads = numberOfThreads != 0 ? static_cast<int>(numberOfThreads) : omp_get_max_threads();
+#else
+    (void)numberOfThreads;
+#endif
+    const auto numberOfSignals = static_cast<int>(signals.size());
+    const auto length = static_cast<std::ptrdiff_t>(signalLength);
+    DataType* output = denoised.data();
+    // Signals cost the same, so that static schedule keeps the workspaces busy evenly.
+    #pragma omp parallel num_threads(threads)
+    {
+        DenoiserWorkspace workspace(signalLength);
+        #pragma omp for schedule(static)
+        for (int i = 0; i < numberOfSignals; i++)
+        {
+            Denoise(gsl::span<const DataType>(signals[i], length),
+                gsl::span<DataType>(output + i * signalLength, length), workspace);
+        }
+    }
 }
 }
\ No newline at end of file
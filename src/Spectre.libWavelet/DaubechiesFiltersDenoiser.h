@@ -18,7 +18,12 @@
 */
 #pragma once
 #include <memory>
+#include <vector>
+#include <span.h>
 #include "DataTypes.h"
+#include "Spectre.libDataset/IReadOnlyDataset.h"
+#include "Spectre.libException/InconsistentArgumentSizesException.h"
+#include "Spectre.libWavelet/DenoiserWorkspace.h"
 #include "Spectre.libWavelet/MedianAbsoluteDeviationNoiseEstimator.h"
 #include "Spectre.libWavelet/WaveletDecomposerRef.h"
 #include "Spectre.libWavelet/WaveletReconstructorRef.h"
@@ -32,7 +37,57 @@ class DaubechiesFiltersDenoiser
 public:
     explicit DaubechiesFiltersDenoiser();
     Signal Denoise(Signal& signal) const;
+    /// <summary>
+    /// Denoises the signal, reusing storage of the workspace. There are no
+    /// memory allocations, when the workspace was sized for the signal length.
+    /// </summary>
+    /// <param name="signal">Signal to denoise.</param>
+    /// <param name="denoised">Output for denoised signal, may be the same as the input.</param>
+    /// <param name="workspace">Storage for intermediate results, extended when too small.</param>
+    /// <exception cref="InconsistentArgumentSizesException">Thrown when signal and output
+    /// differ in length.</exception>
+    void Denoise(gsl::span<const DataType> signal, gsl::span<DataType> denoised,
+        DenoiserWorkspace& workspace) const;
+    /// <summary>
+    /// Denoises signals of equal length in parallel, each thread reusing its own workspace.
+    /// </summary>
+    /// <param name="signals">Signals stored one after another, e.g. pixels x bins matrix.</param>
+    /// <param name="denoised">Output for denoised signals, may be the same as the input.</param>
+    /// <param name="signalLength">Length of each of the signals.</param>
+    /// <param name="numberOfThreads">Number of threads to use. 0 stands for OpenMP default.</param>
+    /// <exception cref="InconsistentArgumentSizesException">Thrown when signals and output
+    /// differ in size, or signals are not a whole number of rows.</exception>
+    void DenoiseBatch(gsl::span<const DataType> signals, gsl::span<DataType> denoised, size_t signalLength,
+        unsigned numberOfThreads = 0) const;
+    /// <summary>
+    /// Denoises signals of the dataset in parallel, each thread reusing its own workspace.
+    /// </summary>
+    /// <param name="dataset">Signals of equal length.</param>
+    /// <param name="denoised">Output for denoised signals, stored one after another.</param>
+    /// <param name="numberOfThreads">Number of threads to use. 0 stands for OpenMP default.</param>
+    /// <exception cref="InconsistentArgumentSizesException">Thrown when signals differ in length,
+    /// or output does not fit all of them.</exception>
+    template <typename SampleMetadata, typename DatasetMetadata>
+    void DenoiseBatch(const spectre::core::dataset::IReadOnlyDataset<Signal, SampleMetadata, DatasetMetadata>& dataset,
+        gsl::span<DataType> denoised, unsigned numberOfThreads = 0) const
+    {
+        const size_t signalLength = dataset.empty() ? 0 : dataset[0].size();
+        std::vector<const DataType*> signals(dataset.size());
+        for (size_t i = 0; i < dataset.size(); i++)
+        {
+            if (dataset[i].size() != signalLength)
+            {
+                throw spectre::core::exception::InconsistentArgumentSizesException(
+                    "first signal", signalLength, "signal " + std::to_string(i), dataset[i].size());
+            }
+            signals[i] = dataset[i].data();
+        }
+        DenoiseRows(signals, denoised, signalLength, numberOfThreads);
+    }
 private:
+    void DenoiseRows(const std::vector<const DataType*>& signals, gsl::span<DataType> denoised,
+        size_t signalLength, unsigned numberOfThreads) const;
+
     static constexpr unsigned m_Base = 4;
     static constexpr unsigned m_LevelsOfDecomposition = 10;
     const NoiseEstimator m_NoiseEstimator;
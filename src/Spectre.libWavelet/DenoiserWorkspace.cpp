@@ -0,0 +1,46 @@
+/*
+ * DenoiserWorkspace.cpp
+ * Storage reused by consecutive runs of the wavelet denoiser.
+ *
+   Copyright 2018 Spectre Team
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "DenoiserWorkspace.h"
+
+namespace spectre::algorithm::wavelet
+{
+DenoiserWorkspace::DenoiserWorkspace(size_t signalLength)
+    : m_Capacity(0), m_Threshold(0.0)
+{
+    Reserve(signalLength);
+}
+
+// Coefficients keep their storage, when laid out for a shorter signal,
+// so storage reserved here is used by all the following runs.
+void DenoiserWorkspace::Reserve(size_t signalLength)
+{
+    if (signalLength <= m_Capacity)
+        return;
+
+    m_Coefficients.Resize(signalLength);
+    m_FilterBuffer.reserve(m_Coefficients.LowFrequencyCapacity());
+    m_NoiseEstimationBuffer.reserve(signalLength);
+    m_Capacity = signalLength;
+}
+
+size_t DenoiserWorkspace::Capacity() const
+{
+    return m_Capacity;
+}
+}
@@ -0,0 +1,60 @@
+/*
+ * DenoiserWorkspace.h
+ * Storage reused by consecutive runs of the wavelet denoiser.
+ *
+   Copyright 2018 Spectre Team
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include "DataTypes.h"
+#include "WaveletCoefficients.h"
+
+namespace spectre::algorithm::wavelet
+{
+/// <summary>
+/// Holds wavelet coefficients and intermediate buffers of the denoiser, so
+/// that signals of the same or smaller length are denoised without any
+/// memory allocations. A single workspace may not be used by many threads
+/// at once.
+/// </summary>
+class DenoiserWorkspace
+{
+public:
+    /// <summary>
+    /// Initializes a new instance of the <see cref="DenoiserWorkspace"/> class.
+    /// </summary>
+    /// <param name="signalLength">Length of signals to reserve the storage for.</param>
+    explicit DenoiserWorkspace(size_t signalLength = 0);
+    /// <summary>
+    /// Extends the storage to fit signals of given length. Does nothing, when
+    /// the storage is sufficient already.
+    /// </summary>
+    /// <param name="signalLength">Length of signals to reserve the storage for.</param>
+    void Reserve(size_t signalLength);
+    /// <summary>
+    /// Gets length of the longest signal the storage is reserved for.
+    /// </summary>
+    /// <returns>Length of signal.</returns>
+    size_t Capacity() const;
+
+private:
+    friend class DaubechiesFiltersDenoiser;
+
+    size_t m_Capacity;
+    DataType m_Threshold;
+    WaveletCoefficients m_Coefficients;
+    Signal m_FilterBuffer;
+    Signal m_NoiseEstimationBuffer;
+};
+}
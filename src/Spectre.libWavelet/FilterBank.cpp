@@ -0,0 +1,308 @@
+/*
+ * FilterBank.cpp
+ * Vectorized convolution of the signal with a pair of Daubechies filters.
+ *
+   Copyright 2018 Spectre Team
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "FilterBank.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FILTER_BANK_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define FILTER_BANK_TARGET_AVX2
+#define FILTER_BANK_TARGET_AVX512
+// AVX-512 intrinsics are available since Visual Studio 2017 version 15.3
+#if _MSC_VER >= 1911
+#define FILTER_BANK_AVX512
+#endif
+#else
+#define FILTER_BANK_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define FILTER_BANK_TARGET_AVX512 __attribute__((target("avx512f")))
+#define FILTER_BANK_AVX512
+#endif
+#endif
+
+namespace spectre::algorithm::wavelet
+{
+namespace
+{
+constexpr size_t TAPS = 8;
+
+void SplitInteriorScalar(const DataType* lowPass, const DataType* highPass, const DataType* signal,
+    size_t begin, size_t end, DataType* lowPassed, DataType* highPassed)
+{
+    for (size_t n = begin; n < end; n++)
+    {
+        DataType low = 0.0;
+        DataType high = 0.0;
+        for (size_t i = 0; i < TAPS; i++)
+        {
+            low += lowPass[i] * signal[n - i];
+            high += highPass[i] * signal[n - i];
+        }
+        lowPassed[n] = low;
+        highPassed[n] = high;
+    }
+}
+
+void MergeInteriorScalar(const DataType* lowPass, const DataType* highPass, const DataType* lowFrequency,
+    const DataType* highFrequency, size_t begin, size_t end, DataType* merged)
+{
+    for (size_t n = begin; n < end; n++)
+    {
+        DataType sum = 0.0;
+        for (size_t i = 0; i < TAPS; i++)
+        {
+            sum += lowPass[i] * lowFrequency[n - i] + highPass[i] * highFrequency[n - i];
+        }
+        merged[n] = sum;
+    }
+}
+
+#if defined(FILTER_BANK_X86)
+// Each iteration computes as many consecutive samples, as fit into a register.
+// Tap i of all of them is a product of the same coefficient and a contiguous
+// slice of the signal, shifted by i, so it is a single unaligned load.
+FILTER_BANK_TARGET_AVX2
+void SplitInteriorAvx2(const DataType* lowPass, const DataType* highPass, const DataType* signal,
+    size_t begin, size_t end, DataType* lowPassed, DataType* highPassed)
+{
+    __m256d lowTaps[TAPS];
+    __m256d highTaps[TAPS];
+    for (size_t i = 0; i < TAPS; i++)
+    {
+        lowTaps[i] = _mm256_set1_pd(lowPass[i]);
+        highTaps[i] = _mm256_set1_pd(highPass[i]);
+    }
+    size_t n = begin;
+    for (; n + 4 <= end; n += 4)
+    {
+        __m256d low = _mm256_setzero_pd();
+        __m256d high = _mm256_setzero_pd();
+        for (size_t i = 0; i < TAPS; i++)
+        {
+            const __m256d samples = _mm256_loadu_pd(signal + n - i);
+            low = _mm256_fmadd_pd(lowTaps[i], samples, low);
+            high = _mm256_fmadd_pd(highTaps[i], samples, high);
+        }
+        _mm256_storeu_pd(lowPassed + n, low);
+        _mm256_storeu_pd(highPassed + n, high);
+    }
+    SplitInteriorScalar(lowPass, highPass, signal, n, end, lowPassed, highPassed);
+}
+
+FILTER_BANK_TARGET_AVX2
+void MergeInteriorAvx2(const DataType* lowPass, const DataType* highPass, const DataType* lowFrequency,
+    const DataType* highFrequency, size_t begin, size_t end, DataType* merged)
+{
+    __m256d lowTaps[TAPS];
+    __m256d highTaps[TAPS];
+    for (size_t i = 0; i < TAPS; i++)
+    {
+        lowTaps[i] = _mm256_set1_pd(lowPass[i]);
+        highTaps[i] = _mm256_set1_pd(highPass[i]);
+    }
+    size_t n = begin;
+    for (; n + 4 <= end; n += 4)
+    {
+        __m256d sum = _mm256_setzero_pd();
+        for (size_t i = 0; i < TAPS; i++)
+        {
+            sum = _mm256_fmadd_pd(lowTaps[i], _mm256_loadu_pd(lowFrequency + n - i), sum);
+            sum = _mm256_fmadd_pd(highTaps[i], _mm256_loadu_pd(highFrequency + n - i), sum);
+        }
+        _mm256_storeu_pd(merged + n, sum);
+    }
+    MergeInteriorScalar(lowPass, highPass, lowFrequency, highFrequency, n, end, merged);
+}
+
+bool IsAvx2Supported()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool hasFma = (info[2] & (1 << 12)) != 0;
+    const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    const bool hasAvx = (info[2] & (1 << 28)) != 0;
+    // operating system has to preserve YMM registers on context switch
+    if (!hasFma || !hasOsxsave || !hasAvx || (_xgetbv(0) & 6) != 6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+#else
+void SplitInteriorAvx2(const DataType* lowPass, const DataType* highPass, const DataType* signal,
+    size_t begin, size_t end, DataType* lowPassed, DataType* highPassed)
+{
+    SplitInteriorScalar(lowPass, highPass, signal, begin, end, lowPassed, highPassed);
+}
+
+void MergeInteriorAvx2(const DataType* lowPass, const DataType* highPass, const DataType* lowFrequency,
+    const DataType* highFrequency, size_t begin, size_t end, DataType* merged)
+{
+    MergeInteriorScalar(lowPass, highPass, lowFrequency, highFrequency, begin, end, merged);
+}
+
+bool IsAvx2Supported()
+{
+    return false;
+}
+#endif
+
+#if defined(FILTER_BANK_X86) && defined(FILTER_BANK_AVX512)
+FILTER_BANK_TARGET_AVX512
+void SplitInteriorAvx512(const DataType* lowPass, const DataType* highPass, const DataType* signal,
+    size_t begin, size_t end, DataType* lowPassed, DataType* highPassed)
+{
+    __m512d lowTaps[TAPS];
+    __m512d highTaps[TAPS];
+    for (size_t i = 0; i < TAPS; i++)
+    {
+        lowTaps[i] = _mm512_set1_pd(lowPass[i]);
+        highTaps[i] = _mm512_set1_pd(highPass[i]);
+    }
+    size_t n = begin;
+    for (; n + 8 <= end; n += 8)
+    {
+        __m512d low = _mm512_setzero_pd();
+        __m512d high = _mm512_setzero_pd();
+        for (size_t i = 0; i < TAPS; i++)
+        {
+            const __m512d samples = _mm512_loadu_pd(signal + n - i);
+            low = _mm512_fmadd_pd(lowTaps[i], samples, low);
+            high = _mm512_fmadd_pd(highTaps[i], samples, high);
+        }
+        _mm512_storeu_pd(lowPassed + n, low);
+        _mm512_storeu_pd(highPassed + n, high);
+    }
+    SplitInteriorScalar(lowPass, highPass, signal, n, end, lowPassed, highPassed);
+}
+
+FILTER_BANK_TARGET_AVX512
+void MergeInteriorAvx512(const DataType* lowPass, const DataType* highPass, const DataType* lowFrequency,
+    const DataType* highFrequency, size_t begin, size_t end, DataType* merged)
+{
+    __m512d lowTaps[TAPS];
+    __m512d highTaps[TAPS];
+    for (size_t i = 0; i < TAPS; i++)
+    {
+        lowTaps[i] = _mm512_set1_pd(lowPass[i]);
+        highTaps[i] = _mm512_set1_pd(highPass[i]);
+    }
+    size_t n = begin;
+    for (; n + 8 <= end; n += 8)
+    {
+        __m512d sum = _mm512_setzero_pd();
+        for (size_t i = 0; i < TAPS; i++)
+        {
+            sum = _mm512_fmadd_pd(lowTaps[i], _mm512_loadu_pd(lowFrequency + n - i), sum);
+            sum = _mm512_fmadd_pd(highTaps[i], _mm512_loadu_pd(highFrequency + n - i), sum);
+        }
+        _mm512_storeu_pd(merged + n, sum);
+    }
+    MergeInteriorScalar(lowPass, highPass, lowFrequency, highFrequency, n, end, merged);
+}
+
+bool IsAvx512Supported()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+    // operating system has to preserve opmask and all ZMM registers on context switch
+    if (!hasOsxsave || (_xgetbv(0) & 0xE6) != 0xE6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f");
+#endif
+}
+#else
+void SplitInteriorAvx512(const DataType* lowPass, const DataType* highPass, const DataType* signal,
+    size_t begin, size_t end, DataType* lowPassed, DataType* highPassed)
+{
+    SplitInteriorAvx2(lowPass, highPass, signal, begin, end, lowPassed, highPassed);
+}
+
+void MergeInteriorAvx512(const DataType* lowPass, const DataType* highPass, const DataType* lowFrequency,
+    const DataType* highFrequency, size_t begin, size_t end, DataType* merged)
+{
+    MergeInteriorAvx2(lowPass, highPass, lowFrequency, highFrequency, begin, end, merged);
+}
+
+bool IsAvx512Supported()
+{
+    return false;
+}
+#endif
+
+typedef void (*SplitFunction)(const DataType*, const DataType*, const DataType*, size_t, size_t,
+    DataType*, DataType*);
+typedef void (*MergeFunction)(const DataType*, const DataType*, const DataType*, const DataType*, size_t,
+    size_t, DataType*);
+
+SplitFunction SelectSplit()
+{
+    if (IsAvx512Supported())
+        return SplitInteriorAvx512;
+    return IsAvx2Supported() ? SplitInteriorAvx2 : SplitInteriorScalar;
+}
+
+MergeFunction SelectMerge()
+{
+    if (IsAvx512Supported())
+        return MergeInteriorAvx512;
+    return IsAvx2Supported() ? MergeInteriorAvx2 : MergeInteriorScalar;
+}
+}
+
+template <>
+void SplitInterior<8>(const DataType* lowPass, const DataType* highPass, const DataType* signal,
+    size_t begin, size_t end, DataType* lowPassed, DataType* highPassed)
+{
+    static const SplitFunction split = SelectSplit();
+    split(lowPass, highPass, signal, begin, end, lowPassed, highPassed);
+}
+
+template <>
+void MergeInterior<8>(const DataType* lowPass, const DataType* highPass, const DataType* lowFrequency,
+    const DataType* highFrequency, size_t begin, size_t end, DataType* merged)
+{
+    static const MergeFunction merge = SelectMerge();
+    merge(lowPass, highPass, lowFrequency, highFrequency, begin, end, merged);
+}
+}
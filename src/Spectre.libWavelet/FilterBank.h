@@ -0,0 +1,191 @@
+/*
+ * FilterBank.h
+ * Convolves the signal with a pair of wavelet filters of fixed length at once.
+ *
+   Copyright 2018 Spectre Team
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#pragma once
+#include <algorithm>
+#include <array>
+#include <span.h>
+#include "AlgorithmConstants.h"
+#include "DataTypes.h"
+
+namespace spectre::algorithm::wavelet
+{
+/// <summary>
+/// Computes samples [begin, end) of both signal filtered with low pass filter
+/// and signal filtered with high pass filter. All the filter taps lie within
+/// the signal, i.e. begin is at least FilterLength - 1, so there is no branching.
+/// </summary>
+/// <param name="lowPass">Coefficients of low pass filter.</param>
+/// <param name="highPass">Coefficients of high pass filter.</param>
+/// <param name="signal">Signal to be filtered.</param>
+/// <param name="begin">First sample to compute.</param>
+/// <param name="end">Sample following the last one to compute.</param>
+/// <param name="lowPassed">Output for low pass filtered signal.</param>
+/// <param name="highPassed">Output for high pass filtered signal.</param>
+template <size_t FilterLength>
+inline void SplitInterior(const DataType* lowPass, const DataType* highPass, const DataType* signal,
+    size_t begin, size_t end, DataType* lowPassed, DataType* highPassed)
+{
+    for (size_t n = begin; n < end; n++)
+    {
+        DataType low = 0.0;
+        DataType high = 0.0;
+        for (size_t i = 0; i < FilterLength; i++)
+        {
+            low += lowPass[i] * signal[n - i];
+            high += highPass[i] * signal[n - i];
+        }
+        lowPassed[n] = low;
+        highPassed[n] = high;
+    }
+}
+
+/// <summary>
+/// Computes samples [begin, end) of sum of low frequency signal filtered with low
+/// pass filter and high frequency signal filtered with high pass filter. All the
+/// filter taps lie within the signals, i.e. begin is at least FilterLength - 1.
+/// </summary>
+/// <param name="lowPass">Coefficients of low pass filter.</param>
+/// <param name="highPass">Coefficients of high pass filter.</param>
+/// <param name="lowFrequency">Signal to be filtered with low pass filter.</param>
+/// <param name="highFrequency">Signal to be filtered with high pass filter.</param>
+/// <param name="begin">First sample to compute.</param>
+/// <param name="end">Sample following the last one to compute.</param>
+/// <param name="merged">Output for sum of filtered signals.</param>
+template <size_t FilterLength>
+inline void MergeInterior(const DataType* lowPass, const DataType* highPass, const DataType* lowFrequency,
+    const DataType* highFrequency, size_t begin, size_t end, DataType* merged)
+{
+    for (size_t n = begin; n < end; n++)
+    {
+        DataType sum = 0.0;
+        for (size_t i = 0; i < FilterLength; i++)
+        {
+            sum += lowPass[i] * lowFrequency[n - i] + highPass[i] * highFrequency[n - i];
+        }
+        merged[n] = sum;
+    }
+}
+
+/// <summary>
+/// SplitInterior specialized for Daubechies filters. Uses AVX-512 or AVX2 code,
+/// when processor supports it, scalar code otherwise.
+/// </summary>
+template <>
+void SplitInterior<8>(const DataType* lowPass, const DataType* highPass, const DataType* signal,
+    size_t begin, size_t end, DataType* lowPassed, DataType* highPassed);
+
+/// <summary>
+/// MergeInterior specialized for Daubechies filters. Uses AVX-512 or AVX2 code,
+/// when processor supports it, scalar code otherwise.
+/// </summary>
+template <>
+void MergeInterior<8>(const DataType* lowPass, const DataType* highPass, const DataType* lowFrequency,
+    const DataType* highFrequency, size_t begin, size_t end, DataType* merged);
+
+/// <summary>
+/// Pair of low and high pass filters of the same length, applied in a single
+/// pass over the data. Filtering is the same as in Convolution, i.e. first
+/// samples are computed only from as many taps, as there are samples before.
+/// </summary>
+template <size_t FilterLength>
+class FilterBank
+{
+public:
+    using Filter = std::array<const DataType, FilterLength>;
+
+    /// <summary>
+    /// Initializes a new instance of the <see cref="FilterBank"/> class.
+    /// </summary>
+    /// <param name="lowPass">Coefficients of low pass filter.</param>
+    /// <param name="highPass">Coefficients of high pass filter.</param>
+    /// <param name="gain">Factor all the coefficients are multiplied by.</param>
+    explicit FilterBank(const Filter& lowPass, const Filter& highPass, DataType gain = 1.0)
+    {
+        for (size_t i = 0; i < FilterLength; i++)
+        {
+            m_LowPass[i] = gain * lowPass[i];
+            m_HighPass[i] = gain * highPass[i];
+        }
+    }
+
+    /// <summary>
+    /// Filters the signal with both low and high pass filter. As many samples
+    /// are filtered, as fit into the outputs.
+    /// </summary>
+    /// <param name="signal">Signal to be filtered, not shorter than outputs.</param>
+    /// <param name="lowPassed">Output for low pass filtered signal.</param>
+    /// <param name="highPassed">Output for high pass filtered signal, of the same length.</param>
+    void Split(gsl::span<const DataType> signal, gsl::span<DataType> lowPassed,
+        gsl::span<DataType> highPassed) const
+    {
+        const size_t length = static_cast<size_t>(lowPassed.size());
+        const size_t head = std::min(length, FilterLength - 1);
+        const DataType* input = signal.data();
+        DataType* low = lowPassed.data();
+        DataType* high = highPassed.data();
+        for (size_t n = 0; n < head; n++)
+        {
+            low[n] = 0.0;
+            high[n] = 0.0;
+            for (size_t i = 0; i <= n; i++)
+            {
+                low[n] += m_LowPass[i] * input[n - i];
+                high[n] += m_HighPass[i] * input[n - i];
+            }
+        }
+        SplitInterior<FilterLength>(m_LowPass.data(), m_HighPass.data(), input, head, length, low, high);
+    }
+
+    /// <summary>
+    /// Filters low frequency signal with low pass filter, high frequency signal
+    /// with high pass filter and sums them up. As many samples are filtered,
+    /// as fit into the output.
+    /// </summary>
+    /// <param name="lowFrequency">Signal to be low pass filtered, not shorter than output.</param>
+    /// <param name="highFrequency">Signal to be high pass filtered, not shorter than output.</param>
+    /// <param name="merged">Output for sum of filtered signals.</param>
+    void Merge(gsl::span<const DataType> lowFrequency, gsl::span<const DataType> highFrequency,
+        gsl::span<DataType> merged) const
+    {
+        const size_t length = static_cast<size_t>(merged.size());
+        const size_t head = std::min(length, FilterLength - 1);
+        const DataType* low = lowFrequency.data();
+        const DataType* high = highFrequency.data();
+        DataType* output = merged.data();
+        for (size_t n = 0; n < head; n++)
+        {
+            output[n] = 0.0;
+            for (size_t i = 0; i <= n; i++)
+            {
+                output[n] += m_LowPass[i] * low[n - i] + m_HighPass[i] * high[n - i];
+            }
+        }
+        MergeInterior<FilterLength>(m_LowPass.data(), m_HighPass.data(), low, high, head, length, output);
+    }
+
+private:
+    std::array<DataType, FilterLength> m_LowPass;
+    std::array<DataType, FilterLength> m_HighPass;
+};
+
+/// <summary>
+/// Filter bank of Daubechies filters used by the wavelet transform.
+/// </summary>
+using DaubechiesFilterBank = FilterBank<BASIS_LENGTH + 1>;
+}
@@ -16,7 +16,8 @@
    See the License for the specific language governing permissions and
    limitations under the License.
 */
-#include "Spectre.libStatistics/Statistics.h"
+#include <algorithm>
+#include <cmath>
 #include "MedianAbsoluteDeviationNoiseEstimator.h"
 
 namespace spectre::algorithm::wavelet
@@ -26,12 +27,37 @@ namespace spectre::algorithm::wavelet
 {
 }
 
+// Computes median of the data, reordering it in place instead of sorting a copy.
+static inline DataType MedianInPlace(Signal& data)
+{
+    if (data.empty())
+        return 0.0;
+    const auto middle = data.begin() + data.size() / 2;
+    std::nth_element(data.begin(), middle, data.end());
+    if (data.size() % 2)
+        return *middle;
+    return (*middle + *std::max_element(data.begin(), middle)) / 2.0;
+}
+
 DataType MedianAbsoluteDeviationNoiseEstimator::Estimate(Signal& highFreqCoefficients) const
+{
+    Signal buffer;
+    return Estimate(gsl::as_span(highFreqCoefficients), buffer);
+}
+
+DataType MedianAbsoluteDeviationNoiseEstimator::Estimate(gsl::span<const DataType> highFreqCoefficients,
+    Signal& buffer) const
 {
     constexpr auto inverseOfThirdQuartileInNormalDistribution = static_cast<DataType>(1.0 / .6745);
+    buffer.assign(highFreqCoefficients.begin(), highFreqCoefficients.end());
+    const DataType median = MedianInPlace(buffer);
+    for (DataType& value : buffer)
+    {
+        value = std::abs(value - median);
+    }
     return m_Multiplier
-        * sqrt(2 * log(highFreqCoefficients.size()))
-        * statistics::simple_statistics::MedianAbsoluteDeviation(gsl::as_span(highFreqCoefficients))
+        * sqrt(2 * log(static_cast<DataType>(buffer.size())))
+        * MedianInPlace(buffer)
         * inverseOfThirdQuartileInNormalDistribution;
 }
 }
\ No newline at end of file
@@ -17,6 +17,7 @@
    limitations under the License.
 */
 #pragma once
+#include <span.h>
 #include "DataTypes.h"
 
 namespace spectre::algorithm::wavelet
@@ -39,6 +40,14 @@ public:
     /// <param name="intensities">Signal to be analyzed.</param>
     /// <returns>Estiamte of the noise in the signal.</returns>
     DataType Estimate(Signal& intensities) const;
+    /// <summary>
+    /// Estimates the MAD of the noise, without allocating memory, when
+    /// the buffer is large enough to hold the signal.
+    /// </summary>
+    /// <param name="intensities">Signal to be analyzed.</param>
+    /// <param name="buffer">Buffer the computations are performed in.</param>
+    /// <returns>Estiamte of the noise in the signal.</returns>
+    DataType Estimate(gsl::span<const DataType> intensities, Signal& buffer) const;
 private:
     const DataType m_Multiplier;
 };
@@ -28,20 +28,24 @@ SoftThresholder::SoftThresholder(DataType threshold)
 
 WaveletCoefficients SoftThresholder::operator()(WaveletCoefficients&& coefficients) const
 {
-    auto& coeffs = coefficients.data;
-    for (unsigned level = 0; level < WAVELET_LEVELS + 1; level++)
+    (*this)(coefficients);
+    return coefficients;
+}
+
+// Coefficients are stored contiguously, so that they are thresholded in a single sweep.
+void SoftThresholder::operator()(WaveletCoefficients& coefficients) const
+{
+    (*this)(coefficients.Data());
+}
+
+void SoftThresholder::operator()(gsl::span<DataType> coefficients) const
+{
+    DataType* data = coefficients.data();
+    const size_t size = static_cast<size_t>(coefficients.size());
+    for (size_t i = 0; i < size; i++)
     {
-        for (unsigned scale = 0; scale < coeffs[level].size(); scale++)
-        {
-            for (unsigned i = 0; i < coeffs[level][scale].size(); i++)
-            {
-                DataType value = coeffs[level][scale][i];
-                coeffs[level][scale][i] = std::max(0.0, std::abs(value) - m_Threshold);
-                coeffs[level][scale][i] = std::copysign(coeffs[level][scale][i], value);
-            }
-        }
+        const DataType value = data[i];
+        data[i] = std::copysign(std::max(0.0, std::abs(value) - m_Threshold), value);
     }
-
-    return coefficients;
 }
 }
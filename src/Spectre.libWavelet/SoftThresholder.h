@@ -38,6 +38,16 @@ public:
     /// <param name="coefficients">Signal to apply tresholding to.</param>
     /// <returns>Tresholded signal.</returns>
     WaveletCoefficients operator()(WaveletCoefficients&& coefficients) const;
+    /// <summary>
+    /// Tresholds the coefficients in place.
+    /// </summary>
+    /// <param name="coefficients">Signal to apply tresholding to.</param>
+    void operator()(WaveletCoefficients& coefficients) const;
+    /// <summary>
+    /// Tresholds part of the coefficients in place, e.g. a single list.
+    /// </summary>
+    /// <param name="coefficients">Coefficients to apply tresholding to.</param>
+    void operator()(gsl::span<DataType> coefficients) const;
 private:
     const DataType m_Threshold;
 };
@@ -0,0 +1,111 @@
+/*
+ * WaveletCoefficients.cpp
+ * Coefficients used by wavelet decomposition and reconstruction.
+ *
+   Copyright 2018 Spectre Team
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include <algorithm>
+#include "WaveletCoefficients.h"
+#include "WaveletUtils.h"
+
+namespace spectre::algorithm::wavelet
+{
+WaveletCoefficients::WaveletCoefficients(size_t signalLength)
+{
+    Resize(signalLength);
+}
+
+void WaveletCoefficients::Resize(size_t signalLength)
+{
+    m_SignalLength = signalLength;
+    m_LowFrequencyCapacity = 0;
+    size_t offset = 0;
+    for (unsigned level = 0; level < WAVELET_LEVELS; level++)
+    {
+        m_ListLengths[level] = ComputeBlockLength(level, NumberOfLists(level), signalLength);
+        m_Offsets[level] = offset;
+        const size_t levelSize = NumberOfLists(level) * m_ListLengths[level];
+        offset += levelSize;
+        m_LowFrequencyCapacity = std::max(m_LowFrequencyCapacity, levelSize);
+    }
+    m_Offsets[WAVELET_LEVELS] = offset;
+    // Shrinking vector keeps its storage, so it is reused by longer signals as well.
+    m_Data.resize(offset + m_LowFrequencyCapacity);
+}
+
+size_t WaveletCoefficients::SignalLength() const
+{
+    return m_SignalLength;
+}
+
+size_t WaveletCoefficients::NumberOfLists(unsigned level) const
+{
+    if (level == 0)
+        return 1;
+    return ComputeScale(std::min(level, WAVELET_LEVELS - 1) - 1);
+}
+
+size_t WaveletCoefficients::ListLength(unsigned level) const
+{
+    return m_ListLengths[std::min(level, WAVELET_LEVELS - 1)];
+}
+
+gsl::span<DataType> WaveletCoefficients::List(unsigned level, size_t index)
+{
+    const size_t length = ListLength(level);
+    return gsl::span<DataType>(m_Data.data() + m_Offsets[level] + index * length,
+        static_cast<std::ptrdiff_t>(length));
+}
+
+gsl::span<const DataType> WaveletCoefficients::List(unsigned level, size_t index) const
+{
+    const size_t length = ListLength(level);
+    return gsl::span<const DataType>(m_Data.data() + m_Offsets[level] + index * length,
+        static_cast<std::ptrdiff_t>(length));
+}
+
+gsl::span<DataType> WaveletCoefficients::Level(unsigned level)
+{
+    return gsl::span<DataType>(m_Data.data() + m_Offsets[level],
+        static_cast<std::ptrdiff_t>(NumberOfLists(level) * ListLength(level)));
+}
+
+gsl::span<DataType> WaveletCoefficients::LowFrequency(unsigned level)
+{
+    return gsl::span<DataType>(m_Data.data() + m_Offsets[WAVELET_LEVELS],
+        static_cast<std::ptrdiff_t>(NumberOfLists(level) * ListLength(level)));
+}
+
+size_t WaveletCoefficients::LowFrequencyCapacity() const
+{
+    return m_LowFrequencyCapacity;
+}
+
+// Storage left over behind the lowest frequency coefficients is not a part of the data.
+size_t WaveletCoefficients::DataSize() const
+{
+    return m_Offsets[WAVELET_LEVELS] + NumberOfLists(WAVELET_LEVELS) * ListLength(WAVELET_LEVELS);
+}
+
+gsl::span<DataType> WaveletCoefficients::Data()
+{
+    return gsl::span<DataType>(m_Data.data(), static_cast<std::ptrdiff_t>(DataSize()));
+}
+
+gsl::span<const DataType> WaveletCoefficients::Data() const
+{
+    return gsl::span<const DataType>(m_Data.data(), static_cast<std::ptrdiff_t>(DataSize()));
+}
+}
@@ -17,13 +17,102 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #pragma once
+#include <span.h>
 #include "AlgorithmConstants.h"
 #include "DataTypes.h"
 
 namespace spectre::algorithm::wavelet
 {
-struct WaveletCoefficients
+/// <summary>
+/// Coefficients of all the levels of the decomposition, stored in a single
+/// buffer. Level holds a number of lists of the same length, one after
+/// another, and levels follow each other from the highest frequency one.
+/// Coefficients of the lowest frequency are stored at the end, in storage
+/// used also as working area of the transform.
+/// </summary>
+class WaveletCoefficients
 {
-    CoefficientsPerLevel data[WAVELET_LEVELS + 1]; // + 1 for lowest frequency
+public:
+    /// <summary>
+    /// Initializes a new instance of the <see cref="WaveletCoefficients"/> class.
+    /// </summary>
+    /// <param name="signalLength">Length of the signal the coefficients describe.</param>
+    explicit WaveletCoefficients(size_t signalLength = 0);
+    /// <summary>
+    /// Lays the coefficients out for a signal of given length. Storage is not
+    /// reallocated, when it was already laid out for a signal of at least that
+    /// length. Values of the coefficients are not retained.
+    /// </summary>
+    /// <param name="signalLength">Length of the signal the coefficients describe.</param>
+    void Resize(size_t signalLength);
+    /// <summary>
+    /// Gets length of the signal the coefficients describe.
+    /// </summary>
+    /// <returns>Length of the signal.</returns>
+    size_t SignalLength() const;
+    /// <summary>
+    /// Gets number of coefficient lists at given level.
+    /// </summary>
+    /// <param name="level">Level of the decomposition, WAVELET_LEVELS for the lowest frequency.</param>
+    /// <returns>Number of lists.</returns>
+    size_t NumberOfLists(unsigned level) const;
+    /// <summary>
+    /// Gets length of each coefficient list at given level.
+    /// </summary>
+    /// <param name="level">Level of the decomposition, WAVELET_LEVELS for the lowest frequency.</param>
+    /// <returns>Length of the lists.</returns>
+    size_t ListLength(unsigned level) const;
+    /// <summary>
+    /// Gets a single list of coefficients.
+    /// </summary>
+    /// <param name="level">Level of the decomposition, WAVELET_LEVELS for the lowest frequency.</param>
+    /// <param name="index">Index of the list within the level.</param>
+    /// <returns>Coefficients of the list.</returns>
+    gsl::span<DataType> List(unsigned level, size_t index);
+    /// <summary>
+    /// Gets a single list of coefficients.
+    /// </summary>
+    /// <param name="level">Level of the decomposition, WAVELET_LEVELS for the lowest frequency.</param>
+    /// <param name="index">Index of the list within the level.</param>
+    /// <returns>Coefficients of the list.</returns>
+    gsl::span<const DataType> List(unsigned level, size_t index) const;
+    /// <summary>
+    /// Gets all the lists of given level, one after another.
+    /// </summary>
+    /// <param name="level">Level of the decomposition, WAVELET_LEVELS for the lowest frequency.</param>
+    /// <returns>Coefficients of the level.</returns>
+    gsl::span<DataType> Level(unsigned level);
+    /// <summary>
+    /// Gets storage of the lowest frequency coefficients laid out as lists of
+    /// another level. Used by the transform, which moves through the levels.
+    /// </summary>
+    /// <param name="level">Level of the decomposition the layout is taken from.</param>
+    /// <returns>Lowest frequency coefficients, as many as all the lists of the level.</returns>
+    gsl::span<DataType> LowFrequency(unsigned level);
+    /// <summary>
+    /// Gets size of the storage of the lowest frequency coefficients, i.e.
+    /// the size of the largest level.
+    /// </summary>
+    /// <returns>Number of coefficients.</returns>
+    size_t LowFrequencyCapacity() const;
+    /// <summary>
+    /// Gets coefficients of all the levels, one after another.
+    /// </summary>
+    /// <returns>All the coefficients.</returns>
+    gsl::span<DataType> Data();
+    /// <summary>
+    /// Gets coefficients of all the levels, one after another.
+    /// </summary>
+    /// <returns>All the coefficients.</returns>
+    gsl::span<const DataType> Data() const;
+
+private:
+    size_t DataSize() const;
+
+    size_t m_SignalLength;
+    size_t m_ListLengths[WAVELET_LEVELS];
+    size_t m_Offsets[WAVELET_LEVELS + 1]; // + 1 for lowest frequency
+    size_t m_LowFrequencyCapacity;
+    Signal m_Data;
 };
-}
\ No newline at end of file
+}
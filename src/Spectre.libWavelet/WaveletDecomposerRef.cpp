@@ -21,31 +21,36 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 */
+#include <algorithm>
 #include "PrecomputedDaubechiesCoefficients.h"
 #include "WaveletDecomposerRef.h"
-#include "WaveletUtils.h"
 
 namespace spectre::algorithm::wavelet
 {
 // The function performs an 'intelligent' downsampling, where every second coefficient is
 // stored as a coefficient of 'new' sample, instead of just being discarded. This allows
 // the decomposition to retain more information about the signal.
-static inline void DownsampleByDissolving(CoefficientsPerLevel& coefficients, unsigned level, unsigned blockLength)
+// Lists filtered at the level are read from the buffer, while twice as many lists
+// of the next level are written to the low frequency coefficients.
+static inline void DownsampleByDissolving(const Signal& filtered, gsl::span<DataType> coefficients,
+    size_t numberOfLists, size_t blockLength, size_t newBlockLength)
 {
-    const unsigned shift = (1 << level) >> 1;
-    for (unsigned i = 0; i < shift; i++)
+    const size_t shift = numberOfLists;
+    for (size_t i = 0; i < shift; i++)
     {
-        coefficients[shift + i].resize(blockLength);
-        unsigned oldRowColumn = 0;
-        unsigned newRowColumn = 0;
-        for (unsigned j = 0; j < coefficients[i].size(); j++)
+        const DataType* list = filtered.data() + i * blockLength;
+        DataType* oldRow = coefficients.data() + i * newBlockLength;
+        DataType* newRow = coefficients.data() + (shift + i) * newBlockLength;
+        for (size_t j = 0; j < blockLength; j += 2)
         {
-            unsigned row = j % 2 ? shift + i : i;
-            unsigned column = j % 2 ? newRowColumn++ : oldRowColumn++;
-            coefficients[row][column] = coefficients[i][j];
+            oldRow[j / 2] = list[j];
         }
-        coefficients[i].resize(oldRowColumn); // Used to fill moved entries with zeros.
-        coefficients[i].resize(blockLength);
+        for (size_t j = 1; j < blockLength; j += 2)
+        {
+            newRow[j / 2] = list[j];
+        }
+        std::fill(oldRow + (blockLength + 1) / 2, oldRow + newBlockLength, 0.0);
+        std::fill(newRow + blockLength / 2, newRow + newBlockLength, 0.0);
     }
 }
 
@@ -54,53 +59,76 @@ static inline void DownsampleByDissolving(CoefficientsPerLevel& coefficients, un
 // https://upload.wikimedia.org/wikipedia/commons/1/16/Wavelets_-_SWT_Filter_Bank.png
 // The figure above depicts the process, where h_j prepresents a high- and g_j a low-pass
 // filters, applied at level j.
-// All the low frequency coefficients are overridden on each call, while the high
-// frequnecy ones are just added.
-inline void WaveletDecomposerRef::ApplyFilters(WaveletCoefficients& coefficients,
-    CoefficientsPerLevel& lowFrequencyCoefficients, size_t scale, size_t blockLength, unsigned level) const
+// High frequency coefficients are stored at the level, while the low frequency ones
+// are left in the buffer, as they are downsampled before the next level.
+inline void WaveletDecomposerRef::ApplyFilters(WaveletCoefficients& coefficients, Signal& buffer,
+    unsigned level, const CoefficientsCallback& onCoefficients) const
 {
-    coefficients.data[level].resize(scale); // Adjust number of coefficient lists for that certain level
-    for (unsigned i = 0; i < scale; i++)
+    const size_t numberOfLists = coefficients.NumberOfLists(level);
+    const size_t blockLength = coefficients.ListLength(level);
+    const auto length = static_cast<std::ptrdiff_t>(blockLength);
+    const DataType* lowFrequencyCoefficients = coefficients.LowFrequency(level).data();
+    buffer.resize(numberOfLists * blockLength);
+    for (size_t i = 0; i < numberOfLists; i++)
     {
-        lowFrequencyCoefficients[i].resize(blockLength); // Extend with zeros/shrink to match size
-        coefficients.data[level][i] = // Apply Daubechies4 decomposition high pass filter
-            m_Convolution.Convolve(precomputed::DecompositionHighPassFilter, lowFrequencyCoefficients[i]);
-        lowFrequencyCoefficients[i] = // Apply Daubechies4 decomposition low pass filter
-            m_Convolution.Convolve(precomputed::DecompositionLowPassFilter, lowFrequencyCoefficients[i]);
+        // Apply Daubechies4 decomposition filters at once
+        m_Filters.Split(gsl::span<const DataType>(lowFrequencyCoefficients + i * blockLength, length),
+            gsl::span<DataType>(buffer.data() + i * blockLength, length), coefficients.List(level, i));
+        if (onCoefficients)
+        {
+            onCoefficients(level, coefficients.List(level, i));
+        }
     }
 }
 
 WaveletDecomposerRef::WaveletDecomposerRef()
+    : m_Filters(precomputed::DecompositionLowPassFilter, precomputed::DecompositionHighPassFilter)
 {
 };
 
 WaveletCoefficients WaveletDecomposerRef::Decompose(Signal&& signal) const
 {
-    const size_t signalLength = signal.size();
-
     WaveletCoefficients coefficients;
-    CoefficientsPerLevel& lowFrequencyCoefficients = coefficients.data[WAVELET_LEVELS];
+    Signal buffer;
+    Decompose(gsl::as_span(signal), coefficients, buffer);
+    return coefficients;
+}
+
+void WaveletDecomposerRef::Decompose(gsl::span<const DataType> signal, WaveletCoefficients& coefficients,
+    Signal& buffer) const
+{
+    Decompose(signal, coefficients, buffer, CoefficientsCallback());
+}
 
-    // The number of samples N used to generate N coefficient lists
-    // for the lowest frequency decomposition.
-    constexpr size_t LOW_FREQ_SAMPLES_NUM = 1 << (WAVELET_LEVELS - 1); // 2^(WL - 1)
-    lowFrequencyCoefficients.resize(LOW_FREQ_SAMPLES_NUM);
-    lowFrequencyCoefficients[0] = std::move(signal); // Initialize first line with signal
+void WaveletDecomposerRef::Decompose(gsl::span<const DataType> signal, WaveletCoefficients& coefficients,
+    Signal& buffer, const CoefficientsCallback& onCoefficients) const
+{
+    const size_t signalLength = static_cast<size_t>(signal.size());
+    coefficients.Resize(signalLength);
 
-    size_t scale = 1; // Initial wavelet scale (or it's frequency)
-    size_t blockLength = ComputeBlockLength(0, scale, signalLength); // Initial number of coefficients
+    // Initialize the only list of the first level with signal, extended with zeros
+    DataType* firstList = coefficients.LowFrequency(0).data();
+    std::copy(signal.data(), signal.data() + signalLength, firstList);
+    std::fill(firstList + signalLength, firstList + coefficients.ListLength(0), 0.0);
 
     for (unsigned currentLevel = 0; currentLevel < WAVELET_LEVELS - 1; currentLevel++)
     {
-        ApplyFilters(coefficients, lowFrequencyCoefficients, scale, blockLength, currentLevel);
-
-        scale = ComputeScale(currentLevel);
-        blockLength = ComputeBlockLength(currentLevel + 1, scale, signalLength);
-        DownsampleByDissolving(lowFrequencyCoefficients, currentLevel + 1, (unsigned)blockLength);
+        ApplyFilters(coefficients, buffer, currentLevel, onCoefficients);
+        DownsampleByDissolving(buffer, coefficients.LowFrequency(currentLevel + 1),
+            coefficients.NumberOfLists(currentLevel), coefficients.ListLength(currentLevel),
+            coefficients.ListLength(currentLevel + 1));
     }
 
-    ApplyFilters(coefficients, lowFrequencyCoefficients, scale, blockLength, WAVELET_LEVELS - 1);
-
-    return coefficients;
+    ApplyFilters(coefficients, buffer, WAVELET_LEVELS - 1, onCoefficients);
+    const size_t blockLength = coefficients.ListLength(WAVELET_LEVELS);
+    for (size_t i = 0; i < coefficients.NumberOfLists(WAVELET_LEVELS); i++)
+    {
+        const gsl::span<DataType> list = coefficients.List(WAVELET_LEVELS, i);
+        std::copy(buffer.data() + i * blockLength, buffer.data() + (i + 1) * blockLength, list.data());
+        if (onCoefficients)
+        {
+            onCoefficients(WAVELET_LEVELS, list);
+        }
+    }
 }
 }
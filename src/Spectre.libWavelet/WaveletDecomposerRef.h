@@ -17,12 +17,19 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 #pragma once
-#include "Convolution.h"
+#include <functional>
 #include "DataTypes.h"
+#include "FilterBank.h"
 #include "WaveletCoefficients.h"
 
 namespace spectre::algorithm::wavelet
 {
+/// <summary>
+/// Function called with each list of coefficients as soon as it is final,
+/// along with its level. WAVELET_LEVELS stands for the lowest frequency.
+/// </summary>
+using CoefficientsCallback = std::function<void(unsigned level, gsl::span<DataType> coefficients)>;
+
 /// <summary>
 /// Decomposes the signal into set of Daubechies coefficients.
 /// </summary>
@@ -39,13 +46,33 @@ public:
     /// <param name="signal">Signal to decompose.</param>
     /// <returns>Set of Daubechies wavelet coefficients.</returns>
     WaveletCoefficients Decompose(Signal&& signal) const;
+    /// <summary>
+    /// Decomposes the signal into wavelet coefficients, reusing storage of
+    /// the coefficients from previous decompositions. No memory is allocated,
+    /// when the coefficients and the buffer have sufficient capacity.
+    /// </summary>
+    /// <param name="signal">Signal to decompose.</param>
+    /// <param name="coefficients">Set of Daubechies wavelet coefficients to fill.</param>
+    /// <param name="buffer">Buffer for filtered coefficients.</param>
+    void Decompose(gsl::span<const DataType> signal, WaveletCoefficients& coefficients, Signal& buffer) const;
+    /// <summary>
+    /// Decomposes the signal into wavelet coefficients, like the overload above,
+    /// passing each list to the callback right after it is computed, while it is
+    /// still in cache. Lists are passed in order of levels, so that the ones of
+    /// the first level come before any other. Callback may modify the list.
+    /// </summary>
+    /// <param name="signal">Signal to decompose.</param>
+    /// <param name="coefficients">Set of Daubechies wavelet coefficients to fill.</param>
+    /// <param name="buffer">Buffer for filtered coefficients.</param>
+    /// <param name="onCoefficients">Function called with each list of coefficients.</param>
+    void Decompose(gsl::span<const DataType> signal, WaveletCoefficients& coefficients, Signal& buffer,
+        const CoefficientsCallback& onCoefficients) const;
 
 private:
     inline void WaveletDecomposerRef::ApplyFilters(
-        WaveletCoefficients& coefficients,
-        CoefficientsPerLevel& lowFrequencyCoefficients,
-        size_t scale, size_t blockLength, unsigned level) const;
+        WaveletCoefficients& coefficients, Signal& buffer, unsigned level,
+        const CoefficientsCallback& onCoefficients) const;
 
-    const Convolution m_Convolution;
+    const DaubechiesFilterBank m_Filters;
 };
 }
@@ -23,105 +23,81 @@
  See the License for the specific language governing permissions and
  limitations under the License.
 */
+#include <algorithm>
+#include "Spectre.libException/InconsistentArgumentSizesException.h"
 #include "PrecomputedDaubechiesCoefficients.h"
 #include "WaveletReconstructorRef.h"
-#include "WaveletUtils.h"
 
 namespace spectre::algorithm::wavelet
 {
-// Average both signals, starting from startIndex and return.
-static inline Signal AverageSignals(Signal& signalOne, Signal& signalTwo, unsigned startIndex)
+// Merges the scales together, decreasing amount of coefficient lists. Lists filtered
+// at the level are read from the buffer, each without its first BASIS_LENGTH samples,
+// and their pairs are interleaved into lists of the lower level.
+static inline void DecreaseScale(const Signal& filtered, gsl::span<DataType> coefficients,
+    size_t numberOfLists, size_t blockLength, size_t newBlockLength)
 {
-    const size_t length = signalOne.size();
-    Signal result(length - startIndex);
-    for (unsigned i = startIndex; i < length; i++)
+    const size_t shift = numberOfLists / 2;
+    const size_t length = std::min(newBlockLength, 2 * (blockLength - BASIS_LENGTH));
+    for (size_t i = 0; i < shift; i++)
     {
-        result[i - startIndex] = (signalOne[i] + signalTwo[i]) * 0.5;
-    }
-    return result;
-}
-
-// Copy part of a signal, determined by interval [0;length).
-static inline void CopySelectively(Signal& source, Signal& destination, size_t length)
-{
-    memcpy(&destination[0], &source[0], length * sizeof(DataType));
-}
-
-// This can be approximated by current block length * 2.
-static inline size_t ComputeCoefficientsNumber(unsigned level, size_t signalLength)
-{
-    constexpr size_t MAX_SCALE = 1 << WAVELET_LEVELS;
-    const size_t numerator = (MAX_SCALE - 1) * BASIS_LENGTH + signalLength;
-    const size_t denominator = MAX_SCALE;
-    const size_t coeffsNumber =
-        CeiledDivisionUnsafe(numerator, denominator) * ComputeScale(WAVELET_LEVELS - level);
-
-    return coeffsNumber;
-}
-
-// Merges the scales together, decreasing amount of coefficient lists.
-static inline void DecreaseScale(CoefficientsPerLevel& coefficients, unsigned level, size_t coeffsNumber)
-{
-    const unsigned shift = (1 << level) >> 1;
-    for (unsigned i = 0; i < shift; i++)
-    {
-        const unsigned oldSize = (unsigned)coefficients[i].size();
-        coefficients[i].resize(coeffsNumber);
-        unsigned oldRowColumn = oldSize - 1;
-        unsigned newRowColumn = oldSize - 1;
-        const unsigned startingIndex = oldSize * 2 - 1;
-        for (int j = startingIndex; j >= 0; j--)
+        const DataType* oldRow = filtered.data() + i * blockLength + BASIS_LENGTH;
+        const DataType* newRow = filtered.data() + (shift + i) * blockLength + BASIS_LENGTH;
+        DataType* row = coefficients.data() + i * newBlockLength;
+        for (size_t j = 0; j < length; j++)
         {
-            unsigned row = j % 2 ? shift + i : i; // TODO check if this is converted to div and unroll if it is
-            unsigned column = j % 2 ? newRowColumn-- : oldRowColumn--;
-            coefficients[i][j] = coefficients[row][column];
+            row[j] = (j % 2 ? newRow : oldRow)[j / 2];
         }
+        std::fill(row + length, row + newBlockLength, 0.0);
     }
-    coefficients.resize(shift);
 }
 
-// Apply reconstruction filters at all scales of certain level.
-inline void WaveletReconstructorRef::ApplyFilters(WaveletCoefficients& coefficients,
-    size_t scale, size_t blockLength, unsigned level) const
+// Apply reconstruction filters at all scales of certain level. Filtered signals
+// are averaged by the filter bank, as its coefficients are halved.
+inline void WaveletReconstructorRef::ApplyFilters(WaveletCoefficients& coefficients, Signal& buffer,
+    unsigned level) const
 {
-    using namespace precomputed;
-    constexpr unsigned LOW_FREQ_INDEX = WAVELET_LEVELS;
-    auto& coeffs = coefficients.data;
-    for (unsigned i = 0; i < scale; i++)
+    const size_t numberOfLists = coefficients.NumberOfLists(level);
+    const size_t blockLength = coefficients.ListLength(level);
+    const auto length = static_cast<std::ptrdiff_t>(blockLength);
+    const DataType* lowFrequencyCoefficients = coefficients.LowFrequency(level).data();
+    buffer.resize(numberOfLists * blockLength);
+    for (size_t i = 0; i < numberOfLists; i++)
     {
-        Signal lowFreqCoefficients =
-            m_Convolution.Convolve(ReconstructionLowPassFilter, coeffs[LOW_FREQ_INDEX][i], blockLength);
-        Signal highFreqCoefficients =
-            m_Convolution.Convolve(ReconstructionHighPassFilter, coeffs[level][i]);
-        Signal averagedCoefficients =
-            AverageSignals(lowFreqCoefficients, highFreqCoefficients, BASIS_LENGTH);
-        CopySelectively(averagedCoefficients, coeffs[LOW_FREQ_INDEX][i], blockLength - BASIS_LENGTH);
+        m_Filters.Merge(gsl::span<const DataType>(lowFrequencyCoefficients + i * blockLength, length),
+            coefficients.List(level, i), gsl::span<DataType>(buffer.data() + i * blockLength, length));
     }
 }
 
 WaveletReconstructorRef::WaveletReconstructorRef()
+    : m_Filters(precomputed::ReconstructionLowPassFilter, precomputed::ReconstructionHighPassFilter, 0.5)
 {
 }
 
 Signal WaveletReconstructorRef::Reconstruct(WaveletCoefficients&& coefficients, size_t signalLength) const
 {
-    constexpr unsigned LOW_FREQ_INDEX = WAVELET_LEVELS;
-    auto& coeffs = coefficients.data;
-    size_t scale = ComputeScale(WAVELET_LEVELS - 2);
-    size_t blockLength = ComputeBlockLength(WAVELET_LEVELS - 1, scale, signalLength);
-    size_t coeffsNum = 0;
+    Signal signal(signalLength);
+    Signal buffer;
+    Reconstruct(coefficients, gsl::as_span(signal), buffer);
+    return signal;
+}
 
-    for (unsigned level = WAVELET_LEVELS - 1; level > 0; level--)
+void WaveletReconstructorRef::Reconstruct(WaveletCoefficients& coefficients, gsl::span<DataType> signal,
+    Signal& buffer) const
+{
+    const size_t signalLength = static_cast<size_t>(signal.size());
+    if (signalLength != coefficients.SignalLength())
     {
-        ApplyFilters(coefficients, scale, blockLength, level);
-        scale = ComputeScale(level - 2);
-        blockLength = ComputeBlockLength(level - 1, scale, signalLength);
-        coeffsNum = ComputeCoefficientsNumber(level, signalLength);
-        DecreaseScale(coeffs[LOW_FREQ_INDEX], level, coeffsNum);
+        throw spectre::core::exception::InconsistentArgumentSizesException(
+            "signal", signalLength, "coefficients", coefficients.SignalLength());
     }
-    ApplyFilters(coefficients, scale, blockLength, 0);
-    coeffs[LOW_FREQ_INDEX][0].resize(signalLength);
 
-    return coeffs[LOW_FREQ_INDEX][0];
+    for (unsigned level = WAVELET_LEVELS - 1; level > 0; level--)
+    {
+        ApplyFilters(coefficients, buffer, level);
+        DecreaseScale(buffer, coefficients.LowFrequency(level - 1), coefficients.NumberOfLists(level),
+            coefficients.ListLength(level), coefficients.ListLength(level - 1));
+    }
+    ApplyFilters(coefficients, buffer, 0);
+    std::copy(buffer.data() + BASIS_LENGTH, buffer.data() + BASIS_LENGTH + signalLength, signal.data());
+}
 }
-}
\ No newline at end of file
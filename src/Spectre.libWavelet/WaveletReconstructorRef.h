@@ -17,8 +17,8 @@
  limitations under the License.
 */
 #pragma once
-#include "Convolution.h"
 #include "DataTypes.h"
+#include "FilterBank.h"
 #include "WaveletCoefficients.h"
 
 namespace spectre::algorithm::wavelet
@@ -39,13 +39,25 @@ public:
     /// <param name="coefficients">Coefficents used to reconstruct the signal.</param>
     /// <param name="signalLength">Length of signal to be reconstructed.</param>
     /// <returns>Reconstructed signal.</returns>
+    /// <exception cref="InconsistentArgumentSizesException">Thrown when the coefficients
+    /// describe a signal of other length.</exception>
     Signal Reconstruct(WaveletCoefficients&& coefficients, size_t signalLength) const;
+    /// <summary>
+    /// Reconstructs the signal based on daubechies coefficients, which are
+    /// overwritten in the process. No memory is allocated, when the buffer
+    /// has sufficient capacity.
+    /// </summary>
+    /// <param name="coefficients">Coefficents used to reconstruct the signal.</param>
+    /// <param name="signal">Output for reconstructed signal.</param>
+    /// <param name="buffer">Buffer for merged coefficients.</param>
+    /// <exception cref="InconsistentArgumentSizesException">Thrown when the coefficients
+    /// describe a signal of other length.</exception>
+    void Reconstruct(WaveletCoefficients& coefficients, gsl::span<DataType> signal, Signal& buffer) const;
 
 private:
     inline void WaveletReconstructorRef::ApplyFilters(
-        WaveletCoefficients& coefficients, size_t scale,
-        size_t blockLength, unsigned level) const;
+        WaveletCoefficients& coefficients, Signal& buffer, unsigned level) const;
 
-    const Convolution m_Convolution;
+    const DaubechiesFilterBank m_Filters;
 };
 }